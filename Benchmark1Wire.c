@@ -0,0 +1,291 @@
+/**
+******************************************************
+* @file Benchmark1Wire.c
+* @brief Medidas de rendimiento de la libreria 1Wire en PC
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Se compila con el simulador del bus:
+*
+*	gcc -O2 -o benchmark Benchmark1Wire.c
+*	gcc -O2 -DONEWIRE_CRC_NIBBLE -o benchmark_nibble Benchmark1Wire.c
+*	gcc -O2 -DONEWIRE_UART -o benchmark_uart Benchmark1Wire.c
+*
+* Cada resultado se imprime en una linea nombre,valor para poder comparar facilmente versiones. El valor es siempre
+* un numero, la unidad va al final del nombre ( _ns, _us )
+*
+* Las medidas del bus se hacen con 1 a 1000 dispositivos DS18B20 virtuales con dos distribuciones de Id's:
+* aleatoria y con prefijo comun largo ( los Id's solo se diferencian en los bits altos del numero de serie,
+* que la busqueda recorre al final ). Para cada operacion se da el tiempo de bus virtual, los slots,
+* los resets y el tiempo de CPU del PC
+*
+*******************************************************/
+#ifndef ONEWIRE_SIM
+#define ONEWIRE_SIM
+#endif
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE															//Antes de cualquier #include, lo necesita el puerto serie virtual
+#endif
+#include <time.h>
+#include "JSB_1wire.h"
+
+#define BENCH_CRC_BYTES		8000000L									///< Bytes procesados en cada medida de CRC
+#define BENCH_MUESTRAS		100											///< Dispositivos leidos como maximo en la medida de Match ROM
+
+/**
+* @brief Estado del bus virtual y del reloj del PC al empezar una medida
+*/
+typedef struct
+{
+	int64 nTiempo;															///< Reloj virtual en us
+	int32 nSlots;
+	int32 nResets;
+	clock_t nCPU;
+} Bench_Marca;
+
+/**
+******************************************************
+* @brief CRC 1 Wire bit a bit, tal como se calculaba en la version 1.0
+*
+* Se mantiene como referencia para comparar con el calculo por tabla
+*/
+int8 _Bench_CRCBits ( int8 crc, int8 nData )
+{
+	int8 nBit;
+
+	crc ^= nData;
+	for ( nBit = 0; nBit < 8; nBit++ )
+	{
+		if (crc & 0x01)
+		{
+			crc = (crc >> 1) ^ 0x8C;
+		}else{
+			crc >>= 1;
+		}
+	}
+	return crc;
+}
+/**
+******************************************************
+* @brief Tiempo de CPU en ns transcurrido desde nInicio
+*/
+double _Bench_Ns (clock_t nInicio, long nOperaciones)
+{
+	return (double)(clock() - nInicio) * 1e9 / CLOCKS_PER_SEC / nOperaciones;
+}
+/**
+******************************************************
+* @brief Compara el CRC bit a bit con el CRC por tabla, byte a byte y por bloques de 8 y 9 bytes
+*
+* Los CRC calculados se acumulan en nResultado y se imprimen al final, asi el compilador no puede quitar los calculos
+*/
+void Bench_CRC (void)
+{
+	static int8 aDatos[4096];
+	int8 nResultado;
+	int8 nCRC, nCRCRef;
+	long nByte;
+	clock_t nInicio;
+
+	for (nByte = 0; nByte < (long) sizeof (aDatos); nByte++)
+	{
+		aDatos[nByte] = (int8) rand ();
+	}
+	nCRC = nCRCRef = 0;
+	for (nByte = 0; nByte < 255; nByte++)									//Antes de medir comprobamos que los calculos coinciden
+	{
+		nCRC = OneWire_CRC (nCRC, aDatos[nByte]);
+		nCRCRef = _Bench_CRCBits (nCRCRef, aDatos[nByte]);
+	}
+	if (nCRC != nCRCRef || nCRC != OneWire_CRCBloque (0, aDatos, 255))
+	{
+		printf ("ERROR: el CRC por tabla no coincide con el CRC bit a bit\n");
+		exit (1);
+	}
+#ifdef ONEWIRE_CRC_NIBBLE
+	printf ("crc.tabla_bytes,16\n");
+#else
+	printf ("crc.tabla_bytes,256\n");
+#endif
+
+	nResultado = 0;
+	nCRC = 0;
+	nInicio = clock ();
+	for (nByte = 0; nByte < BENCH_CRC_BYTES; nByte++)
+	{
+		nCRC = _Bench_CRCBits (nCRC, aDatos[nByte & 4095]);
+	}
+	nResultado ^= nCRC;
+	printf ("crc.bits.byte_ns,%.2f\n", _Bench_Ns (nInicio, BENCH_CRC_BYTES));
+
+	nCRC = 0;
+	nInicio = clock ();
+	for (nByte = 0; nByte < BENCH_CRC_BYTES; nByte++)
+	{
+		nCRC = OneWire_CRC (nCRC, aDatos[nByte & 4095]);
+	}
+	nResultado ^= nCRC;
+	printf ("crc.tabla.byte_ns,%.2f\n", _Bench_Ns (nInicio, BENCH_CRC_BYTES));
+
+	nInicio = clock ();
+	for (nByte = 0; nByte < BENCH_CRC_BYTES; nByte += 8)
+	{
+		nResultado ^= OneWire_CRCBloque (0, &aDatos[nByte & 4088], 8);		//Un Id
+	}
+	printf ("crc.tabla.rom_ns,%.2f\n", _Bench_Ns (nInicio, BENCH_CRC_BYTES));
+
+	nInicio = clock ();
+	for (nByte = 0; nByte < BENCH_CRC_BYTES; nByte += 9)
+	{
+		nResultado ^= OneWire_CRCBloque (0, &aDatos[nByte & 4080], 9);		//Un scratchpad
+	}
+	printf ("crc.tabla.scratchpad_ns,%.2f\n", _Bench_Ns (nInicio, BENCH_CRC_BYTES));
+	printf ("crc.resultado,%u\n", nResultado);							//Igual en todas las versiones con la misma semilla
+}
+
+/**
+******************************************************
+* @brief Toma la marca de inicio de una medida del bus
+*/
+void _Bench_Inicio (Bench_Marca* pMarca)
+{
+	pMarca->nTiempo = OneWireSim.nTiempo;
+	pMarca->nSlots = OneWireSim.nSlots;
+	pMarca->nResets = OneWireSim.nResets;
+	pMarca->nCPU = clock ();
+}
+/**
+******************************************************
+* @brief Imprime el tiempo de bus, slots, resets y tiempo de CPU desde la marca, divididos entre nOperaciones
+*/
+void _Bench_Resultado (char* sNombre, Bench_Marca* pMarca, long nOperaciones)
+{
+	double nCPU;
+
+	nCPU = (double)(clock() - pMarca->nCPU) * 1e6 / CLOCKS_PER_SEC / nOperaciones;
+	printf ("%s.bus_us,%.1f\n", sNombre, (double)(OneWireSim.nTiempo - pMarca->nTiempo) / nOperaciones);
+	printf ("%s.slots,%.1f\n", sNombre, (double)(OneWireSim.nSlots - pMarca->nSlots) / nOperaciones);
+	printf ("%s.resets,%.2f\n", sNombre, (double)(OneWireSim.nResets - pMarca->nResets) / nOperaciones);
+	printf ("%s.cpu_us,%.1f\n", sNombre, nCPU);
+}
+/**
+******************************************************
+* @brief Crea un bus virtual con nDispositivos DS18B20
+*
+* @param lPrefijo 0 para Id's aleatorios, 1 para Id's con los 38 bits bajos del numero de serie iguales
+*/
+void _Bench_Poblacion (int16 nDispositivos, int1 lPrefijo)
+{
+	int8 aRom[8];
+	int16 nDispositivo;
+	int64 nSerie, nBase;
+
+	OneWireSim_Termina ();
+	OneWireSim_Inicia ();
+	nBase = (((int64) rand () << 24) ^ rand ()) & 0x3FFFFFFFFFLL;
+	for (nDispositivo = 0; nDispositivo < nDispositivos; nDispositivo++)
+	{
+		if (lPrefijo)
+		{
+			nSerie = nBase | ((int64) nDispositivo << 38);
+		}else{
+			nSerie = (((int64) rand () << 24) ^ rand ()) & 0xFFFFFFFFFFFFLL;
+		}
+		OneWireSim_RomConCRC (0x28, nSerie, aRom);
+		OneWireSim_AnadeDS18B20 (aRom, (int16)(nDispositivo * 8));
+	}
+}
+/**
+******************************************************
+* @brief Mide busqueda, cuenta y Match ROM con lectura del scratchpad en un bus de nDispositivos
+*
+* El Match ROM con lectura se mide sobre BENCH_MUESTRAS dispositivos como maximo y se da por dispositivo.
+* OneWire_CuentaDispositivos() y OneWire_SearchROM() cuentan con un int8, solo se miden hasta 255 dispositivos.
+* La busqueda completa con OneWire_SearchFirst() y OneWire_SearchNext() se mide siempre
+*/
+void Bench_Bus (int16 nDispositivos, int1 lPrefijo)
+{
+	OneWire_Busqueda stBusqueda;
+	Bench_Marca stMarca;
+	char sNombre[64], sPrefijo[32];
+	int8 aRom[8], aScratchpad[9];
+	int8* aRoms;
+	int16 nEncontrados, nDispositivo, nPaso, nMuestras, nCRC;
+	int1 lEncontrado;
+
+	_Bench_Poblacion (nDispositivos, lPrefijo);
+	sprintf (sPrefijo, "bus.%s.%u", lPrefijo ? "prefijo" : "aleatorio", nDispositivos);
+
+	nEncontrados = 0;
+	_Bench_Inicio (&stMarca);
+	for (lEncontrado = OneWire_SearchFirst (&stBusqueda, aRom); lEncontrado; lEncontrado = OneWire_SearchNext (&stBusqueda, aRom))
+	{
+		nEncontrados++;
+	}
+	sprintf (sNombre, "%s.busqueda", sPrefijo);
+	_Bench_Resultado (sNombre, &stMarca, 1);
+	if (nEncontrados != nDispositivos)
+	{
+		printf ("ERROR: %s ha encontrado %u dispositivos\n", sNombre, nEncontrados);
+		exit (1);
+	}
+
+	if (nDispositivos < 256)
+	{
+		_Bench_Inicio (&stMarca);
+		nEncontrados = OneWire_CuentaDispositivos ();
+		sprintf (sNombre, "%s.cuenta", sPrefijo);
+		_Bench_Resultado (sNombre, &stMarca, 1);
+		if (nEncontrados != nDispositivos)
+		{
+			printf ("ERROR: %s ha contado %u dispositivos\n", sNombre, nEncontrados);
+			exit (1);
+		}
+		_Bench_Inicio (&stMarca);
+		aRoms = OneWire_SearchROM ();
+		sprintf (sNombre, "%s.searchrom", sPrefijo);
+		_Bench_Resultado (sNombre, &stMarca, 1);
+		free (aRoms);
+	}
+
+	nPaso = (nDispositivos + BENCH_MUESTRAS - 1) / BENCH_MUESTRAS;		//Muestras repartidas por todo el bus
+	nMuestras = 0;
+	_Bench_Inicio (&stMarca);
+	for (nDispositivo = 0; nDispositivo < nDispositivos; nDispositivo += nPaso)
+	{
+		nMuestras++;
+		nCRC = 0;
+		OneWire_MatchROM (OneWireSim.aEsclavos[nDispositivo].aRom);
+		OneWire_SendByte (0xBE);
+		if (!OneWire_ReadBlock (aScratchpad, 9, ONEWIRE_CRC_8, &nCRC))
+		{
+			printf ("ERROR: %s scratchpad %u con CRC erroneo\n", sPrefijo, nDispositivo);
+			exit (1);
+		}
+	}
+	sprintf (sNombre, "%s.match_lectura", sPrefijo);
+	_Bench_Resultado (sNombre, &stMarca, nMuestras);
+}
+
+int main (void)
+{
+	static const int16 aPoblaciones[] = {1, 10, 100, 1000};
+	int8 nPoblacion;
+
+	srand (1);
+#ifdef ONEWIRE_UART
+	OneWire_UartInicia ();
+#endif
+	Bench_CRC ();
+	for (nPoblacion = 0; nPoblacion < sizeof (aPoblaciones) / sizeof (aPoblaciones[0]); nPoblacion++)
+	{
+		Bench_Bus (aPoblaciones[nPoblacion], 0);
+		Bench_Bus (aPoblaciones[nPoblacion], 1);
+	}
+	OneWireSim_Termina ();
+#ifdef ONEWIRE_UART
+	OneWireSim_UartCierra ();
+#endif
+	return 0;
+}
@@ -91,6 +91,9 @@
  * Mediante este comando el maestro direcciona un esclavo. Cuando el maestro envia el Id, el esclavo que coincida con la identificación
  * espera una orden del maestro, el resto se queda de ser identificados
  *
+ * Los dispositivos que lo admiten ( DS2431, DS28EC20,... ) se pueden volver a direccionar con Resume ( 0xA5 ) sin enviar el Id,
+ * siempre que no haya habido otro comando ROM. OneWire_MatchROM() lo hace automaticamente
+ *
  * \subsection Comandos_3 2.3.3.- Skip ROM
  *
  * Este comando sirve para direccionar de forma directa un esclavo sin necesidad de enviar el Id. Evidentemente solo se puede
@@ -101,6 +104,92 @@
  * Con este comando, el maestro pide a todos los esclavos que se identifiquen. Mediante un proceso complejo, el maestro obtiene
  * los Id's de todos los esclavos conectados al bus
  *
+ * \section Seccion_Simulador Ejecucion en PC
+ *
+ * Las funciones basicas no acceden directamente a Pin1W sino a traves de las macros _OneWire_PinLow(), _OneWire_PinFloat(), 
+ * _OneWire_PinRead() y _OneWire_DelayUs(). Compilando con ONEWIRE_SIM, esas macros se dirigen a un bus virtual ( JSB_1wire_Sim.h )
+ * que simula cualquier numero de esclavos con un reloj en microsegundos, lo que permite probar y medir la libreria con gcc
+ * antes de grabarla en el PIC
+ *
+ *	gcc -DONEWIRE_SIM -o prueba prueba.c
+ *
+ * Pruebas1Wire.c es el programa de pruebas de regresion. Se compila sin opciones y con ONEWIRE_ASYNC, ONEWIRE_UART y
+ * ONEWIRE_DS2482, y devuelve el numero de comprobaciones fallidas
+ *
+ * \section Seccion_Async Motor no bloqueante
+ *
+ * Definiendo ONEWIRE_ASYNC, las esperas de cada operacion se hacen con la interrupcion del Timer1 ( JSB_1wire_Async.h ). Las
+ * funciones OneWire_AsyncXxx() lanzan un reset, un bit, un byte o un bloque y retornan inmediatamente, el final se detecta
+ * con OneWire_AsyncOcupado() o con la funcion ONEWIRE_ASYNC_CALLBACK. Las funciones basicas de siempre siguen disponibles
+ * y esperan a que termine la operacion
+ *
+ * \section Seccion_Inventario Inventario de dispositivos
+ *
+ * JSB_1wire_Inventario.h mantiene la tabla de dispositivos conocidos. OneWire_InventarioActualiza() confirma cada uno con una
+ * pasada de busqueda dirigida y solo recorre el arbol completo cuando algo ha cambiado, marcando las altas y las bajas.
+ * Con el bus estable cuesta lo mismo que una enumeracion ( un reset y 64 bits por dispositivo ), lo que se ahorra es la
+ * segunda enumeracion de OneWire_CuentaDispositivos() mas OneWire_SearchROM() y comparar las listas
+ *
+ * \section Seccion_Temperatura Sensores de temperatura
+ *
+ * OneWire_TempMuestrea() ( JSB_1wire_Temperatura.h ) hace convertir a la vez a todos los sensores con Skip ROM, detecta el final
+ * de la conversion con slots de lectura y lee el scratchpad de cada sensor del inventario comprobando su CRC
+ *
+ * \section Seccion_Paralelo Buses en paralelo
+ *
+ * JSB_1wire_Paralelo.h maneja hasta 8 buses conectados a los pines de un mismo puerto. Cada slot es una escritura del TRIS y una
+ * lectura del puerto para todos los buses, por lo que el reset, los bytes y la busqueda avanzan a la vez en todos ellos
+ *
+ * \section Seccion_Uart Bus por UART
+ *
+ * Definiendo ONEWIRE_UART las funciones basicas generan los slots con la UART ( JSB_1wire_Uart.h ): un byte a 115200 baudios por
+ * slot y un byte a 9600 baudios por reset. En el PC la UART es un pseudo-terminal cuyo otro extremo hace de transceptor con el bus virtual
+ *
+ * \section Seccion_DS2482 Puente I2C DS2482
+ *
+ * Definiendo ONEWIRE_DS2482 el bus lo maneja un DS2482 por I2C ( JSB_1wire_DS2482.h ). Reset, bits, bytes y el triplete de la busqueda
+ * son comandos nativos del puente; la espera lee solo el registro de estado y los bloques encadenan los comandos con start repetido.
+ * Hay que llamar a OneWire_DS2482Inicia() antes de usar el bus. En el PC el DS2482 se simula a nivel de registros sobre el bus virtual
+ *
+ * \section Seccion_Estadisticas Estadisticas del bus
+ *
+ * Definiendo ONEWIRE_ESTADISTICAS se cuentan resets, resets sin presencia, bytes, busquedas, pasadas y CRC erroneos, y se acumula el
+ * tiempo de resets, bytes y busquedas en OneWire_Est. OneWire_EstadisticasCaptura() copia los contadores y OneWire_EstadisticasBorra()
+ * los pone a 0. Sin la definicion las macros _OneWire_Est no generan codigo
+ *
+ * \section Seccion_Calibracion Calibracion del bus
+ *
+ * OneWire_Calibra() ( JSB_1wire_Calibracion.h ) mide la subida del bus y el pulso de presencia y ajusta los tiempos de velocidad
+ * estandar a los minimos de la especificacion mas un margen. Los tiempos quedan en OneWire_PerfilEstandar, que es el que carga
+ * OneWire_Velocidad (0); OneWire_CalibraBorra() vuelve a los tiempos ONEWIRE_STD_xxx. En el simulador la subida del bus se fija
+ * con OneWireSim.nSubida
+ *
+ * \section Seccion_Memoria Memorias EEPROM
+ *
+ * JSB_1wire_Memoria.h lee y escribe memorias DS2431. OneWire_MemoriaLee() lee cualquier rango con un solo Read Memory y
+ * OneWire_MemoriaEscribe() acumula los cambios en una cache de filas que OneWire_MemoriaGuarda() escribe por el scratchpad con
+ * comprobacion de CRC16. En el simulador el DS2431 se anade con OneWireSim_AnadeDS2431()
+ *
+ * \section Seccion_Lista Lista ordenada de dispositivos
+ *
+ * JSB_1wire_Lista.h define OneWire_Rom, un Id con CRC comprobado, y OneWire_Lista, una tabla estatica ordenada en el orden
+ * de la busqueda. OneWire_ListaLlena() la llena con una sola busqueda, OneWire_ListaBusca() localiza un Id por busqueda binaria
+ * y OneWire_ListaFamilia() devuelve el rango de Id's de una familia
+ *
+ * \section Seccion_Interrupciones Interrupciones
+ *
+ * Definiendo ONEWIRE_INTERRUPCIONES los slots bloquean las interrupciones solo desde el flanco de bajada hasta el muestreo o
+ * hasta liberar el 1, 17 us como maximo en velocidad estandar. Las ventanas mas largas ( pulso bajo de un 0, espera de la
+ * presencia ) solo se bloquean si caben en ONEWIRE_BLOQUEO_MAX. No hace falta deshabilitar las interrupciones alrededor de una
+ * busqueda. En el simulador OneWireSimInt mide el bloqueo mas largo y alarga las esperas con una rutina de interrupcion virtual
+ *
+ * \section Seccion_Cola Cola de transacciones
+ *
+ * JSB_1wire_Cola.h permite que varios modulos compartan el bus sin repetir resets ni conversiones. Cada modulo anade peticiones
+ * ( OneWire_ColaConvierte(), OneWire_ColaLeeScratchpad(), OneWire_ColaEscribeScratchpad(), OneWire_ColaLeeMemoria() ) y recoge el
+ * resultado con OneWire_ColaResultado(). OneWire_ColaProcesa() agrupa las peticiones de cada ciclo: una sola conversion con Skip ROM,
+ * una lectura por scratchpad y un Read Memory por cada grupo de rangos cercanos, con los Id's en el orden de la busqueda
+ *
  *
  */
 
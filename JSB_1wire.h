@@ -11,7 +11,296 @@
 #ifndef _JSB1WIRE
 #define _JSB1WIRE
 
-#include <stdlibm.h>     
+/** @defgroup group0 Capa de acceso al bus
+ *  @brief Macros sobre las que se construyen las funciones basicas
+ *
+ *  Por defecto actuan sobre el pin Pin1W con las funciones internas de CCS. Definiendo ONEWIRE_SIM
+ *  se sustituyen por el bus virtual de JSB_1wire_Sim.h para ejecutar la libreria en un PC. Cualquier
+ *  otro hardware se puede conectar definiendo estas macros antes de incluir JSB_1wire.h
+ *
+ *  Con ONEWIRE_DIRECTO cada cambio del pin es una instruccion sobre el bit del TRIS y la lectura un test
+ *  del bit del puerto, sin el codigo que genera output_low() / output_float() con standard_io. El puerto y
+ *  el bit se fijan con ONEWIRE_DIRECTO_PORT, ONEWIRE_DIRECTO_LAT, ONEWIRE_DIRECTO_TRIS y ONEWIRE_DIRECTO_BIT
+ *  ( por defecto RB0 ). Junto con ONEWIRE_TIEMPOS_FIJOS el punto de muestreo no depende de la frecuencia del PIC
+ *
+ *  Con ONEWIRE_INTERRUPCIONES los slots enmascaran las interrupciones solo en su parte critica con
+ *  _OneWire_Bloquea() / _OneWire_Desbloquea(), que guardan y restauran el bit GIE ( ver _OneWire_SlotLee() )
+ *  @{
+ */
+
+#ifdef ONEWIRE_SIM
+	#include "JSB_1wire_Host.h"
+	#include "JSB_1wire_Sim.h"
+	#ifndef _OneWire_PinLow
+		#define _OneWire_PinLow()		OneWireSim_PinLow ()
+		#define _OneWire_PinHigh()		OneWireSim_PinHigh ()
+		#define _OneWire_PinFloat()		OneWireSim_PinFloat ()
+		#define _OneWire_PinRead()		OneWireSim_PinRead ()
+		#define _OneWire_DelayUs(n)		OneWireSim_DelayUs (n)
+		#define _OneWire_DelayMs(n)		OneWireSim_DelayUs ((int32)(n)*1000)
+	#endif
+#else
+	#include <stdlibm.h>
+	#ifdef ONEWIRE_DIRECTO
+		#ifndef ONEWIRE_DIRECTO_PORT
+			#define ONEWIRE_DIRECTO_PORT	getenv ("SFR:PORTB")		///< Registro que se lee para muestrear el bus
+			#define ONEWIRE_DIRECTO_LAT		getenv ("SFR:PORTB")		///< Registro de salida ( LATx en los PIC18 )
+			#define ONEWIRE_DIRECTO_TRIS	getenv ("SFR:TRISB")
+			#define ONEWIRE_DIRECTO_BIT		0
+		#endif
+		#byte OneWire_RegPuerto = ONEWIRE_DIRECTO_PORT
+		#byte OneWire_RegLatch = ONEWIRE_DIRECTO_LAT
+		#byte OneWire_RegTris = ONEWIRE_DIRECTO_TRIS
+		#bit OneWire_BitPuerto = OneWire_RegPuerto.ONEWIRE_DIRECTO_BIT
+		#bit OneWire_BitLatch = OneWire_RegLatch.ONEWIRE_DIRECTO_BIT
+		#bit OneWire_BitTris = OneWire_RegTris.ONEWIRE_DIRECTO_BIT
+		#define _OneWire_PinLow()		OneWire_BitLatch = 0, OneWire_BitTris = 0	///< bcf + bcf, el latch se repite por si otra escritura del puerto lo ha cambiado
+		#define _OneWire_PinHigh()		OneWire_BitTris = 1					///< El 1 lo da la resistencia de pull-up
+		#define _OneWire_PinFloat()		OneWire_BitTris = 1
+		#define _OneWire_PinRead()		OneWire_BitPuerto
+		#define _OneWire_DelayUs(n)		delay_us (n)
+		#define _OneWire_DelayMs(n)		delay_ms (n)
+	#endif
+	#ifndef _OneWire_PinLow
+		#define _OneWire_PinLow()		output_low (Pin1W)
+		#define _OneWire_PinHigh()		output_high (Pin1W)
+		#define _OneWire_PinFloat()		output_float (Pin1W)
+		#define _OneWire_PinRead()		input (Pin1W)
+		#define _OneWire_DelayUs(n)		delay_us (n)
+		#define _OneWire_DelayMs(n)		delay_ms (n)
+	#endif
+#endif
+
+#ifdef ONEWIRE_INTERRUPCIONES
+	#ifndef _OneWire_Bloquea
+		#ifdef ONEWIRE_SIM
+			#define _OneWire_Bloquea()		OneWireSim_Bloquea ()
+			#define _OneWire_Desbloquea()	OneWireSim_Desbloquea ()
+		#else
+			#bit OneWire_BitGIE = getenv ("BIT:GIE")
+			int1 OneWire_GIE;											///< Estado de GIE antes del ultimo bloqueo
+			#define _OneWire_Bloquea()		OneWire_GIE = OneWire_BitGIE, OneWire_BitGIE = 0
+			#define _OneWire_Desbloquea()	OneWire_BitGIE = OneWire_GIE	///< Se puede repetir, solo restaura el estado guardado
+		#endif
+	#endif
+#else
+	#define _OneWire_Bloquea()
+	#define _OneWire_Desbloquea()
+#endif
+
+/** @} */ // end of group0
+
+/** @defgroup group8 Perfiles de velocidad
+ *  @brief Tiempos de cada fase del reset y de los slots para velocidad estandar y overdrive ( us )
+ *
+ *  Las funciones basicas toman los tiempos de OneWire_Perfil, que se cambia con OneWire_Velocidad().
+ *  Los valores por defecto se pueden sustituir definiendo las macros antes de incluir JSB_1wire.h.
+ *  En overdrive los tiempos son de 1 us, el PIC debe funcionar a una frecuencia suficiente para que
+ *  delay_us() con variable los respete
+ *  @{
+ */
+
+#ifndef ONEWIRE_STD_RESET_BAJO
+#define ONEWIRE_STD_RESET_BAJO			480								///< Pulso de reset
+#define ONEWIRE_STD_RESET_MUESTREO		60								///< Desde el fin del reset hasta la lectura de la presencia
+#define ONEWIRE_STD_RESET_FIN			240								///< Desde la lectura de la presencia hasta el fin del reset
+#define ONEWIRE_STD_ESCRITURA_BAJO		10								///< Pulso bajo de inicio de un slot de escritura
+#define ONEWIRE_STD_ESCRITURA_BIT		70								///< Resto del slot de escritura con el bit en el bus
+#define ONEWIRE_STD_ESCRITURA_RECUPERA	2								///< Recuperacion tras un slot de escritura
+#define ONEWIRE_STD_LECTURA_BAJO		2								///< Pulso bajo de inicio de un slot de lectura
+#define ONEWIRE_STD_LECTURA_MUESTREO	15								///< Desde el fin del pulso bajo hasta la lectura del bit
+#define ONEWIRE_STD_LECTURA_RECUPERA	50								///< Desde la lectura hasta el fin del slot
+#endif
+
+#ifndef ONEWIRE_STD_BLOQUE_ESCRITURA_BIT
+#define ONEWIRE_STD_BLOQUE_ESCRITURA_BIT	50							///< En bloques, resto del slot de escritura ( pulso bajo total de 60 us )
+#define ONEWIRE_STD_BLOQUE_LECTURA_RECUPERA	44							///< En bloques, desde la lectura hasta el fin del slot ( slot de 61 us )
+#define ONEWIRE_STD_BLOQUE_RECUPERA		1								///< En bloques, recuperacion minima entre slots
+#endif
+
+#ifndef ONEWIRE_OD_RESET_BAJO
+#define ONEWIRE_OD_RESET_BAJO			70
+#define ONEWIRE_OD_RESET_MUESTREO		8
+#define ONEWIRE_OD_RESET_FIN			40
+#define ONEWIRE_OD_ESCRITURA_BAJO		1
+#define ONEWIRE_OD_ESCRITURA_BIT		7
+#define ONEWIRE_OD_ESCRITURA_RECUPERA	3
+#define ONEWIRE_OD_LECTURA_BAJO			1
+#define ONEWIRE_OD_LECTURA_MUESTREO		1
+#define ONEWIRE_OD_LECTURA_RECUPERA		7
+#endif
+
+#ifndef ONEWIRE_OD_BLOQUE_ESCRITURA_BIT
+#define ONEWIRE_OD_BLOQUE_ESCRITURA_BIT		5
+#define ONEWIRE_OD_BLOQUE_LECTURA_RECUPERA	5
+#define ONEWIRE_OD_BLOQUE_RECUPERA		1
+#endif
+
+/**
+* @brief Tiempos activos del bus ( us )
+*/
+typedef struct
+{
+	int16 nResetBajo;
+	int16 nResetMuestreo;
+	int16 nResetFin;
+	int8 nEscrituraBajo;
+	int8 nEscrituraBit;
+	int8 nEscrituraRecupera;
+	int8 nLecturaBajo;
+	int8 nLecturaMuestreo;
+	int8 nLecturaRecupera;
+	int8 nBloqueEscrituraBit;											///< Tiempos ajustados al minimo para OneWire_WriteBlock() y OneWire_ReadBlock()
+	int8 nBloqueLecturaRecupera;
+	int8 nBloqueRecupera;
+	int1 lOverdrive;													///< 1 si son los tiempos de overdrive
+} OneWire_Tiempos;
+
+OneWire_Tiempos OneWire_Perfil = {ONEWIRE_STD_RESET_BAJO, ONEWIRE_STD_RESET_MUESTREO, ONEWIRE_STD_RESET_FIN,
+								  ONEWIRE_STD_ESCRITURA_BAJO, ONEWIRE_STD_ESCRITURA_BIT, ONEWIRE_STD_ESCRITURA_RECUPERA,
+								  ONEWIRE_STD_LECTURA_BAJO, ONEWIRE_STD_LECTURA_MUESTREO, ONEWIRE_STD_LECTURA_RECUPERA,
+								  ONEWIRE_STD_BLOQUE_ESCRITURA_BIT, ONEWIRE_STD_BLOQUE_LECTURA_RECUPERA, ONEWIRE_STD_BLOQUE_RECUPERA, 0};
+
+///Tiempos que carga OneWire_Velocidad (0), los cambia la calibracion del bus ( JSB_1wire_Calibracion.h )
+OneWire_Tiempos OneWire_PerfilEstandar = {ONEWIRE_STD_RESET_BAJO, ONEWIRE_STD_RESET_MUESTREO, ONEWIRE_STD_RESET_FIN,
+								  ONEWIRE_STD_ESCRITURA_BAJO, ONEWIRE_STD_ESCRITURA_BIT, ONEWIRE_STD_ESCRITURA_RECUPERA,
+								  ONEWIRE_STD_LECTURA_BAJO, ONEWIRE_STD_LECTURA_MUESTREO, ONEWIRE_STD_LECTURA_RECUPERA,
+								  ONEWIRE_STD_BLOQUE_ESCRITURA_BIT, ONEWIRE_STD_BLOQUE_LECTURA_RECUPERA, ONEWIRE_STD_BLOQUE_RECUPERA, 0};
+
+/**
+* Tiempos que usan los slots. Con ONEWIRE_TIEMPOS_FIJOS son las constantes ONEWIRE_STD_xxx y delay_us() genera
+* un bucle exacto en linea en lugar de la llamada con variable, que a pocos MHz cuesta varios us de cada slot.
+* A cambio OneWire_Perfil deja de tener efecto en los slots: no se puede usar overdrive ni la calibracion
+*/
+#ifdef ONEWIRE_TIEMPOS_FIJOS
+	#define _ONEWIRE_T_RESET_BAJO				ONEWIRE_STD_RESET_BAJO
+	#define _ONEWIRE_T_RESET_MUESTREO			ONEWIRE_STD_RESET_MUESTREO
+	#define _ONEWIRE_T_RESET_FIN				ONEWIRE_STD_RESET_FIN
+	#define _ONEWIRE_T_ESCRITURA_BAJO			ONEWIRE_STD_ESCRITURA_BAJO
+	#define _ONEWIRE_T_ESCRITURA_BIT			ONEWIRE_STD_ESCRITURA_BIT
+	#define _ONEWIRE_T_ESCRITURA_RECUPERA		ONEWIRE_STD_ESCRITURA_RECUPERA
+	#define _ONEWIRE_T_LECTURA_BAJO				ONEWIRE_STD_LECTURA_BAJO
+	#define _ONEWIRE_T_LECTURA_MUESTREO			ONEWIRE_STD_LECTURA_MUESTREO
+	#define _ONEWIRE_T_LECTURA_RECUPERA			ONEWIRE_STD_LECTURA_RECUPERA
+	#define _ONEWIRE_T_BLOQUE_ESCRITURA_BIT		ONEWIRE_STD_BLOQUE_ESCRITURA_BIT
+	#define _ONEWIRE_T_BLOQUE_LECTURA_RECUPERA	ONEWIRE_STD_BLOQUE_LECTURA_RECUPERA
+	#define _ONEWIRE_T_BLOQUE_RECUPERA			ONEWIRE_STD_BLOQUE_RECUPERA
+#else
+	#define _ONEWIRE_T_RESET_BAJO				OneWire_Perfil.nResetBajo
+	#define _ONEWIRE_T_RESET_MUESTREO			OneWire_Perfil.nResetMuestreo
+	#define _ONEWIRE_T_RESET_FIN				OneWire_Perfil.nResetFin
+	#define _ONEWIRE_T_ESCRITURA_BAJO			OneWire_Perfil.nEscrituraBajo
+	#define _ONEWIRE_T_ESCRITURA_BIT			OneWire_Perfil.nEscrituraBit
+	#define _ONEWIRE_T_ESCRITURA_RECUPERA		OneWire_Perfil.nEscrituraRecupera
+	#define _ONEWIRE_T_LECTURA_BAJO				OneWire_Perfil.nLecturaBajo
+	#define _ONEWIRE_T_LECTURA_MUESTREO			OneWire_Perfil.nLecturaMuestreo
+	#define _ONEWIRE_T_LECTURA_RECUPERA			OneWire_Perfil.nLecturaRecupera
+	#define _ONEWIRE_T_BLOQUE_ESCRITURA_BIT		OneWire_Perfil.nBloqueEscrituraBit
+	#define _ONEWIRE_T_BLOQUE_LECTURA_RECUPERA	OneWire_Perfil.nBloqueLecturaRecupera
+	#define _ONEWIRE_T_BLOQUE_RECUPERA			OneWire_Perfil.nBloqueRecupera
+#endif
+
+/**
+* Slots de bit en linea, sin llamadas entre el flanco de bajada y el muestreo. Como las macros _OneWire_Est
+* incluyen su propio punto y coma. En la escritura el bit solo decide si el bus se libera tras el pulso bajo
+*
+* Con ONEWIRE_INTERRUPCIONES una interrupcion solo puede alargar las fases que lo admiten. El slot de lectura
+* bloquea desde el flanco de bajada hasta el muestreo ( 17 us ) y el de escritura hasta liberar el 1 ( 10 us ).
+* Las ventanas mas largas solo se bloquean si no pasan de ONEWIRE_BLOQUEO_MAX us: el resto del pulso bajo de un 0
+* ( hasta 80 us ) y la espera de la presencia ( 60 us ). Si no se bloquean, una rutina de interrupcion de mas de
+* 40 us alarga el 0 por encima de 120 us y una de mas de 15 us puede leer la presencia fuera de la ventana.
+* La recuperacion y el tiempo entre slots siempre admiten interrupciones
+*/
+#ifdef ONEWIRE_INTERRUPCIONES
+	#ifndef ONEWIRE_BLOQUEO_MAX
+	#define ONEWIRE_BLOQUEO_MAX				20							///< Ventana maxima con las interrupciones enmascaradas ( us )
+	#endif
+	#if ONEWIRE_STD_LECTURA_BAJO + ONEWIRE_STD_LECTURA_MUESTREO > ONEWIRE_BLOQUEO_MAX
+	#error ONEWIRE_BLOQUEO_MAX no cubre el pulso bajo y el muestreo del slot de lectura
+	#endif
+	#if ONEWIRE_STD_ESCRITURA_BAJO > ONEWIRE_BLOQUEO_MAX
+	#error ONEWIRE_BLOQUEO_MAX no cubre el pulso bajo del slot de escritura
+	#endif
+	#define _OneWire_BloqueaSi(n)		if ((n) <= ONEWIRE_BLOQUEO_MAX) { _OneWire_Bloquea (); }
+	#define _OneWire_DesbloqueaSi(n)	if ((n) > ONEWIRE_BLOQUEO_MAX) { _OneWire_Desbloquea (); }
+	#define _OneWire_SlotEscribe(l,nBit,nRecupera)	{ _OneWire_Bloquea (); _OneWire_PinLow (); _OneWire_DelayUs (_ONEWIRE_T_ESCRITURA_BAJO); if (l) { _OneWire_PinHigh (); _OneWire_Desbloquea (); }else{ _OneWire_DesbloqueaSi (_ONEWIRE_T_ESCRITURA_BAJO + nBit) } _OneWire_DelayUs (nBit); _OneWire_PinFloat (); _OneWire_Desbloquea (); _OneWire_DelayUs (nRecupera); }
+	#define _OneWire_SlotLee(l,nRecupera)			{ _OneWire_Bloquea (); _OneWire_PinLow (); _OneWire_DelayUs (_ONEWIRE_T_LECTURA_BAJO); _OneWire_PinFloat (); _OneWire_DelayUs (_ONEWIRE_T_LECTURA_MUESTREO); l = _OneWire_PinRead (); _OneWire_Desbloquea (); _OneWire_DelayUs (nRecupera); }
+#else
+	#define _OneWire_BloqueaSi(n)
+	#define _OneWire_DesbloqueaSi(n)
+	#define _OneWire_SlotEscribe(l,nBit,nRecupera)	{ _OneWire_PinLow (); _OneWire_DelayUs (_ONEWIRE_T_ESCRITURA_BAJO); if (l) { _OneWire_PinHigh (); } _OneWire_DelayUs (nBit); _OneWire_PinFloat (); _OneWire_DelayUs (nRecupera); }
+	#define _OneWire_SlotLee(l,nRecupera)			{ _OneWire_PinLow (); _OneWire_DelayUs (_ONEWIRE_T_LECTURA_BAJO); _OneWire_PinFloat (); _OneWire_DelayUs (_ONEWIRE_T_LECTURA_MUESTREO); l = _OneWire_PinRead (); _OneWire_DelayUs (nRecupera); }
+#endif
+
+/** @} */ // end of group8
+
+/** @defgroup group14 Estadisticas del bus
+ *  @brief Contadores y tiempos de las operaciones del bus
+ *
+ *  Se activan definiendo ONEWIRE_ESTADISTICAS antes de incluir JSB_1wire.h. Sin ella las macros _OneWire_Est
+ *  no generan codigo. Los tiempos se miden en incrementos de _OneWire_EstReloj(): us del reloj virtual en el PC
+ *  y por defecto el Timer1 en el PIC, que debe configurarse en el programa con setup_timer_1()
+ *  @{
+ */
+
+#ifdef ONEWIRE_ESTADISTICAS
+
+/**
+* @brief Contadores acumulados desde el ultimo OneWire_EstadisticasBorra()
+*/
+typedef struct
+{
+	int32 nResets;														///< Llamadas a OneWire_Reset()
+	int32 nResetsSinPresencia;											///< Resets en los que nadie ha respondido
+	int32 nBytesEnviados;												///< Bytes enviados con OneWire_SendByte() y OneWire_WriteBlock()
+	int32 nBytesRecibidos;												///< Bytes recibidos con OneWire_ReceiveByte() y OneWire_ReadBlock()
+	int32 nBusquedas;													///< Busquedas iniciadas ( OneWire_SearchROM(), OneWire_SearchFirst() ... )
+	int32 nPasadas;														///< Pasadas por el arbol de Id's
+	int32 nPasadasDirigidas;											///< Pasadas siguiendo un Id conocido
+	int32 nReintentosBusqueda;											///< Pasadas de busqueda repetidas por un fallo
+	int32 nComprobacionesCRC;											///< CRC comprobados ( Id's de la busqueda y bloques leidos )
+	int32 nErroresCRC;													///< CRC que no coinciden
+	int32 nTiempoReset;													///< Tiempo en los resets
+	int32 nTiempoBytes;													///< Tiempo enviando y recibiendo bytes y bloques
+	int32 nTiempoBusqueda;												///< Tiempo en las pasadas de OneWire_SearchNext(), incluidos sus resets y bytes
+} OneWire_Estadisticas;
+
+OneWire_Estadisticas OneWire_Est;
+
+#ifdef ONEWIRE_SIM
+	#ifndef _OneWire_EstReloj
+		#define _OneWire_EstReloj()			((int32)OneWireSim.nTiempo)
+		#define ONEWIRE_EST_RELOJ			int32
+	#endif
+#else
+	#ifndef _OneWire_EstReloj
+		#define _OneWire_EstReloj()			get_timer1 ()
+		#define ONEWIRE_EST_RELOJ			int16
+	#endif
+#endif
+
+#define _OneWire_EstMarca(n)				ONEWIRE_EST_RELOJ n;
+#define _OneWire_EstInicio(n)				n = _OneWire_EstReloj ();
+#define _OneWire_EstTiempo(c,n)				OneWire_Est.c += (ONEWIRE_EST_RELOJ)(_OneWire_EstReloj () - n);
+#define _OneWire_EstCuenta(c)				OneWire_Est.c++;
+#define _OneWire_EstSuma(c,n)				OneWire_Est.c += n;
+#define _OneWire_EstCRC(l)					{ OneWire_Est.nComprobacionesCRC++; if (!(l)) OneWire_Est.nErroresCRC++; }
+
+void OneWire_EstadisticasBorra (void);
+void OneWire_EstadisticasCaptura (OneWire_Estadisticas* pCopia);
+
+#else
+
+#define _OneWire_EstMarca(n)
+#define _OneWire_EstInicio(n)
+#define _OneWire_EstTiempo(c,n)
+#define _OneWire_EstCuenta(c)
+#define _OneWire_EstSuma(c,n)
+#define _OneWire_EstCRC(l)
+
+#endif
+
+/** @} */ // end of group14
 
 /** @defgroup group1 Funciones para control del bus 1Wire
  *  @brief Funciones para control del bus 1Wire
@@ -23,13 +312,29 @@
  *  @{
  */
 
+#define ONEWIRE_TRIPLET_BIT				0x01							///< Resultado de OneWire_Triplet(), bit leido
+#define ONEWIRE_TRIPLET_COMPLEMENTO		0x02							///< Complemento leido
+#define ONEWIRE_TRIPLET_BITS			0x03
+#define ONEWIRE_TRIPLET_DIRECCION		0x04							///< Direccion escrita
+
+#define ONEWIRE_CRC_NINGUNO				0								///< CRC que calculan OneWire_WriteBlock() y OneWire_ReadBlock()
+#define ONEWIRE_CRC_8					1
+#define ONEWIRE_CRC_16					2
+
+#define ONEWIRE_CRC16_RESIDUO			0xB001							///< CRC16 de unos datos seguidos de su CRC16 invertido
+
 int1 OneWire_Reset (void);
+void OneWire_Velocidad (int1 lOverdrive);
 void OneWire_Write (int1 lBit);
 void OneWire_Write_1 (void);
 void OneWire_Write_0 (void);
 int1 OneWire_LeeBit (void);
+int8 OneWire_Triplet (int1 lDireccion);
 void OneWire_SendByte (byte cDato); 
 byte OneWire_ReceiveByte();
+byte OneWire_ReceiveByteCRC(int8* pCRC);
+void OneWire_WriteBlock (int8* aDatos, int8 nBytes, int8 nTipoCRC, int16* pCRC);
+int1 OneWire_ReadBlock (int8* aDatos, int8 nBytes, int8 nTipoCRC, int16* pCRC);
 
 /** @} */ // end of group2
 
@@ -38,12 +343,65 @@ byte OneWire_ReceiveByte();
  *  @{
  */
 
-int* OneWire_ReadROM(void);
+#ifndef ONEWIRE_BUSQUEDA_REINTENTOS
+#define ONEWIRE_BUSQUEDA_REINTENTOS		2								///< Veces que OneWire_SearchNext() repite una pasada fallida
+#endif
+
+#define ONEWIRE_PASADA_VACIA			0								///< Resultado de _OneWire_SearchPasada(), sin presencia o nadie responde al primer bit
+#define ONEWIRE_PASADA_CORRECTA			1								///< Se han leido los 64 bits
+#define ONEWIRE_PASADA_FALLIDA			2								///< Nadie responde a mitad del Id
+
+/**
+* @brief Estado de una busqueda con OneWire_SearchFirst() / OneWire_SearchNext()
+*/
+typedef struct
+{
+	int8 aRom[8];														///< Ultimo Id encontrado, camino a repetir en la siguiente pasada
+	int8 nUltimaDiscrepancia;											///< Posicion ( 1 a 64 ) de la discrepancia a cambiar, 0 si no quedan
+	int8 nUltimaDiscrepanciaFamilia;									///< Ultima discrepancia dentro del codigo de familia
+	int1 lUltimoDispositivo;											///< Ya se ha encontrado el ultimo dispositivo
+	int8 cComando;														///< Comando de busqueda, 0xF0 normal o 0xEC solo dispositivos en alarma
+	int8 cFamilia;														///< Codigo de familia buscado si lFamilia es 1
+	int1 lFamilia;														///< La busqueda se limita a una familia
+	int8 nReintentos;													///< Pasadas repetidas por fallos desde el inicio de la busqueda
+} OneWire_Busqueda;
+
+#define ONEWIRE_VERIFICA_PRESENTE		0								///< Resultados de OneWire_Verifica()
+#define ONEWIRE_VERIFICA_AUSENTE		1
+#define ONEWIRE_VERIFICA_CRC			2								///< El Id no tiene un CRC valido
+#define ONEWIRE_VERIFICA_NINGUNA		0xFF							///< Uso interno, todavia no se ha hecho ninguna pasada
+
+#ifndef ONEWIRE_RESUME_FAMILIA
+#define ONEWIRE_RESUME_FAMILIA(c)	((c) == 0x2D || (c) == 0x43 || (c) == 0x3A || (c) == 0x29)	///< Familias que admiten Resume ( DS2431, DS28EC20, DS2413, DS2408 )
+#endif
+
+/**
+* @brief Ultimo dispositivo direccionado con OneWire_MatchROM()
+*/
+typedef struct
+{
+	int8 aRom[8];														///< Id del dispositivo
+	int1 lValido;														///< No ha habido otro comando ROM desde entonces
+} OneWire_Direccion;
+
+OneWire_Direccion OneWire_Resume = {{0, 0, 0, 0, 0, 0, 0, 0}, 0};
+
+int8* OneWire_ReadROM(void);
 void OneWire_MatchROM (int8* aId);
 void OneWire_SkipROM (void);
-int* OneWire_SearchROM (void);
-int  OneWire_CuentaDispositivos();
+int1 OneWire_OverdriveSkipROM (void);
+int1 OneWire_OverdriveMatchROM (int8* aId);
+int8* OneWire_SearchROM (void);
+int8 OneWire_CuentaDispositivos (void);
+int1 OneWire_SearchFirst (OneWire_Busqueda* pBusqueda, int8* aRom);
+int1 OneWire_SearchNext (OneWire_Busqueda* pBusqueda, int8* aRom);
+int1 OneWire_SearchFamilia (OneWire_Busqueda* pBusqueda, int8 cFamilia, int8* aRom);
+int1 OneWire_AlarmSearchFirst (OneWire_Busqueda* pBusqueda, int8* aRom);
+int8 OneWire_Verifica (int8* aRom);
+int8 OneWire_VerificaLista (int8* aRoms, int8 nDispositivos, int8* aResultados);
 int OneWire_CRC ( int crc, int nData );
+int8 OneWire_CRCBloque ( int8 nCRC, int8* aDatos, int8 nBytes );
+int16 OneWire_CRC16 ( int16 nCRC, int8 nDato );
 
 /** @} */ // end of group3
 
@@ -52,15 +410,30 @@ int OneWire_CRC ( int crc, int nData );
  *  @{
  */
 
-void _OneWire_LimpiaMapaColisiones ( int nPosBit, int* HBit );
-int1 _OneWire_LeeBitColision ( int nPosBit, int* HBit );
-void _OneWire_SetBitColision ( int nPosBit, int* HBit );
-void _OneWire_IniciaMapaColisiones (int* HBit);
+int1 _OneWire_PulsoReset (void);
+int8 _OneWire_SearchPasada (OneWire_Busqueda* pBusqueda);
+int8 _OneWire_SearchDirigida (int8* aRom, int8* aDiscrepancias);
+int1 _OneWire_SearchCamino (int8* aAnterior, int8* aRom, int8 nDiscrepancia);
+int8 _OneWire_RomDiferencia (int8* aRom1, int8* aRom2);
+int1 _OneWire_ConfirmaRoms (int8* aRoms, int8 nDispositivos);
+void _OneWire_AcumulaCRC (int8 nTipoCRC, int16* pCRC, int8 cDato);
 
 /** @} */ // end of group4
 
 /** @} */ // end of group1
 
+#ifdef ONEWIRE_ASYNC
+	#include "JSB_1wire_Async.h"
+#endif
+
+#ifdef ONEWIRE_UART
+	#include "JSB_1wire_Uart.h"
+#endif
+
+#ifdef ONEWIRE_DS2482
+	#include "JSB_1wire_DS2482.h"
+#endif
+
 #include "jsb_1wire.c"
 
 
@@ -0,0 +1,90 @@
+/**
+******************************************************
+* @file JSB_1wire_Async.h
+* @brief Motor no bloqueante del bus 1Wire gobernado por la interrupcion de un temporizador
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Se activa definiendo ONEWIRE_ASYNC antes de incluir JSB_1wire.h. Las esperas largas de cada
+* operacion ( pulso de reset, espera de presencia, duracion del slot y recuperacion ) se hacen
+* con la interrupcion del Timer1, de forma que el programa principal queda libre mientras tanto.
+* Dentro de la interrupcion solo se esperan las partes del slot que no admiten retraso
+* ( el pulso bajo inicial y el instante de lectura, como mucho 17 us ).
+*
+* Con ONEWIRE_ASYNC las funciones basicas OneWire_Reset(), OneWire_Write(), OneWire_LeeBit(),
+* OneWire_SendByte() y OneWire_ReceiveByte() lanzan la operacion y esperan a que termine.
+*
+* El Timer1 debe configurarse en el programa con setup_timer_1() y ONEWIRE_TICKS_US indicar
+* cuantos incrementos del timer hay en 1 us. Tambien deben estar habilitadas las interrupciones
+* globales. Si se define ONEWIRE_ASYNC_CALLBACK con el nombre de una funcion, se llama al terminar
+* cada operacion desde la propia interrupcion.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_ASYNC
+#define _JSB1WIRE_ASYNC
+
+/** @defgroup group7 Motor no bloqueante
+ *  @brief Operaciones del bus que se ejecutan desde la interrupcion de un temporizador
+ *  @{
+ */
+
+#ifndef ONEWIRE_TICKS_US
+#define ONEWIRE_TICKS_US		1										///< Incrementos del Timer1 por us ( Fosc 4 MHz con prescaler 1 )
+#endif
+
+#ifdef ONEWIRE_SIM
+	#define _OneWire_TimerArma(n)	OneWireSim_TimerArma (n, _OneWire_AsyncISR)
+	#define _OneWire_TimerPara()	OneWireSim_TimerPara ()
+	#define _OneWire_AsyncIdle()	OneWireSim_Espera ()
+#else
+	#define _OneWire_TimerArma(n)	{ set_timer1 (65536 - (int16)(n) * ONEWIRE_TICKS_US); clear_interrupt (INT_TIMER1); enable_interrupts (INT_TIMER1); }
+	#define _OneWire_TimerPara()	disable_interrupts (INT_TIMER1)
+	#define _OneWire_AsyncIdle()
+#endif
+
+#define ONEWIRE_ASYNC_LIBRE				0								///< Fases de la maquina de estados
+#define ONEWIRE_ASYNC_RESET_LIBERA		1
+#define ONEWIRE_ASYNC_RESET_MUESTREO	2
+#define ONEWIRE_ASYNC_SLOT				3
+#define ONEWIRE_ASYNC_ESCRITURA_FIN		4
+#define ONEWIRE_ASYNC_LECTURA_FIN		5
+#define ONEWIRE_ASYNC_FIN				6
+
+/**
+* @brief Estado de la operacion en curso
+*/
+typedef struct
+{
+	volatile int1 lOcupado;												///< 1 mientras la operacion no ha terminado
+	int1 lPresencia;													///< Resultado del reset, 1 si algun esclavo respondio
+	int1 lBit;															///< Ultimo bit leido
+	int1 lLectura;														///< La operacion lee bytes, si no los escribe
+	int1 lBloque;														///< Bloque con los tiempos minimos ( nBloqueXxx del perfil )
+	int8 nFase;
+	int8 nBit;															///< Bit en curso dentro del byte
+	int8 nBitsByte;														///< 8, o 1 para operaciones de un solo bit
+	int8 nBytes;														///< Bytes pendientes incluido el actual
+	int8* pDatos;														///< Byte en curso
+	byte cDato;															///< Byte para las operaciones de un byte
+} OneWire_AsyncEstado;
+
+void OneWire_AsyncReset (void);
+void OneWire_AsyncWrite (int1 lBit);
+void OneWire_AsyncLeeBit (void);
+void OneWire_AsyncSendByte (byte cDato);
+void OneWire_AsyncReceiveByte (void);
+void OneWire_AsyncWriteBlock (int8* aDatos, int8 nBytes);
+void OneWire_AsyncReadBlock (int8* aDatos, int8 nBytes);
+int1 OneWire_AsyncOcupado (void);
+void OneWire_AsyncEspera (void);
+
+int16 _OneWire_AsyncPaso (void);
+void _OneWire_AsyncFin (void);
+void _OneWire_AsyncISR (void);
+
+/** @} */ // end of group7
+
+#include "jsb_1wire_async.c"
+
+#endif
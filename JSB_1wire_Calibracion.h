@@ -0,0 +1,77 @@
+/**
+******************************************************
+* @file JSB_1wire_Calibracion.h
+* @brief Calibracion de los tiempos de velocidad estandar a partir del pulso de presencia
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Los tiempos ONEWIRE_STD_xxx valen para cables largos. OneWire_Calibra() da un reset y lee el bus cada
+* ONEWIRE_CALIBRA_PASO us para medir cuanto tarda en subir al soltarlo y cuando empieza y termina el pulso de
+* presencia. Con esas medidas elige el punto de muestreo y las recuperaciones mas cortas que respetan los
+* minimos de la especificacion ( slot de 60 us, escritura de un 1 liberada antes de 15 us ) mas
+* ONEWIRE_CALIBRA_MARGEN, y los deja en OneWire_PerfilEstandar, que es el que carga OneWire_Velocidad (0).
+* El reset no se acorta: el bus queda en alto al menos ONEWIRE_CALIBRA_RESET_ALTO us ( tRSTH ) aunque el pulso de
+* presencia termine antes, asi responde tambien un dispositivo que se conecte despues de la calibracion.
+*
+* En el PIC el bucle de medida tarda mas que el delay_us(): ONEWIRE_CALIBRA_PASO debe ser la duracion real de
+* una vuelta del bucle. No se puede usar con ONEWIRE_UART ni ONEWIRE_DS2482, que generan sus propios tiempos,
+* ni con ONEWIRE_TIEMPOS_FIJOS.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_CALIBRACION
+#define _JSB1WIRE_CALIBRACION
+
+/** @defgroup group15 Calibracion del bus
+ *  @brief Ajuste de los tiempos de velocidad estandar a las caracteristicas del bus
+ *  @{
+ */
+
+#if defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482)
+	#error La calibracion solo tiene sentido cuando el PIC genera los tiempos del bus
+#endif
+
+#ifdef ONEWIRE_TIEMPOS_FIJOS
+	#error Con ONEWIRE_TIEMPOS_FIJOS los slots no usan los tiempos calibrados
+#endif
+
+#ifndef ONEWIRE_CALIBRA_PASO
+#define ONEWIRE_CALIBRA_PASO			1								///< us entre dos lecturas del bus durante la medida
+#endif
+
+#ifndef ONEWIRE_CALIBRA_MARGEN
+#define ONEWIRE_CALIBRA_MARGEN			3								///< Margen de seguridad sobre cada medida ( us )
+#endif
+
+#ifndef ONEWIRE_CALIBRA_REPETICIONES
+#define ONEWIRE_CALIBRA_REPETICIONES	4								///< Resets medidos, se toma el peor caso
+#endif
+
+#define ONEWIRE_CALIBRA_ESPERA_MAX		300								///< Tiempo maximo de medida tras el reset ( us )
+#define ONEWIRE_CALIBRA_SLOT			60								///< Duracion minima de un slot segun la especificacion
+#define ONEWIRE_CALIBRA_RESET_ALTO		480								///< Tiempo minimo en alto tras el pulso de reset ( tRSTH )
+#define ONEWIRE_CALIBRA_MUESTREO_ESCLAVO	15							///< Primer instante en el que un esclavo puede leer el bit
+
+/**
+* @brief Medidas del bus, en us desde el fin del pulso de reset
+*/
+typedef struct
+{
+	int16 nSubida;														///< Tiempo hasta que el bus vuelve a 1 ( el mayor medido )
+	int16 nPresenciaInicio;												///< Inicio del pulso de presencia ( el mas tardio )
+	int16 nPresenciaFin;												///< Fin del pulso de presencia ( el mas tardio )
+	int16 nPresenciaFinMin;												///< Fin del pulso de presencia ( el mas temprano )
+} OneWire_Calibracion;
+
+int1 OneWire_Calibra (OneWire_Calibracion* pCalibracion);
+int1 OneWire_CalibraMide (OneWire_Calibracion* pCalibracion);
+int1 OneWire_CalibraAplica (OneWire_Calibracion* pCalibracion);
+void OneWire_CalibraBorra (void);
+
+int1 _OneWire_CalibraReset (OneWire_Calibracion* pMedida);
+
+/** @} */ // end of group15
+
+#include "jsb_1wire_calibracion.c"
+
+#endif
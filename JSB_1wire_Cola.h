@@ -0,0 +1,121 @@
+/**
+******************************************************
+* @file JSB_1wire_Cola.h
+* @brief Cola de transacciones compartida por los modulos del programa, con agrupacion de peticiones
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Cada modulo anade peticiones ( Convert T, Read Scratchpad, Write Scratchpad de un DS18B20 o Read Memory de
+* un DS2431 ) y recoge el resultado mas tarde con OneWire_ColaResultado(). El bus solo lo usa
+* OneWire_ColaProcesa(), que el bucle principal llama periodicamente y que en cada ciclo:
+*
+*	- Escribe los scratchpad. De varias escrituras al mismo Id solo se envia la ultima
+*	- Lanza todas las conversiones con un solo Skip ROM + Convert T ( Match ROM si solo hay un sensor ) y
+*	  vuelve sin esperar: cada llamada siguiente da un slot de lectura y, si los sensores no han terminado,
+*	  espera 1 ms. A los ONEWIRE_TEMP_ESPERA_MAX ms la conversion se da por fallida
+*	- Lee los scratchpad y las memorias en el orden de la busqueda. Las peticiones del mismo Id van seguidas,
+*	  asi OneWire_MatchROM() usa Resume en las familias que lo admiten. Varias lecturas del scratchpad de un
+*	  Id se sirven con una sola y los rangos de memoria cercanos se leen con un solo Read Memory
+*
+* Si se define ONEWIRE_COLA_AVISO con el nombre de una funcion, se llama con el numero de la peticion al
+* terminar cada una. Los demas modulos no deben usar el bus mientras la cola tiene una conversion en curso.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_COLA
+#define _JSB1WIRE_COLA
+
+#include "JSB_1wire_Temperatura.h"
+#include "JSB_1wire_Memoria.h"
+#include "JSB_1wire_Lista.h"
+
+/** @defgroup group18 Cola de transacciones
+ *  @brief Peticiones de varios modulos agrupadas en ciclos del bus con resultados diferidos
+ *  @{
+ */
+
+#ifndef ONEWIRE_COLA_MAX
+#define ONEWIRE_COLA_MAX				8								///< Peticiones que caben en la cola
+#endif
+
+#ifndef ONEWIRE_COLA_DATOS
+#define ONEWIRE_COLA_DATOS				9								///< Bytes de datos de una peticion ( scratchpad de un DS18B20 )
+#endif
+
+#ifndef ONEWIRE_COLA_SKIP_MIN
+#define ONEWIRE_COLA_SKIP_MIN			2								///< Sensores a partir de los que la conversion usa Skip ROM
+#endif
+
+#ifndef ONEWIRE_COLA_HUECO
+#define ONEWIRE_COLA_HUECO				12								///< Bytes sin pedir que se leen para unir dos rangos de memoria
+#endif
+
+#define ONEWIRE_COLA_CONVIERTE			1								///< Tipos de peticion
+#define ONEWIRE_COLA_LEE_SCRATCHPAD		2
+#define ONEWIRE_COLA_ESCRIBE_SCRATCHPAD	3
+#define ONEWIRE_COLA_LEE_MEMORIA		4
+
+#define ONEWIRE_COLA_LIBRE				0								///< Estados de una peticion
+#define ONEWIRE_COLA_PENDIENTE			1								///< Esperando al siguiente ciclo
+#define ONEWIRE_COLA_CICLO				2								///< En el ciclo en curso
+#define ONEWIRE_COLA_HECHA				3
+#define ONEWIRE_COLA_ERROR				4								///< Sin presencia, CRC incorrecto o conversion sin terminar
+
+#define ONEWIRE_COLA_NINGUNA			0xFF							///< Peticion no aceptada ( cola llena, Id o tamano no validos )
+
+#define ONEWIRE_COLA_FASE_LIBRE			0								///< Fases de OneWire_ColaProcesa()
+#define ONEWIRE_COLA_FASE_CONVERSION	1
+
+/**
+* @brief Peticion de un modulo
+*/
+typedef struct
+{
+	OneWire_Rom stRom;
+	int8 nTipo;															///< ONEWIRE_COLA_xxx
+	int8 nEstado;
+	int8 nOrden;														///< Orden de llegada, solo se compara entre peticiones del mismo ciclo
+	int16 nDireccion;													///< Primera direccion en Read Memory
+	int8 nBytes;														///< Bytes a leer o escribir
+	int8 aDatos[ONEWIRE_COLA_DATOS];
+} OneWire_ColaPeticion;
+
+/**
+* @brief Estado de la cola
+*/
+typedef struct
+{
+	OneWire_ColaPeticion aPeticiones[ONEWIRE_COLA_MAX];
+	int8 nFase;
+	int16 nEspera;														///< ms esperados durante la conversion
+	int8 nOrden;														///< Orden de la ultima peticion anadida
+	int16 nAgrupadas;													///< Peticiones servidas sin una transaccion propia en el bus
+} OneWire_ColaEstado;
+
+OneWire_ColaEstado OneWire_Cola;
+
+void OneWire_ColaInicia (void);
+int8 OneWire_ColaConvierte (int8* aRom);
+int8 OneWire_ColaLeeScratchpad (int8* aRom);
+int8 OneWire_ColaEscribeScratchpad (int8* aRom, int8* aDatos);
+int8 OneWire_ColaLeeMemoria (int8* aRom, int16 nDireccion, int8 nBytes);
+int1 OneWire_ColaProcesa (void);
+int8 OneWire_ColaResultado (int8 nPeticion, int8* aDatos);
+
+int8 _OneWire_ColaAnade (int8* aRom, int8 nTipo, int16 nDireccion, int8* aDatos, int8 nBytes);
+int1 _OneWire_ColaToma (void);
+int8 _OneWire_ColaSiguiente (int1 lLecturas);
+void _OneWire_ColaEscrituras (void);
+int1 _OneWire_ColaConversiones (void);
+void _OneWire_ColaFinConversion (int1 lCorrecta);
+void _OneWire_ColaLecturas (void);
+void _OneWire_ColaScratchpad (int8 nPeticion);
+void _OneWire_ColaMemoria (int8 nPeticion);
+void _OneWire_ColaTermina (int8 nPeticion, int1 lCorrecta);
+int1 _OneWire_ColaMismoId (int8 nPeticion, int8 nOtra, int8 nTipo);
+
+/** @} */ // end of group18
+
+#include "jsb_1wire_cola.c"
+
+#endif
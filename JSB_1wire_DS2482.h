@@ -0,0 +1,99 @@
+/**
+******************************************************
+* @file JSB_1wire_DS2482.h
+* @brief Bus 1Wire a traves de un puente I2C DS2482
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Se activa definiendo ONEWIRE_DS2482 antes de incluir JSB_1wire.h. Los tiempos del bus los genera el DS2482,
+* el PIC solo envia comandos por I2C: 1-Wire Reset, Single Bit, Write Byte, Read Byte y Triplet, este ultimo
+* usado directamente por OneWire_Triplet() en las busquedas.
+*
+* Tras cada comando el puntero de lectura del DS2482 queda en el registro de estado, asi que la espera se hace
+* leyendo el estado dentro de la misma transaccion, sin volver a direccionar el registro. En los bloques los
+* comandos se encadenan con start repetido y una sola condicion de stop al final.
+*
+* El bus I2C se declara en el programa con #use i2c(master, sda=..., scl=..., fast). Para otro bus se definen
+* las macros _OneWireI2C_Inicio(), _OneWireI2C_Escribe(), _OneWireI2C_Lee() y _OneWireI2C_Parada().
+* En el PC ( ONEWIRE_SIM ) el DS2482 se simula a nivel de registros sobre el bus virtual.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_DS2482
+#define _JSB1WIRE_DS2482
+
+/** @defgroup group13 Puente I2C DS2482
+ *  @brief Funciones basicas del bus ejecutadas por un DS2482
+ *  @{
+ */
+
+#if defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART)
+	#error ONEWIRE_DS2482 no puede usarse con ONEWIRE_ASYNC ni con ONEWIRE_UART
+#endif
+
+#ifndef ONEWIRE_DS2482_DIRECCION
+#define ONEWIRE_DS2482_DIRECCION		0x30							///< Direccion I2C de escritura ( AD1 = AD0 = 0 )
+#endif
+
+#ifndef ONEWIRE_DS2482_SONDEOS
+#define ONEWIRE_DS2482_SONDEOS			200								///< Lecturas maximas del estado esperando el fin de un comando
+#endif
+
+#define ONEWIRE_DS2482_RESET_PUENTE		0xF0							///< Comandos del DS2482
+#define ONEWIRE_DS2482_PUNTERO			0xE1
+#define ONEWIRE_DS2482_CONFIGURACION	0xD2
+#define ONEWIRE_DS2482_RESET			0xB4
+#define ONEWIRE_DS2482_BIT				0x87
+#define ONEWIRE_DS2482_ESCRIBE_BYTE		0xA5
+#define ONEWIRE_DS2482_LEE_BYTE			0x96
+#define ONEWIRE_DS2482_TRIPLET			0x78
+
+#define ONEWIRE_DS2482_REG_ESTADO		0xF0							///< Registros para ONEWIRE_DS2482_PUNTERO
+#define ONEWIRE_DS2482_REG_DATO			0xE1
+#define ONEWIRE_DS2482_REG_CONFIG		0xC3
+
+#define ONEWIRE_DS2482_1WB				0x01							///< Bits del registro de estado
+#define ONEWIRE_DS2482_PPD				0x02
+#define ONEWIRE_DS2482_SD				0x04
+#define ONEWIRE_DS2482_LL				0x08
+#define ONEWIRE_DS2482_RST				0x10
+#define ONEWIRE_DS2482_SBR				0x20
+#define ONEWIRE_DS2482_TSB				0x40
+#define ONEWIRE_DS2482_DIR				0x80
+
+#define ONEWIRE_DS2482_APU				0x01							///< Bits del registro de configuracion
+#define ONEWIRE_DS2482_SPU				0x04
+#define ONEWIRE_DS2482_1WS				0x08
+
+#ifdef ONEWIRE_SIM
+	#ifndef _OneWireI2C_Inicio
+		#define _OneWireI2C_Inicio()	OneWireSim_I2CInicio ()
+		#define _OneWireI2C_Escribe(c)	OneWireSim_I2CEscribe (c)
+		#define _OneWireI2C_Lee(a)		OneWireSim_I2CLee (a)
+		#define _OneWireI2C_Parada()	OneWireSim_I2CParada ()
+	#endif
+#else
+	#ifndef _OneWireI2C_Inicio
+		#define _OneWireI2C_Inicio()	i2c_start ()
+		#define _OneWireI2C_Escribe(c)	i2c_write (c)
+		#define _OneWireI2C_Lee(a)		i2c_read (a)
+		#define _OneWireI2C_Parada()	i2c_stop ()
+	#endif
+#endif
+
+int8 OneWire_DS2482Config = ONEWIRE_DS2482_APU;							///< Configuracion activa del DS2482
+
+int1 OneWire_DS2482Inicia (void);
+int8 OneWire_DS2482Comando (int8 cComando, int8 cParametro, int1 lParametro);
+int1 OneWire_DS2482Configura (int8 cConfig);
+void OneWire_DS2482Bloque (int8* aDatos, int8 nBytes, int1 lLectura);
+
+void _OneWire_DS2482Envia (int8 cComando, int8 cParametro, int1 lParametro);
+int8 _OneWire_DS2482Espera (void);
+int8 _OneWire_DS2482LeeDato (void);
+
+/** @} */ // end of group13
+
+#include "jsb_1wire_ds2482.c"
+
+#endif
@@ -0,0 +1,89 @@
+/**
+******************************************************
+* @file JSB_1wire_Host.h
+* @brief Equivalencias de los tipos y funciones internas de CCS para compilar la libreria en un PC
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Solo se utiliza cuando se define ONEWIRE_SIM. Permite compilar jsb_1wire.c con gcc en Linux
+* para ejecutarlo contra el simulador del bus ( JSB_1wire_Sim.h )
+*
+* Con ONEWIRE_UART el puerto serie virtual necesita _GNU_SOURCE, que solo tiene efecto si se define antes del primer
+* #include del sistema: en la linea de ordenes ( -D_GNU_SOURCE ) o al principio del programa
+*
+*******************************************************/
+#ifndef _JSB1WIRE_HOST
+#define _JSB1WIRE_HOST
+
+#ifdef ONEWIRE_UART
+	#if defined(__GLIBC__) && !defined(__USE_GNU)						//Ya se ha incluido una cabecera del sistema sin _GNU_SOURCE
+		#error ONEWIRE_UART necesita _GNU_SOURCE definido antes de cualquier #include
+	#endif
+	#ifndef _GNU_SOURCE
+	#define _GNU_SOURCE													//posix_openpt() y cfmakeraw() para el puerto serie virtual
+	#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ONEWIRE_UART
+	#include <fcntl.h>
+	#include <termios.h>
+	#include <unistd.h>
+#endif
+
+/** @defgroup group5 Compatibilidad CCS en PC
+ *  @brief Tipos y funciones internas del compilador CCS que no existen en gcc
+ *  @{
+ */
+
+typedef _Bool int1;														//En CCS int1 es un bit, cualquier valor distinto de 0 es 1
+typedef unsigned char int8;
+typedef unsigned char byte;
+typedef unsigned short int16;
+typedef unsigned int int32;
+typedef unsigned long long int64;
+
+#ifndef TRUE
+#define TRUE	1
+#define FALSE	0
+#endif
+
+#define bit_test(x,n)	((((x)>>(n))&1)!=0)
+#define bit_set(x,n)	((x)|=(1<<(n)))
+#define bit_clear(x,n)	((x)&=~(1<<(n)))
+#define make8(x,n)		((int8)((x)>>((n)*8)))
+#define make16(h,l)		((int16)(((int16)(h)<<8)|(l)))
+
+/**
+******************************************************
+* @brief Equivalente a shift_right() de CCS
+*
+* Desplaza a la derecha un array de nBytes ( el byte 0 es el de menor peso ) e introduce lBit en el bit de mayor peso
+*
+* @param pDato Puntero al array a desplazar
+* @param nBytes Numero de bytes del array
+* @param lBit Bit que se introduce por la izquierda
+* @return Bit que sale por la derecha
+*/
+static inline int1 shift_right (void* pDato, int8 nBytes, int1 lBit)
+{
+	int8 *aDato = (int8*) pDato;
+	int1 lSale;
+
+	lSale = aDato[0] & 0x01;
+	while (nBytes--)
+	{
+		int1 lTmp = aDato[nBytes] & 0x01;
+		aDato[nBytes] = (aDato[nBytes] >> 1) | (lBit ? 0x80 : 0);
+		lBit = lTmp;
+	}
+	return lSale;
+}
+
+/** @} */ // end of group5
+
+#endif
@@ -0,0 +1,65 @@
+/**
+******************************************************
+* @file JSB_1wire_Inventario.h
+* @brief Inventario de los dispositivos del bus 1Wire con deteccion de altas y bajas
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Mantiene en una tabla estatica los Id's de los dispositivos conocidos. En cada actualizacion se
+* confirma cada Id con una pasada de busqueda dirigida; solo si falta algun dispositivo o aparece
+* una discrepancia que no corresponde a los Id's conocidos se recorre el arbol completo. Confirmar un Id exige
+* llegar a su hoja, asi que con el bus estable una actualizacion cuesta lo mismo que una enumeracion.
+*
+* La tabla se mantiene en el orden de la busqueda, como OneWire_Lista: las altas ocupan su lugar y las bajas se
+* eliminan en la actualizacion siguiente, asi que la posicion de un Id puede cambiar en cada actualizacion.
+*
+* Se incluye despues de JSB_1wire.h. ONEWIRE_INVENTARIO_MAX fija el numero de dispositivos de la tabla.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_INVENTARIO
+#define _JSB1WIRE_INVENTARIO
+
+/** @defgroup group9 Inventario de dispositivos
+ *  @brief Tabla de dispositivos conocidos y deteccion de cambios en el bus
+ *  @{
+ */
+
+#ifndef ONEWIRE_INVENTARIO_MAX
+#define ONEWIRE_INVENTARIO_MAX		16										///< Dispositivos que caben en la tabla
+#endif
+
+#define ONEWIRE_INVENTARIO_ALTA		0x01									///< Dispositivo aparecido en la ultima actualizacion
+#define ONEWIRE_INVENTARIO_BAJA		0x02									///< Dispositivo desaparecido en la ultima actualizacion
+#define ONEWIRE_INVENTARIO_VISTO	0x04									///< Uso interno durante la busqueda completa
+
+#define ONEWIRE_INVENTARIO_NINGUNO	0xFF									///< Indice devuelto si el Id no esta en la tabla
+
+/**
+* @brief Tabla de dispositivos conocidos
+*/
+typedef struct
+{
+	int8 aRom[ONEWIRE_INVENTARIO_MAX][8];									///< Id's de los dispositivos, en el orden de la busqueda
+	int8 aEstado[ONEWIRE_INVENTARIO_MAX];									///< ONEWIRE_INVENTARIO_ALTA o ONEWIRE_INVENTARIO_BAJA
+	int8 nDispositivos;														///< Entradas ocupadas, incluidas las bajas
+	int8 nAltas;															///< Altas en la ultima actualizacion
+	int8 nBajas;															///< Bajas en la ultima actualizacion
+	int1 lBusqueda;															///< La ultima actualizacion ha necesitado recorrer el arbol
+	int1 lDesbordado;														///< Hay dispositivos que no caben en la tabla
+} OneWire_Inventario;
+
+void OneWire_InventarioInicia (OneWire_Inventario* pInventario);
+int8 OneWire_InventarioActualiza (OneWire_Inventario* pInventario);
+int8 OneWire_InventarioBusca (OneWire_Inventario* pInventario, int8* aRom);
+
+void _OneWire_InventarioPurga (OneWire_Inventario* pInventario);
+int1 _OneWire_InventarioConfirma (OneWire_Inventario* pInventario);
+void _OneWire_InventarioRecorre (OneWire_Inventario* pInventario);
+int8 _OneWire_InventarioPosicion (OneWire_Inventario* pInventario, int8* aRom);
+
+/** @} */ // end of group9
+
+#include "jsb_1wire_inventario.c"
+
+#endif
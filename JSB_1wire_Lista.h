@@ -0,0 +1,104 @@
+/**
+******************************************************
+* @file JSB_1wire_Lista.h
+* @brief Id's empaquetados y lista ordenada de dispositivos con busqueda binaria
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* OneWire_Rom guarda un Id en 8 bytes que tambien se pueden ver como dos int32, para comparar la igualdad con
+* dos comparaciones en lugar de ocho. OneWire_RomCrea() solo acepta Id's con el CRC correcto.
+*
+* OneWire_Lista es una tabla estatica de ONEWIRE_LISTA_MAX Id's ordenados en el orden de la busqueda ( el bit 0
+* del byte 0 es el de mayor peso ), el mismo en el que los devuelven OneWire_SearchFirst() / OneWire_SearchNext().
+* Asi la lista se llena desde una busqueda sin reordenar, sirve directamente para OneWire_VerificaLista() y los
+* dispositivos de una familia quedan seguidos. Localizar un Id cuesta log2(n) comparaciones.
+*
+* Cada Id lleva un byte del llamador ( aDato ), por ejemplo la posicion de sus medidas en otra tabla, que se
+* mueve con el Id cuando las altas y bajas desplazan la lista.
+*
+* La lista se puede guardar en la EEPROM del PIC ( OneWire_ListaGuarda() ) y recuperar al arrancar con
+* OneWire_ListaArranca(), que la confirma con una pasada dirigida por dispositivo y solo recorre el arbol si el
+* bus ha cambiado. Las pasadas cuestan lo mismo que las de una busqueda; si la primera medida no puede esperar,
+* se usa OneWire_ListaRecupera(), se mide ( cada lectura con CRC ya confirma su dispositivo ) y se llama despues
+* a OneWire_ListaConfirma(). Si en el bus hay mas de ONEWIRE_LISTA_MAX dispositivos la lista queda desbordada
+* ( lDesbordada ), no se puede confirmar y cada arranque recorre el arbol. Formato: marca, numero de Id's, 7 bytes por Id ( el CRC se recalcula ) mas su dato y el
+* CRC16 de todo lo anterior, ONEWIRE_LISTA_BYTES en total. Para otra memoria se definen _OneWire_EepromLee() y
+* _OneWire_EepromEscribe() antes de incluir este fichero.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_LISTA
+#define _JSB1WIRE_LISTA
+
+/** @defgroup group17 Lista ordenada de dispositivos
+ *  @brief Id's con CRC comprobado y tabla ordenada con busqueda binaria
+ *  @{
+ */
+
+#ifndef ONEWIRE_LISTA_MAX
+#define ONEWIRE_LISTA_MAX			32										///< Id's que caben en la lista ( 254 como maximo )
+#endif
+
+#define ONEWIRE_LISTA_NINGUNO		0xFF									///< Indice devuelto si el Id no esta en la lista
+
+#define ONEWIRE_LISTA_MARCA			0x1D									///< Primer byte de una lista guardada
+#define ONEWIRE_LISTA_MARCA_DESBORDADA	0x1E								///< Primer byte de una lista guardada con lDesbordada
+#define ONEWIRE_LISTA_BYTES			(4 + 8 * (int16)ONEWIRE_LISTA_MAX)		///< EEPROM que ocupa una lista completa
+
+#ifdef ONEWIRE_SIM
+	#ifndef _OneWire_EepromLee
+		#define _OneWire_EepromLee(n)		OneWireSimEeprom[n]
+		#define _OneWire_EepromEscribe(n,c)	OneWireSimEeprom[n] = (c)
+	#endif
+#else
+	#ifndef _OneWire_EepromLee
+		#define _OneWire_EepromLee(n)		read_eeprom (n)
+		#define _OneWire_EepromEscribe(n,c)	write_eeprom (n, c)
+	#endif
+#endif
+
+/**
+* @brief Id de un dispositivo
+*/
+typedef union
+{
+	int8 aBytes[8];															///< Familia, numero de serie y CRC
+	int32 aPalabras[2];														///< Los mismos bytes, para comparar
+} OneWire_Rom;
+
+/**
+* @brief Lista de Id's ordenada
+*/
+typedef struct
+{
+	OneWire_Rom aRom[ONEWIRE_LISTA_MAX];
+	int8 aDato[ONEWIRE_LISTA_MAX];											///< Dato del llamador asociado a cada Id
+	int8 nDispositivos;
+	int1 lDesbordada;														///< En el bus hay mas dispositivos de los que caben
+} OneWire_Lista;
+
+int1 OneWire_RomCrea (OneWire_Rom* pRom, int8* aBytes);
+int1 OneWire_RomIgual (OneWire_Rom* pRom1, OneWire_Rom* pRom2);
+int1 OneWire_RomMenor (OneWire_Rom* pRom1, OneWire_Rom* pRom2);
+
+void OneWire_ListaInicia (OneWire_Lista* pLista);
+int8 OneWire_ListaLlena (OneWire_Lista* pLista);
+int8 OneWire_ListaBusca (OneWire_Lista* pLista, OneWire_Rom* pRom);
+int8 OneWire_ListaInserta (OneWire_Lista* pLista, OneWire_Rom* pRom, int8 nDato);
+int1 OneWire_ListaElimina (OneWire_Lista* pLista, OneWire_Rom* pRom);
+int8 OneWire_ListaFamilia (OneWire_Lista* pLista, int8 cFamilia, int8* pPrimero);
+void OneWire_ListaGuarda (OneWire_Lista* pLista, int16 nDireccion);
+int1 OneWire_ListaRecupera (OneWire_Lista* pLista, int16 nDireccion);
+int1 OneWire_ListaArranca (OneWire_Lista* pLista, int16 nDireccion);
+int1 OneWire_ListaConfirma (OneWire_Lista* pLista);
+
+int8 _OneWire_ListaPosicion (OneWire_Lista* pLista, OneWire_Rom* pRom);
+void _OneWire_ListaDatos (OneWire_Lista* pLista, int16 nDireccion);
+void _OneWire_ListaLeeRom (int16 nDireccion, OneWire_Rom* pRom);
+void _OneWire_ListaEscribe (int16 nDireccion, int8 cDato);
+
+/** @} */ // end of group17
+
+#include "jsb_1wire_lista.c"
+
+#endif
@@ -0,0 +1,89 @@
+/**
+******************************************************
+* @file JSB_1wire_Memoria.h
+* @brief Lectura y escritura de memorias EEPROM 1Wire ( DS2431 )
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* La lectura usa un solo Read Memory ( 0xF0 ) para cualquier rango: el dispositivo envia los bytes seguidos
+* hasta que el maestro da un reset, asi que un bloque de configuracion se lee sin volver a direccionar.
+* La escritura pasa por el scratchpad: Write Scratchpad ( 0x0F ) con su CRC16, Read Scratchpad ( 0xAA ) para
+* comprobar direccion, datos y CRC16, y Copy Scratchpad ( 0x55 ) con la autorizacion leida.
+*
+* OneWire_Memoria guarda ONEWIRE_MEMORIA_CACHE filas de un dispositivo. Las escrituras se acumulan en la cache
+* y se envian fila a fila completa con OneWire_MemoriaGuarda() ( o al necesitar el hueco ); las lecturas de
+* filas que estan en la cache no usan el bus.
+*
+* ONEWIRE_MEMORIA_FILA es el tamano del scratchpad: 8 en el DS2431, 32 en el DS28EC20.
+* Durante la copia ( ONEWIRE_MEMORIA_PROGRAMACION ms ) el bus no debe usarse; con alimentacion parasita hay que
+* activar el pull-up fuerte en ese tiempo.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_MEMORIA
+#define _JSB1WIRE_MEMORIA
+
+/** @defgroup group16 Memorias EEPROM
+ *  @brief Read Memory continuo y escritura por scratchpad con cache de filas
+ *  @{
+ */
+
+#ifndef ONEWIRE_MEMORIA_FILA
+#define ONEWIRE_MEMORIA_FILA			8								///< Bytes del scratchpad
+#endif
+
+#ifndef ONEWIRE_MEMORIA_CACHE
+#define ONEWIRE_MEMORIA_CACHE			4								///< Filas en la cache de cada dispositivo
+#endif
+
+#ifndef ONEWIRE_MEMORIA_PROGRAMACION
+#define ONEWIRE_MEMORIA_PROGRAMACION	10								///< Duracion de la copia del scratchpad ( ms )
+#endif
+
+#define ONEWIRE_MEMORIA_READ			0xF0							///< Comandos de funcion
+#define ONEWIRE_MEMORIA_WRITE_SCRATCHPAD	0x0F
+#define ONEWIRE_MEMORIA_READ_SCRATCHPAD	0xAA
+#define ONEWIRE_MEMORIA_COPY_SCRATCHPAD	0x55
+#define ONEWIRE_MEMORIA_COPIA_OK		0xAA							///< Lo que envia el dispositivo tras una copia correcta
+
+#define ONEWIRE_MEMORIA_LIBRE			0xFFFF							///< Fila de la cache sin usar
+#define ONEWIRE_MEMORIA_TRAMO			128								///< Bytes por OneWire_ReadBlock() en las lecturas largas
+
+/**
+* @brief Fila de la cache
+*/
+typedef struct
+{
+	int16 nDireccion;													///< Direccion de la fila, ONEWIRE_MEMORIA_LIBRE si no se usa
+	int8 aDatos[ONEWIRE_MEMORIA_FILA];
+	int1 lModificada;													///< Pendiente de escribir en el dispositivo
+	int16 nUso;															///< Ultimo acceso, para sustituir la fila menos usada
+} OneWire_MemoriaFila;
+
+/**
+* @brief Dispositivo de memoria con su cache
+*/
+typedef struct
+{
+	int8 aRom[8];
+	OneWire_MemoriaFila aFilas[ONEWIRE_MEMORIA_CACHE];
+	int16 nUso;															///< Contador de accesos
+} OneWire_Memoria;
+
+void OneWire_MemoriaInicia (OneWire_Memoria* pMemoria, int8* aRom);
+void OneWire_MemoriaLee (OneWire_Memoria* pMemoria, int16 nDireccion, int8* aDatos, int16 nBytes);
+int1 OneWire_MemoriaEscribe (OneWire_Memoria* pMemoria, int16 nDireccion, int8* aDatos, int16 nBytes);
+int1 OneWire_MemoriaGuarda (OneWire_Memoria* pMemoria);
+void OneWire_MemoriaDescarta (OneWire_Memoria* pMemoria);
+
+void OneWire_MemoriaLeeBloque (int8* aRom, int16 nDireccion, int8* aDatos, int16 nBytes);
+int1 OneWire_MemoriaEscribeFila (int8* aRom, int16 nDireccion, int8* aDatos);
+
+OneWire_MemoriaFila* _OneWire_MemoriaBusca (OneWire_Memoria* pMemoria, int16 nDireccion);
+OneWire_MemoriaFila* _OneWire_MemoriaHueco (OneWire_Memoria* pMemoria);
+
+/** @} */ // end of group16
+
+#include "jsb_1wire_memoria.c"
+
+#endif
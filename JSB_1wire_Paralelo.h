@@ -0,0 +1,75 @@
+/**
+******************************************************
+* @file JSB_1wire_Paralelo.h
+* @brief Hasta 8 buses 1Wire en los pines de un mismo puerto funcionando a la vez
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Cada bit del puerto es un bus independiente. Los slots se generan a la vez en todos los buses,
+* con una escritura del TRIS para el pulso bajo y una lectura del puerto para el muestreo, de forma
+* que el reset, los bytes y la busqueda de 8 buses cuestan el mismo tiempo que los de uno solo.
+*
+* Por defecto se usa el puerto B, que debe declararse con #use fast_io(B). ONEWIRE_PAR_MASCARA indica
+* los bits del puerto que son buses 1Wire. Para usar otro puerto se definen las macros
+* _OneWirePar_Bajo(), _OneWirePar_Libera(), _OneWirePar_Lee() y _OneWirePar_Inicia() antes de incluir
+* este fichero. Los tiempos son los del perfil activo ( OneWire_Perfil ), o las constantes ONEWIRE_STD_xxx con
+* ONEWIRE_TIEMPOS_FIJOS.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_PARALELO
+#define _JSB1WIRE_PARALELO
+
+/** @defgroup group11 Buses en paralelo
+ *  @brief Reset, bytes y busqueda simultaneos en los buses de un puerto
+ *  @{
+ */
+
+#ifndef ONEWIRE_PAR_MASCARA
+#define ONEWIRE_PAR_MASCARA			0xFF									///< Bits del puerto conectados a un bus
+#endif
+
+#ifdef ONEWIRE_SIM
+	#ifndef _OneWirePar_Bajo
+		#define _OneWirePar_Bajo(m)		OneWireSim_PuertoBajo (m)
+		#define _OneWirePar_Libera(m)	OneWireSim_PuertoLibera (m)
+		#define _OneWirePar_Lee()		OneWireSim_PuertoLee ()
+		#define _OneWirePar_Inicia()
+		#define _OneWirePar_DelayUs(n)	OneWireSim_PuertoDelayUs (n)
+	#endif
+#else
+	#ifndef _OneWirePar_Bajo
+		#define _OneWirePar_Bajo(m)		set_tris_b (get_tris_b () & ~(m))	///< Los pines pasan a salida con el latch a 0
+		#define _OneWirePar_Libera(m)	set_tris_b (get_tris_b () | (m))
+		#define _OneWirePar_Lee()		input_b ()
+		#define _OneWirePar_Inicia()	{ _OneWirePar_Libera (ONEWIRE_PAR_MASCARA); output_b (input_b () & ~ONEWIRE_PAR_MASCARA); }
+		#define _OneWirePar_DelayUs(n)	delay_us (n)
+	#endif
+#endif
+
+/**
+* @brief Estado de la busqueda en los buses del puerto
+*/
+typedef struct
+{
+	OneWire_Busqueda aBus[8];												///< Estado de la busqueda en cada bus
+	int8 cActivos;															///< Buses en los que la busqueda no ha terminado
+} OneWirePar_Busqueda;
+
+void OneWirePar_Inicia (void);
+int8 OneWirePar_Reset (int8 cBuses);
+void OneWirePar_Write (int8 cBuses, int8 cBits);
+int8 OneWirePar_LeeBit (int8 cBuses);
+void OneWirePar_SendByte (int8 cBuses, byte cDato);
+void OneWirePar_SendBytes (int8 cBuses, int8* aDatos);
+void OneWirePar_ReceiveByte (int8 cBuses, int8* aDatos);
+int8 OneWirePar_SearchFirst (OneWirePar_Busqueda* pBusqueda, int8 cBuses, int8* aRoms);
+int8 OneWirePar_SearchNext (OneWirePar_Busqueda* pBusqueda, int8* aRoms);
+
+int8 _OneWirePar_SearchPasada (OneWirePar_Busqueda* pBusqueda);
+
+/** @} */ // end of group11
+
+#include "jsb_1wire_paralelo.c"
+
+#endif
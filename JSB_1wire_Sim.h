@@ -0,0 +1,278 @@
+/**
+******************************************************
+* @file JSB_1wire_Sim.h
+* @brief Simulador en PC de un bus 1Wire con reloj virtual en microsegundos
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* El simulador sustituye al pin Pin1W cuando se compila con ONEWIRE_SIM. Modela el bus como un
+* AND cableado entre el maestro y cualquier numero de esclavos virtuales, los pulsos de presencia
+* y los slots de lectura y escritura. El tiempo no es real, avanza con cada _OneWire_DelayUs()
+* por lo que se puede medir exactamente el tiempo de bus que consume cada operacion.
+*
+* Compilacion en Linux:
+*
+*	gcc -DONEWIRE_SIM -o prueba prueba.c
+*
+* donde prueba.c incluye JSB_1wire.h
+*
+*******************************************************/
+#ifndef _JSB1WIRE_SIM
+#define _JSB1WIRE_SIM
+
+/** @defgroup group6 Simulador del bus
+ *  @brief Bus 1Wire virtual para ejecutar y medir la libreria en un PC
+ *  @{
+ */
+
+#define ONEWIRE_SIM_ESPERA_RESET	0										///< El esclavo no participa hasta el siguiente reset
+#define ONEWIRE_SIM_COMANDO_ROM		1										///< Recibiendo el comando ROM tras el reset
+#define ONEWIRE_SIM_READ_ROM		2										///< Enviando los 64 bits de la ROM
+#define ONEWIRE_SIM_MATCH_ROM		3										///< Recibiendo los 64 bits de la ROM a comparar
+#define ONEWIRE_SIM_SEARCH_ROM		4										///< Bit, complemento y bit del maestro por cada posicion
+#define ONEWIRE_SIM_FUNCION			5										///< Seleccionado, recibiendo comandos de funcion
+
+#define ONEWIRE_SIM_MAX_TX			160										///< Bytes que un esclavo puede tener pendientes de enviar ( memoria de un DS2431 )
+
+#define ONEWIRE_SIM_MAX_BUSES		8										///< Buses de un puerto virtual ( uno por bit )
+
+#define ONEWIRE_SIM_CONVERSION		750000									///< Duracion de la conversion de un DS18B20 a 12 bits ( us )
+
+#define ONEWIRE_SIM_DS2431_MEMORIA	144										///< 128 bytes de datos y 16 de registros
+#define ONEWIRE_SIM_DS2431_PROGRAMA	10000									///< Duracion de la copia del scratchpad ( us )
+
+#define ONEWIRE_SIM_EEPROM			1024									///< Bytes de la EEPROM virtual del PIC
+
+/**
+* @brief Tiempos de respuesta de los esclavos virtuales ( us )
+*/
+typedef struct
+{
+	int32 nResetMin;														///< Pulso bajo minimo que los esclavos reconocen como reset
+	int32 nPresenciaEspera;													///< Tiempo desde el fin del reset hasta el inicio del pulso de presencia
+	int32 nPresenciaAncho;													///< Duracion del pulso de presencia
+	int32 nMuestreo;														///< Instante, desde el flanco de bajada, en el que el esclavo lee el bit del maestro
+	int32 nMantenimiento;													///< Tiempo que el esclavo mantiene el bus a 0 al enviar un 0
+} OneWireSim_Tiempos;
+
+typedef struct OneWireSim_Esclavo OneWireSim_Esclavo;
+
+/**
+* @brief Funcion que atiende los bytes de funcion recibidos por un esclavo seleccionado
+*/
+typedef void (*OneWireSim_Funcion)(OneWireSim_Esclavo* pEsclavo, int8 cDato);
+
+/**
+* @brief Esclavo virtual
+*/
+struct OneWireSim_Esclavo
+{
+	int8 aRom[8];															///< Id del esclavo
+	int1 lConectado;														///< 0 si se ha desconectado del bus
+	int1 lAlarma;															///< Responde a la busqueda condicional ( 0xEC )
+	int8 nEstado;															///< Estado del protocolo ROM ( ONEWIRE_SIM_xxx )
+	int8 nBit;																///< Bit dentro del estado actual
+	int8 nFase;																///< En Search ROM, 0 bit, 1 complemento, 2 bit del maestro
+	int8 cDato;																///< Byte en recepcion
+	int1 lOverdrive;														///< El esclavo esta en overdrive
+	int1 lPasaOverdrive;													///< Pasara a overdrive en el siguiente slot
+	int1 lRC;																///< Ultimo seleccionado con Match ROM o Search ROM, responde a Resume ( 0xA5 )
+	int8 aTx[ONEWIRE_SIM_MAX_TX];											///< Bytes pendientes de enviar en modo funcion
+	int16 nTxBits;															///< Bits pendientes de enviar
+	int16 nTxPos;															///< Siguiente bit a enviar
+	int64 nBajoDesde;														///< Intervalo en el que el esclavo mantiene el bus a 0
+	int64 nBajoHasta;
+	int64 nMuestreo;														///< Instante en el que leera el bit del maestro ( 0 si no hay )
+	int64 nOcupadoHasta;													///< En modo funcion responde 0 a los slots de lectura hasta este instante
+	int64 nTxDesde;															///< No empieza a enviar aTx hasta este instante
+	OneWireSim_Funcion pfFuncion;											///< Atiende los comandos de funcion ( puede ser NULL )
+	void* pDatos;															///< Datos propios del modelo de dispositivo
+};
+
+/**
+* @brief Estado global del bus virtual
+*/
+typedef struct
+{
+	int64 nTiempo;															///< Reloj virtual en us
+	int1 lMaestroBajo;														///< El maestro pone el bus a 0
+	int64 nMaestroBajoDesde;												///< Inicio del ultimo pulso bajo del maestro
+	int64 nMaestroLibreDesde;												///< Fin del ultimo pulso bajo del maestro
+	int32 nSubida;															///< Tiempo que tarda el bus en volver a 1 al liberarlo ( cable largo ), 0 por defecto
+	OneWireSim_Esclavo* aEsclavos;
+	int32 nEsclavos;
+	OneWireSim_Tiempos stTiempos;											///< Tiempos de los esclavos en velocidad estandar
+	OneWireSim_Tiempos stTiemposOD;											///< Tiempos de los esclavos en overdrive
+	int32 nResets;															///< Pulsos de reset reconocidos por los esclavos
+	int32 nSlots;															///< Slots de bit iniciados por el maestro
+	int32 nViolaciones;														///< Slots iniciados con el bus todavia a 0
+	int32 nLecturaFallida;													///< Cuenta atras de lecturas del maestro, la que llega a 0 lee un 1 ( ruido ), 0 desactivado
+	int64 nTimer;															///< Instante en el que vence el temporizador virtual ( 0 si esta parado )
+	void (*pfTimer)(void);													///< Rutina de interrupcion del temporizador virtual
+} OneWireSim_Bus;
+
+extern OneWireSim_Bus OneWireSim;
+
+/**
+* @brief Puerto virtual con un bus independiente en cada bit
+*
+* Solo uno de los buses esta cargado en OneWireSim en cada momento, el resto se guarda en aBuses
+*/
+typedef struct
+{
+	OneWireSim_Bus aBuses[ONEWIRE_SIM_MAX_BUSES];
+	int8 nBuses;															///< Buses del puerto ( bits 0 a nBuses-1 )
+	int8 nActivo;															///< Bus cargado en OneWireSim
+} OneWireSim_Puerto;
+
+extern OneWireSim_Puerto OneWireSimPuerto;
+
+/**
+* @brief Interrupciones del PIC virtual
+*
+* Con nRutina distinto de 0 cada espera con las interrupciones habilitadas se alarga nRutina us, como si una
+* rutina de interrupcion entrara justo al empezar la espera. Asi se comprueba que slots aguantan las interrupciones
+*/
+typedef struct
+{
+	int1 lBloqueadas;														///< La libreria ha enmascarado las interrupciones
+	int64 nDesde;															///< Inicio del bloqueo actual
+	int32 nBloqueoMax;														///< Bloqueo mas largo ( us )
+	int32 nBloqueos;														///< Bloqueos realizados
+	int32 nRutina;															///< Duracion de la rutina de interrupcion ( us ), 0 ninguna
+} OneWireSim_Interrupciones;
+
+extern OneWireSim_Interrupciones OneWireSimInt;
+
+extern int8 OneWireSimEeprom[ONEWIRE_SIM_EEPROM];						///< EEPROM del PIC, OneWireSim_Inicia() no la borra ( se conserva entre arranques )
+
+/**
+* @brief Datos del modelo de DS18B20 ( pDatos del esclavo )
+*/
+typedef struct
+{
+	int16 nTemperatura;														///< Temperatura que mide el sensor ( 1/16 de grado, complemento a 2 )
+	int16 nRegistro;														///< Temperatura en el scratchpad, la de la ultima conversion
+	int32 nConversion;														///< Duracion de la conversion en us
+	int32 nConversiones;													///< Comandos Convert T recibidos
+	int32 nLecturas;														///< Comandos Read Scratchpad recibidos
+	int8 aConfig[3];														///< TH, TL y configuracion del scratchpad
+	int8 nEscritura;														///< Bytes de Write Scratchpad que faltan por recibir
+	int32 nResets;															///< Valor de OneWireSim.nResets al recibir Write Scratchpad
+	int32 nEscrituras;														///< Comandos Write Scratchpad completos
+} OneWireSim_DS18B20;
+
+/**
+* @brief Datos del modelo de DS2431 ( pDatos del esclavo )
+*/
+typedef struct
+{
+	int8 aMemoria[ONEWIRE_SIM_DS2431_MEMORIA];
+	int8 aScratchpad[8];
+	int16 nTA;																///< Direccion del scratchpad ( TA1 y TA2 )
+	int8 cES;																///< Offset final y flags PF ( 0x20 ) y AA ( 0x80 )
+	int8 nFase;																///< Byte esperado dentro del comando actual ( 0 comando )
+	int8 cComando;
+	int8 aRecibidos[3];														///< TA1, TA2 y ES recibidos
+	int32 nResets;															///< Valor de OneWireSim.nResets al recibir el ultimo comando
+	int64 nProgramaHasta;													///< Fin de la ultima copia del scratchpad
+	int32 nLecturasMemoria;													///< Comandos Read Memory recibidos
+	int32 nCopias;															///< Copias del scratchpad realizadas
+	int32 nErroresCopia;													///< Copias rechazadas o con el bus usado durante la programacion
+} OneWireSim_DS2431;
+
+void OneWireSim_Inicia (void);
+void OneWireSim_Termina (void);
+OneWireSim_Esclavo* OneWireSim_AnadeEsclavo (int8* aRom);
+void OneWireSim_Desconecta (int32 nEsclavo);
+void OneWireSim_Envia (OneWireSim_Esclavo* pEsclavo, int8* aDatos, int8 nBytes);
+void OneWireSim_RomConCRC (int8 cFamilia, int64 nSerie, int8* aRom);
+OneWireSim_Esclavo* OneWireSim_AnadeDS18B20 (int8* aRom, int16 nTemperatura);
+OneWireSim_Esclavo* OneWireSim_AnadeDS2431 (int8* aRom);
+
+void OneWireSim_PinLow (void);
+void OneWireSim_PinHigh (void);
+void OneWireSim_PinFloat (void);
+int1 OneWireSim_PinRead (void);
+void OneWireSim_DelayUs (int32 nUs);
+void OneWireSim_Bloquea (void);
+void OneWireSim_Desbloquea (void);
+
+void OneWireSim_TimerArma (int32 nUs, void (*pfTimer)(void));
+void OneWireSim_TimerPara (void);
+int1 OneWireSim_Espera (void);
+
+#ifdef ONEWIRE_UART
+/**
+* @brief Puerto serie virtual conectado al bus por un pseudo-terminal
+*
+* La libreria usa nUart como si fuera la UART del PIC. Al otro lado, en nMaestro, cada byte recibido se convierte
+* en niveles del bus virtual bit a bit con la velocidad configurada y se devuelve el eco con el AND cableado
+*/
+typedef struct
+{
+	int nMaestro;															///< Lado del pseudo-terminal que atiende el bus virtual
+	int nUart;																///< Lado del pseudo-terminal que usa la libreria
+	int32 nTramas;															///< Bytes convertidos en el bus virtual
+	int1 lAbierta;															///< OneWireSim_UartAbre() ha creado el pseudo-terminal
+} OneWireSim_Serie;
+
+extern OneWireSim_Serie OneWireSimSerie;
+
+void OneWireSim_UartAbre (void);
+void OneWireSim_UartCierra (void);
+void OneWireSim_UartBaudios (int32 nBaudios);
+void OneWireSim_UartEnvia (int8 cDato);
+int8 OneWireSim_UartRecibe (void);
+#endif
+
+#ifdef ONEWIRE_DS2482
+#define ONEWIRE_SIM_I2C_BYTE		23										///< Duracion de un byte I2C a 400 kHz ( 9 ciclos de reloj )
+#define ONEWIRE_SIM_I2C_CONDICION	3										///< Duracion de una condicion de start o stop
+
+/**
+* @brief DS2482 virtual conectado al bus
+*
+* Se modela a nivel de registros: la libreria le habla con bytes I2C y el puente ejecuta cada comando 1 Wire
+* sobre el bus virtual con sus propios tiempos. Los comandos terminan en el mismo byte I2C que los lanza, el
+* reloj virtual avanza lo que tarda el comando en el bus
+*/
+typedef struct
+{
+	int8 cEstado;															///< Registro de estado
+	int8 cDato;																///< Registro de datos ( ultimo Read Byte )
+	int8 cConfig;															///< Registro de configuracion ( nibble bajo )
+	int8 cPuntero;															///< Registro que se devuelve en las lecturas
+	int8 cComando;															///< Comando recibido en la transaccion actual
+	int8 nBytes;															///< Bytes recibidos desde el ultimo start
+	int1 lLectura;															///< La transaccion actual es de lectura
+	int1 lDireccionado;														///< La direccion de la transaccion es la del puente
+	int32 nComandos;														///< Comandos ejecutados
+	int32 nBytesI2C;														///< Bytes transferidos por el bus I2C
+} OneWireSim_Puente;
+
+extern OneWireSim_Puente OneWireSimPuente;
+
+void OneWireSim_I2CInicio (void);
+int1 OneWireSim_I2CEscribe (int8 cDato);
+int8 OneWireSim_I2CLee (int1 lAck);
+void OneWireSim_I2CParada (void);
+#endif
+
+void OneWireSim_PuertoInicia (int8 nBuses);
+void OneWireSim_PuertoSelecciona (int8 nBus);
+void OneWireSim_PuertoBajo (int8 cMascara);
+void OneWireSim_PuertoLibera (int8 cMascara);
+int8 OneWireSim_PuertoLee (void);
+void OneWireSim_PuertoDelayUs (int32 nUs);
+
+/** @} */ // end of group6
+
+#ifdef ONEWIRE_DS2482
+	#include "JSB_1wire_DS2482.h"										//Registros y comandos que usa el DS2482 virtual
+#endif
+
+#include "jsb_1wire_sim.c"
+
+#endif
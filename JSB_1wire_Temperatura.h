@@ -0,0 +1,46 @@
+/**
+******************************************************
+* @file JSB_1wire_Temperatura.h
+* @brief Lectura de todos los sensores de temperatura del bus 1Wire con una sola conversion
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Un Skip ROM con Convert T ( 0x44 ) hace convertir a la vez a todos los sensores. El final de la conversion
+* se detecta con slots de lectura, los sensores responden 0 mientras convierten, en lugar de esperar los 750 ms
+* del peor caso. Despues se lee el scratchpad de cada sensor del inventario con Match ROM y se comprueba su CRC.
+*
+* Los sensores deben estar alimentados externamente, en modo parasito necesitan el pull-up fuerte durante
+* la conversion y no pueden responder a los slots de lectura.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_TEMPERATURA
+#define _JSB1WIRE_TEMPERATURA
+
+#include "JSB_1wire_Inventario.h"
+
+/** @defgroup group10 Sensores de temperatura
+ *  @brief Conversion simultanea y lectura de los DS18B20, DS1822 y DS1820 del bus
+ *  @{
+ */
+
+#ifndef ONEWIRE_TEMP_ESPERA_MAX
+#define ONEWIRE_TEMP_ESPERA_MAX		1000									///< Tiempo maximo de conversion en ms
+#endif
+
+#define ONEWIRE_TEMP_CONVERT		0x44									///< Comandos de funcion
+#define ONEWIRE_TEMP_READ_SCRATCHPAD	0xBE
+#define ONEWIRE_TEMP_WRITE_SCRATCHPAD	0x4E								///< Seguido de TH, TL y configuracion
+
+#define ONEWIRE_TEMP_ERROR			0x8000									///< Lectura no valida ( fuera del rango de cualquier sensor )
+
+int1 OneWire_TempConvierte (void);
+int1 OneWire_TempEsperaFin (void);
+int1 OneWire_TempLee (int8* aRom, int16* pTemperatura);
+int8 OneWire_TempMuestrea (OneWire_Inventario* pInventario, int16* aTemperaturas);
+
+/** @} */ // end of group10
+
+#include "jsb_1wire_temperatura.c"
+
+#endif
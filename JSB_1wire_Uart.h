@@ -0,0 +1,73 @@
+/**
+******************************************************
+* @file JSB_1wire_Uart.h
+* @brief Bus 1Wire generado con la UART del PIC
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Se activa definiendo ONEWIRE_UART antes de incluir JSB_1wire.h. TX y RX se unen al bus con un transceptor
+* ( o TX en colector abierto ) de forma que RX recibe el eco del bus con el AND cableado de los esclavos.
+*
+* A 115200 baudios cada byte de la UART es un slot: 0xFF es un 1 o un slot de lectura ( el pulso bajo es el bit
+* de start ) y 0x00 es un 0. Si en un slot de lectura algun esclavo pone el bus a 0 el eco ya no es 0xFF.
+* A 9600 baudios el byte 0xF0 es un pulso de reset de 520 us y el pulso de presencia cambia el eco.
+*
+* Los tiempos los genera la UART, no dependen de delay_us() ni de las interrupciones. Los bytes y bloques se
+* envian encadenados: mientras se espera el eco de un slot ya se esta enviando el siguiente. Solo se admite
+* velocidad estandar ( en overdrive harian falta 1 Mbaudio ).
+*
+* La UART se declara en el programa con #use rs232(UART1, baud=115200, bits=8, parity=N). Para otra UART
+* se definen las macros _OneWireUart_Baudios(), _OneWireUart_Envia() y _OneWireUart_Recibe().
+* En el PC ( ONEWIRE_SIM ) la UART es un pseudo-terminal conectado al bus virtual.
+*
+*******************************************************/
+#ifndef _JSB1WIRE_UART
+#define _JSB1WIRE_UART
+
+/** @defgroup group12 Bus por UART
+ *  @brief Slots del bus generados por la UART
+ *  @{
+ */
+
+#ifdef ONEWIRE_ASYNC
+	#error ONEWIRE_UART y ONEWIRE_ASYNC no pueden usarse a la vez
+#endif
+
+#define ONEWIRE_UART_BAUDIOS_RESET		9600							///< Velocidad para el pulso de reset
+#define ONEWIRE_UART_BAUDIOS_SLOT		115200							///< Velocidad para los slots de bit
+#define ONEWIRE_UART_RESET				0xF0							///< Byte que genera el pulso de reset
+
+#ifndef ONEWIRE_UART_BUFFER
+#define ONEWIRE_UART_BUFFER				64								///< Slots por transferencia en los bloques ( 8 bytes )
+#endif
+
+#ifdef ONEWIRE_SIM
+	#ifndef _OneWireUart_Baudios
+		#define _OneWireUart_Inicia()	OneWireSim_UartAbre ()
+		#define _OneWireUart_Baudios(n)	OneWireSim_UartBaudios (n)
+		#define _OneWireUart_Envia(c)	OneWireSim_UartEnvia (c)
+		#define _OneWireUart_Recibe()	OneWireSim_UartRecibe ()
+	#endif
+#else
+	#ifndef _OneWireUart_Baudios
+		#define _OneWireUart_Inicia()
+		#define _OneWireUart_Baudios(n)	set_uart_speed (n)
+		#define _OneWireUart_Envia(c)	putc (c)
+		#define _OneWireUart_Recibe()	getc ()
+	#endif
+#endif
+
+void OneWire_UartInicia (void);
+int1 OneWire_UartReset (void);
+void OneWire_UartTransfiere (int8* aSlots, int8 nSlots);
+int8 OneWire_UartBits (int8 cDato, int8 nBits);
+void OneWire_UartBloque (int8* aDatos, int8 nBytes, int1 lLectura);
+
+void _OneWire_UartBaudios (int32 nBaudios);
+
+/** @} */ // end of group12
+
+#include "jsb_1wire_uart.c"
+
+#endif
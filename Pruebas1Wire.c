@@ -0,0 +1,937 @@
+/**
+******************************************************
+* @file Pruebas1Wire.c
+* @brief Pruebas de regresion de la libreria 1Wire en PC
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+* Se compila con el simulador del bus, una vez por cada forma de generar el bus:
+*
+*	gcc -o pruebas Pruebas1Wire.c
+*	gcc -DONEWIRE_ASYNC -o pruebas_async Pruebas1Wire.c
+*	gcc -DONEWIRE_UART -o pruebas_uart Pruebas1Wire.c
+*	gcc -DONEWIRE_DS2482 -o pruebas_ds2482 Pruebas1Wire.c
+*
+* Comprueba el CRC, la busqueda ( normal, por familia, de alarmas y con el bus vacio ), Match ROM con Resume, la
+* lectura de temperaturas, el inventario, la lista guardada en EEPROM, la memoria de un DS2431, la cola de
+* transacciones, la calibracion ( solo cuando el PIC genera los tiempos ) y la UART sobre el pseudo-terminal.
+*
+* Cada comprobacion que falla imprime una linea ERROR con su nombre. El programa devuelve el numero de fallos,
+* 0 si todo es correcto
+*
+*******************************************************/
+#ifndef ONEWIRE_SIM
+#define ONEWIRE_SIM
+#endif
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE															//Antes de cualquier #include, lo necesita el puerto serie virtual
+#endif
+#include "JSB_1wire.h"
+#include "JSB_1wire_Cola.h"
+#include "JSB_1wire_Paralelo.h"
+#if !defined (ONEWIRE_UART) && !defined (ONEWIRE_DS2482) && !defined (ONEWIRE_TIEMPOS_FIJOS)
+	#include "JSB_1wire_Calibracion.h"
+#endif
+
+#define PRUEBA_SENSORES		12												///< DS18B20 del bus de las pruebas de modulos
+#define PRUEBA_BUSES		4												///< Buses del puerto virtual de Prueba_Paralelo()
+
+int16 Prueba_nComprobaciones = 0;
+int16 Prueba_nFallos = 0;
+int8 Prueba_aRoms[PRUEBA_SENSORES * 8];										///< Id's de los sensores creados por _Prueba_Sensores()
+int8 Prueba_aFunciones[4];													///< Comandos de funcion 0x11 recibidos por cada esclavo de Prueba_Resume()
+
+/**
+******************************************************
+* @brief Anota el resultado de una comprobacion
+*
+* @param lCorrecto Resultado de la comprobacion
+* @param sNombre Nombre que se imprime si falla
+*/
+void _Prueba_Comprueba (int1 lCorrecto, char* sNombre)
+{
+	Prueba_nComprobaciones++;
+	if (!lCorrecto)
+	{
+		printf ("ERROR: %s\n", sNombre);
+		Prueba_nFallos++;
+	}
+}
+/**
+******************************************************
+* @brief Crea un bus virtual con nSensores DS18B20, el sensor n a n grados
+*
+* Los Id's quedan en Prueba_aRoms
+*/
+void _Prueba_Sensores (int8 nSensores)
+{
+	int8 nSensor;
+
+	OneWireSim_Termina ();
+	OneWireSim_Inicia ();
+	for (nSensor = 0; nSensor < nSensores; nSensor++)
+	{
+		OneWireSim_RomConCRC (0x28, 0x1000 + nSensor * 0x0101, &Prueba_aRoms[nSensor * 8]);
+		OneWireSim_AnadeDS18B20 (&Prueba_aRoms[nSensor * 8], (int16)(nSensor * 16));
+	}
+}
+/**
+******************************************************
+* @brief Recorre el bus con OneWire_SearchNext() desde una busqueda ya iniciada
+*
+* @return Dispositivos encontrados, cada uno con el CRC comprobado y de la familia cFamilia si no es 0
+*/
+int16 _Prueba_Recorre (OneWire_Busqueda* pBusqueda, int1 lEncontrado, int8* aRom, int8 cFamilia)
+{
+	int16 nEncontrados;
+
+	nEncontrados = 0;
+	for (; lEncontrado; lEncontrado = OneWire_SearchNext (pBusqueda, aRom))
+	{
+		if (OneWire_CRCBloque (0, aRom, 8) == 0 && (cFamilia == 0 || aRom[0] == cFamilia))
+		{
+			nEncontrados++;
+		}
+	}
+	return nEncontrados;
+}
+/**
+******************************************************
+* @brief CRC 8 y CRC 16 con valores conocidos
+*/
+void Prueba_CRC (void)
+{
+	static int8 aRom[8] = {0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xA2};		//Ejemplo de la nota de aplicacion 27 de Maxim
+	static int8 aTexto[9] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	int8 nByte, nCRC;
+	int16 nCRC16;
+
+	nCRC = 0;
+	for (nByte = 0; nByte < 7; nByte++)
+	{
+		nCRC = OneWire_CRC (nCRC, aRom[nByte]);
+	}
+	_Prueba_Comprueba (nCRC == 0xA2, "crc.byte");
+	_Prueba_Comprueba (OneWire_CRCBloque (0, aRom, 8) == 0, "crc.bloque");
+	aRom[3] ^= 0x10;
+	_Prueba_Comprueba (OneWire_CRCBloque (0, aRom, 8) != 0, "crc.bloque_erroneo");
+	aRom[3] ^= 0x10;
+
+	nCRC16 = 0;
+	for (nByte = 0; nByte < 9; nByte++)
+	{
+		nCRC16 = OneWire_CRC16 (nCRC16, aTexto[nByte]);
+	}
+	_Prueba_Comprueba (nCRC16 == 0xBB3D, "crc16.valor");
+	nCRC16 = OneWire_CRC16 (nCRC16, 0xC2);									//El dispositivo envia 0xBB3D invertido
+	nCRC16 = OneWire_CRC16 (nCRC16, 0x44);
+	_Prueba_Comprueba (nCRC16 == ONEWIRE_CRC16_RESIDUO, "crc16.residuo");
+}
+/**
+******************************************************
+* @brief Comprueba que un Id corresponde a un esclavo conectado al bus virtual
+*/
+int1 _Prueba_Conectado (int8* aRom)
+{
+	int32 nEsclavo;
+
+	for (nEsclavo = 0; nEsclavo < OneWireSim.nEsclavos; nEsclavo++)
+	{
+		if (OneWireSim.aEsclavos[nEsclavo].lConectado && memcmp (OneWireSim.aEsclavos[nEsclavo].aRom, aRom, 8) == 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+/**
+******************************************************
+* @brief Busqueda con una lectura falsa ( ruido ) en distintas posiciones
+*
+* Cada pasada que falla se repite desde el estado guardado. Las que han necesitado reintentos deben encontrar
+* todos los dispositivos, y ninguna puede dar un Id que no este en el bus. El ruido en el pulso de presencia o en
+* el primer bit termina la busqueda sin reintentos, por eso se recorren varias posiciones
+*/
+void _Prueba_BusquedaRuido (void)
+{
+	OneWire_Busqueda stBusqueda;
+	int8 aRom[8];
+	int16 nLectura, nEncontrados, nReintentadas, nIncompletas, nExtranos;
+	int1 lEncontrado;
+
+	nReintentadas = 0;
+	nIncompletas = 0;
+	nExtranos = 0;
+	for (nLectura = 50; nLectura < 3000; nLectura += 61)
+	{
+		OneWireSim.nLecturaFallida = nLectura;
+		nEncontrados = 0;
+		for (lEncontrado = OneWire_SearchFirst (&stBusqueda, aRom); lEncontrado; lEncontrado = OneWire_SearchNext (&stBusqueda, aRom))
+		{
+			if (_Prueba_Conectado (aRom))
+			{
+				nEncontrados++;
+			}else{
+				nExtranos++;
+			}
+		}
+		if (stBusqueda.nReintentos > 0)
+		{
+			nReintentadas++;
+			if (nEncontrados != OneWireSim.nEsclavos)
+			{
+				nIncompletas++;
+			}
+		}
+	}
+	OneWireSim.nLecturaFallida = 0;
+#ifndef ONEWIRE_UART
+	//Con UART un bit solo vale 1 si todo el eco es 0xFF, y una muestra falsa no llega a cambiarlo
+	_Prueba_Comprueba (nReintentadas > 0, "busqueda.ruido_reintentos");
+#endif
+	_Prueba_Comprueba (nIncompletas == 0, "busqueda.ruido_todos");
+	_Prueba_Comprueba (nExtranos == 0, "busqueda.ruido_sin_extranos");
+}
+/**
+******************************************************
+* @brief Busqueda completa, por familia y de alarmas, cuenta, SearchROM y verificacion de Id's
+*/
+void Prueba_Busqueda (void)
+{
+	static const int8 aFamilias[4] = {0x28, 0x10, 0x28, 0x3A};
+	static const int8 aFin[8] = {0, 0, 0, 0, 0, 0, 0, 0};				//Marca de fin de OneWire_SearchROM()
+	OneWire_Busqueda stBusqueda;
+	OneWireSim_Esclavo* pEsclavo;
+	int8 aRom[8];
+	int8* aRoms;
+	int16 nDispositivo, nCorrectos;
+	int32 nResets;
+
+	OneWireSim_Termina ();
+	OneWireSim_Inicia ();
+	nResets = OneWireSim.nResets;
+	_Prueba_Comprueba (!OneWire_SearchFirst (&stBusqueda, aRom), "busqueda.vacio");
+	_Prueba_Comprueba (OneWireSim.nResets - nResets == 1, "busqueda.vacio_un_reset");
+	aRoms = OneWire_SearchROM ();
+	_Prueba_Comprueba (aRoms != NULL && memcmp (aRoms, aFin, 8) == 0, "busqueda.searchrom_vacio");
+	free (aRoms);
+
+	for (nDispositivo = 0; nDispositivo < 40; nDispositivo++)				//Mas de 32 para SearchROM
+	{
+		OneWireSim_RomConCRC (aFamilias[nDispositivo & 3], 0x5A5A00 + nDispositivo * 0x010203, aRom);
+		pEsclavo = OneWireSim_AnadeEsclavo (aRom);
+		pEsclavo->lAlarma = (nDispositivo % 10 == 3);
+	}
+	_Prueba_Comprueba (_Prueba_Recorre (&stBusqueda, OneWire_SearchFirst (&stBusqueda, aRom), aRom, 0) == 40, "busqueda.completa");
+	_Prueba_Comprueba (OneWire_CuentaDispositivos () == 40, "busqueda.cuenta");
+	_Prueba_Comprueba (_Prueba_Recorre (&stBusqueda, OneWire_SearchFamilia (&stBusqueda, 0x28, aRom), aRom, 0x28) == 20, "busqueda.familia");
+	_Prueba_Comprueba (_Prueba_Recorre (&stBusqueda, OneWire_SearchFamilia (&stBusqueda, 0x05, aRom), aRom, 0x05) == 0, "busqueda.familia_ausente");
+	_Prueba_Comprueba (_Prueba_Recorre (&stBusqueda, OneWire_AlarmSearchFirst (&stBusqueda, aRom), aRom, 0) == 4, "busqueda.alarmas");
+
+	aRoms = OneWire_SearchROM ();
+	nCorrectos = 0;
+	for (nDispositivo = 0; nDispositivo < 40; nDispositivo++)
+	{
+		if (OneWire_CRCBloque (0, &aRoms[nDispositivo * 8], 8) == 0)
+		{
+			nCorrectos++;
+		}
+	}
+	_Prueba_Comprueba (nCorrectos == 40, "busqueda.searchrom");
+	_Prueba_Comprueba (memcmp (&aRoms[40 * 8], aFin, 8) == 0, "busqueda.searchrom_fin");
+	_Prueba_Comprueba (OneWire_Verifica (aRoms) == ONEWIRE_VERIFICA_PRESENTE, "verifica.presente");
+	OneWireSim_Desconecta (0);
+	_Prueba_Comprueba (OneWire_Verifica (OneWireSim.aEsclavos[0].aRom) == ONEWIRE_VERIFICA_AUSENTE, "verifica.ausente");
+	free (aRoms);
+
+	for (nDispositivo = 0; nDispositivo < 40; nDispositivo++)
+	{
+		OneWireSim.aEsclavos[nDispositivo].lAlarma = 0;
+	}
+	nResets = OneWireSim.nResets;
+	_Prueba_Comprueba (!OneWire_AlarmSearchFirst (&stBusqueda, aRom), "busqueda.sin_alarmas");
+	_Prueba_Comprueba (OneWireSim.nResets - nResets == 1, "busqueda.sin_alarmas_un_reset");
+
+	_Prueba_Sensores (PRUEBA_SENSORES);
+	_Prueba_BusquedaRuido ();
+}
+/**
+******************************************************
+* @brief Cuenta los comandos de funcion 0x11 que recibe cada esclavo de Prueba_Resume()
+*/
+void _Prueba_Funcion (OneWireSim_Esclavo* pEsclavo, int8 cDato)
+{
+	if (cDato == 0x11)
+	{
+		Prueba_aFunciones[pEsclavo->aRom[1]]++;
+	}
+}
+/**
+******************************************************
+* @brief Direcciona un esclavo, le envia el comando 0x11 y devuelve los slots usados
+*/
+int32 _Prueba_Direcciona (int8* aRom)
+{
+	int32 nSlots;
+
+	nSlots = OneWireSim.nSlots;
+	OneWire_MatchROM (aRom);
+	OneWire_SendByte (0x11);
+	return OneWireSim.nSlots - nSlots;
+}
+/**
+******************************************************
+* @brief Match ROM, y Resume al repetir el mismo dispositivo de una familia que lo admite
+*/
+void Prueba_Resume (void)
+{
+	int8 aRoms[3][8];
+	int8 nEsclavo;
+	int32 nCompleto, nResume;
+
+	OneWireSim_Termina ();
+	OneWireSim_Inicia ();
+	for (nEsclavo = 0; nEsclavo < 3; nEsclavo++)							//Dos DS2431 y un DS18B20, aRom[1] es el indice
+	{
+		OneWireSim_RomConCRC (nEsclavo == 2 ? 0x28 : 0x2D, nEsclavo, aRoms[nEsclavo]);
+		OneWireSim_AnadeEsclavo (aRoms[nEsclavo])->pfFuncion = _Prueba_Funcion;
+		Prueba_aFunciones[nEsclavo] = 0;
+	}
+	nCompleto = _Prueba_Direcciona (aRoms[0]);
+	nResume = _Prueba_Direcciona (aRoms[0]);
+	_Prueba_Comprueba (nResume + 64 == nCompleto, "resume.mismo_dispositivo");
+	_Prueba_Comprueba (_Prueba_Direcciona (aRoms[1]) == nCompleto, "resume.otro_dispositivo");
+	OneWire_SkipROM ();
+	_Prueba_Comprueba (_Prueba_Direcciona (aRoms[1]) == nCompleto, "resume.tras_skip");
+	_Prueba_Direcciona (aRoms[2]);
+	_Prueba_Comprueba (_Prueba_Direcciona (aRoms[2]) == nCompleto, "resume.familia_sin_resume");
+	_Prueba_Comprueba (Prueba_aFunciones[0] == 2 && Prueba_aFunciones[1] == 2 && Prueba_aFunciones[2] == 2, "resume.comandos");
+}
+/**
+******************************************************
+* @brief Lectura de temperaturas, inventario con altas y bajas y lista guardada en EEPROM
+*/
+void Prueba_Inventario (void)
+{
+	static OneWire_Inventario stInventario;
+	static OneWire_Lista stLista;
+	static int16 aTemperaturas[ONEWIRE_INVENTARIO_MAX];
+	OneWire_Rom stRom;
+	int8 aRom[8], nDispositivo, nCorrectas;
+	int16 nTemperatura;
+
+	_Prueba_Sensores (PRUEBA_SENSORES);
+	OneWire_InventarioInicia (&stInventario);
+	_Prueba_Comprueba (OneWire_InventarioActualiza (&stInventario) == PRUEBA_SENSORES, "inventario.altas");
+	_Prueba_Comprueba (OneWire_InventarioActualiza (&stInventario) == 0 && !stInventario.lBusqueda, "inventario.estable");
+	OneWireSim_Desconecta (5);
+	_Prueba_Comprueba (OneWire_InventarioActualiza (&stInventario) == 1 && stInventario.nBajas == 1, "inventario.baja");
+	OneWireSim_RomConCRC (0x28, 0xAB0010, aRom);							//Entre los sensores 0 y 8 en el orden de la busqueda
+	OneWireSim_AnadeDS18B20 (aRom, 99 * 16);
+	_Prueba_Comprueba (OneWire_InventarioActualiza (&stInventario) == 1 && stInventario.nAltas == 1, "inventario.alta");
+	_Prueba_Comprueba (OneWire_InventarioBusca (&stInventario, aRom) != ONEWIRE_INVENTARIO_NINGUNO, "inventario.busca");
+
+	_Prueba_Comprueba (OneWire_TempMuestrea (&stInventario, aTemperaturas) == PRUEBA_SENSORES, "temperatura.muestrea");
+	nCorrectas = 0;
+	for (nDispositivo = 0; nDispositivo < PRUEBA_SENSORES; nDispositivo++)
+	{
+		if (nDispositivo != 5 && OneWire_TempLee (&Prueba_aRoms[nDispositivo * 8], &nTemperatura) && nTemperatura == nDispositivo * 16)
+		{
+			nCorrectas++;
+		}
+	}
+	_Prueba_Comprueba (nCorrectas == PRUEBA_SENSORES - 1, "temperatura.lee");
+	_Prueba_Comprueba (!OneWire_TempLee (&Prueba_aRoms[5 * 8], &nTemperatura) && nTemperatura == ONEWIRE_TEMP_ERROR, "temperatura.ausente");
+
+	memset (OneWireSimEeprom, 0xFF, sizeof (OneWireSimEeprom));
+	_Prueba_Comprueba (!OneWire_ListaArranca (&stLista, 16) && stLista.nDispositivos == PRUEBA_SENSORES, "lista.primer_arranque");
+	nCorrectas = 0;															//El alta ocupa su lugar: el inventario sigue el orden de la lista
+	for (nDispositivo = 0; nDispositivo < stInventario.nDispositivos; nDispositivo++)
+	{
+		if (memcmp (stInventario.aRom[nDispositivo], stLista.aRom[nDispositivo].aBytes, 8) == 0 && OneWire_InventarioBusca (&stInventario, stInventario.aRom[nDispositivo]) == nDispositivo)
+		{
+			nCorrectas++;
+		}
+	}
+	_Prueba_Comprueba (nCorrectas == PRUEBA_SENSORES, "inventario.orden");
+	_Prueba_Comprueba (OneWire_InventarioBusca (&stInventario, &Prueba_aRoms[5 * 8]) == ONEWIRE_INVENTARIO_NINGUNO, "inventario.busca_baja");
+	OneWire_ListaGuarda (&stLista, 16);
+	_Prueba_Comprueba (OneWire_ListaArranca (&stLista, 16) && stLista.nDispositivos == PRUEBA_SENSORES, "lista.sin_cambios");
+	OneWire_RomCrea (&stRom, aRom);
+	_Prueba_Comprueba (OneWire_ListaBusca (&stLista, &stRom) != ONEWIRE_LISTA_NINGUNO, "lista.busca");
+}
+/**
+******************************************************
+* @brief Altas, bajas y familias en una lista ordenada
+*
+* Nueve Id's de tres familias se insertan desordenados y la lista debe quedar en el orden de la busqueda, el
+* mismo que da OneWire_ListaLlena() con esos dispositivos en el bus. El dato de cada Id es su orden de alta
+*/
+void Prueba_Lista (void)
+{
+	static OneWire_Lista stLista, stBus;
+	int8 aFamilias[3] = {0x3A, 0x10, 0x28};
+	int8 aRom[8], nAlta, nDispositivo, nPrimero;
+	OneWire_Rom aRoms[9], stRom;
+	int1 lCorrectos;
+	int32 nResets;
+
+	OneWireSim_Termina ();
+	OneWireSim_Inicia ();
+	OneWire_ListaInicia (&stLista);
+	for (nAlta = 0; nAlta < 9; nAlta++)
+	{
+		OneWireSim_RomConCRC (aFamilias[nAlta % 3], 0x500 - nAlta * 0x43, aRom);
+		OneWireSim_AnadeEsclavo (aRom);
+		OneWire_RomCrea (&aRoms[nAlta], aRom);
+		OneWire_ListaInserta (&stLista, &aRoms[nAlta], nAlta);
+	}
+	OneWire_ListaInicia (&stBus);
+	OneWire_ListaLlena (&stBus);
+	lCorrectos = stLista.nDispositivos == 9 && stBus.nDispositivos == 9;
+	for (nDispositivo = 0; nDispositivo < stLista.nDispositivos; nDispositivo++)
+	{
+		lCorrectos &= OneWire_RomIgual (&stLista.aRom[nDispositivo], &stBus.aRom[nDispositivo]);
+		lCorrectos &= OneWire_RomIgual (&stLista.aRom[nDispositivo], &aRoms[stLista.aDato[nDispositivo]]);
+	}
+	_Prueba_Comprueba (lCorrectos, "lista.inserta_orden");
+
+	nDispositivo = OneWire_ListaInserta (&stLista, &aRoms[4], 44);
+	_Prueba_Comprueba (stLista.nDispositivos == 9 && stLista.aDato[nDispositivo] == 44, "lista.inserta_repetido");
+
+	_Prueba_Comprueba (OneWire_ListaFamilia (&stLista, 0x28, &nPrimero) == 3, "lista.familia");
+	lCorrectos = 1;
+	for (nDispositivo = nPrimero; nDispositivo < nPrimero + 3; nDispositivo++)
+	{
+		lCorrectos &= stLista.aRom[nDispositivo].aBytes[0] == 0x28;
+	}
+	_Prueba_Comprueba (lCorrectos, "lista.familia_seguidos");
+	_Prueba_Comprueba (OneWire_ListaFamilia (&stLista, 0x01, &nPrimero) == 0, "lista.familia_ausente");
+
+	_Prueba_Comprueba (OneWire_ListaElimina (&stLista, &aRoms[2]) && stLista.nDispositivos == 8, "lista.elimina");
+	_Prueba_Comprueba (!OneWire_ListaElimina (&stLista, &aRoms[2]), "lista.elimina_ausente");
+	_Prueba_Comprueba (OneWire_ListaBusca (&stLista, &aRoms[2]) == ONEWIRE_LISTA_NINGUNO, "lista.elimina_busca");
+	lCorrectos = 1;
+	for (nAlta = 0; nAlta < 9; nAlta++)
+	{
+		nDispositivo = OneWire_ListaBusca (&stLista, &aRoms[nAlta]);
+		if (nAlta != 2)
+		{
+			lCorrectos &= nDispositivo != ONEWIRE_LISTA_NINGUNO && stLista.aDato[nDispositivo] == (nAlta == 4 ? 44 : nAlta);
+		}
+	}
+	_Prueba_Comprueba (lCorrectos, "lista.elimina_datos");
+
+	for (nAlta = 0; stLista.nDispositivos < ONEWIRE_LISTA_MAX; nAlta++)
+	{
+		OneWireSim_RomConCRC (0x2D, 0x9000 + nAlta, aRom);
+		OneWire_RomCrea (&stRom, aRom);
+		OneWire_ListaInserta (&stLista, &stRom, 0);
+	}
+	OneWireSim_RomConCRC (0x2D, 0x8FFF, aRom);
+	OneWire_RomCrea (&stRom, aRom);
+	_Prueba_Comprueba (OneWire_ListaInserta (&stLista, &stRom, 0) == ONEWIRE_LISTA_NINGUNO && stLista.nDispositivos == ONEWIRE_LISTA_MAX, "lista.llena");
+
+	//Con mas dispositivos de los que caben la lista no se confirma, cada arranque es solo la busqueda
+	for (nAlta = 0; nAlta < ONEWIRE_LISTA_MAX + 2; nAlta++)
+	{
+		OneWireSim_RomConCRC (0x28, 0x3000 + nAlta, aRom);
+		OneWireSim_AnadeEsclavo (aRom);
+	}
+	memset (OneWireSimEeprom, 0xFF, sizeof (OneWireSimEeprom));
+	_Prueba_Comprueba (!OneWire_ListaArranca (&stLista, 0) && stLista.lDesbordada && stLista.nDispositivos == ONEWIRE_LISTA_MAX, "lista.desbordada");
+	nResets = OneWireSim.nResets;
+	_Prueba_Comprueba (!OneWire_ListaConfirma (&stLista) && OneWireSim.nResets == nResets, "lista.desbordada_sin_confirmar");
+	_Prueba_Comprueba (!OneWire_ListaArranca (&stLista, 0) && stLista.lDesbordada, "lista.desbordada_arranque");
+	_Prueba_Comprueba (OneWireSim.nResets - nResets == ONEWIRE_LISTA_MAX + 1, "lista.desbordada_pasadas");	//Hasta el primer Id que no cabe
+}
+/**
+******************************************************
+* @brief Escritura y lectura de la memoria de un DS2431 con cache
+*/
+void Prueba_Memoria (void)
+{
+	static OneWire_Memoria stMemoria;
+	OneWireSim_DS2431* pDS2431;
+	int8 aRom[8], aDatos[128];
+	int8 nByte, nErrores;
+
+	OneWireSim_Termina ();
+	OneWireSim_Inicia ();
+	OneWireSim_RomConCRC (0x2D, 0x123456, aRom);
+	pDS2431 = (OneWireSim_DS2431*) OneWireSim_AnadeDS2431 (aRom)->pDatos;
+	for (nByte = 0; nByte < 128; nByte++)
+	{
+		pDS2431->aMemoria[nByte] = nByte ^ 0xA5;
+	}
+	for (nByte = 0; nByte < 40; nByte++)
+	{
+		aDatos[nByte] = nByte * 7 + 1;
+	}
+	OneWire_MemoriaInicia (&stMemoria, aRom);
+	_Prueba_Comprueba (OneWire_MemoriaEscribe (&stMemoria, 3, aDatos, 40), "memoria.escribe");
+	_Prueba_Comprueba (OneWire_MemoriaGuarda (&stMemoria) && pDS2431->nErroresCopia == 0, "memoria.guarda");
+	nErrores = 0;
+	for (nByte = 0; nByte < 40; nByte++)
+	{
+		if (pDS2431->aMemoria[3 + nByte] != aDatos[nByte])
+		{
+			nErrores++;
+		}
+	}
+	_Prueba_Comprueba (nErrores == 0 && pDS2431->aMemoria[2] == (2 ^ 0xA5) && pDS2431->aMemoria[43] == (43 ^ 0xA5), "memoria.dispositivo");
+
+	OneWire_MemoriaDescarta (&stMemoria);
+	OneWire_MemoriaLee (&stMemoria, 0, aDatos, 8);							//Cache llena, el rango leido despues saca sus propias filas
+	OneWire_MemoriaLee (&stMemoria, 64, aDatos, 8);
+	OneWire_MemoriaLee (&stMemoria, 72, aDatos, 8);
+	OneWire_MemoriaLee (&stMemoria, 80, aDatos, 8);
+	memset (aDatos, 0x55, 48);
+	OneWire_MemoriaLee (&stMemoria, 0, aDatos, 48);
+	nErrores = 0;
+	for (nByte = 0; nByte < 48; nByte++)
+	{
+		if (aDatos[nByte] != pDS2431->aMemoria[nByte])
+		{
+			nErrores++;
+		}
+	}
+	_Prueba_Comprueba (nErrores == 0, "memoria.lee");
+	OneWire_MemoriaLeeBloque (aRom, 100, aDatos, 28);
+	_Prueba_Comprueba (aDatos[0] == (100 ^ 0xA5) && aDatos[27] == (127 ^ 0xA5), "memoria.lee_bloque");
+}
+/**
+******************************************************
+* @brief Atiende la cola hasta que no queda trabajo, con 1 ms entre llamadas como el bucle principal
+*/
+void _Prueba_ColaVacia (void)
+{
+	while (OneWire_ColaProcesa ())
+	{
+		OneWireSim_DelayUs (1000);
+	}
+}
+/**
+******************************************************
+* @brief Cola de transacciones: conversion conjunta, lecturas agrupadas, memoria y conversion fallida
+*/
+void Prueba_Cola (void)
+{
+	static int8 aConfig[3] = {0x11, 0x22, 0x7F};
+	OneWireSim_DS2431* pDS2431;
+	int8 aPeticiones[2 * PRUEBA_SENSORES], aRom[8], aDatos[ONEWIRE_COLA_DATOS];
+	int8 nSensor, nCorrectas, nMemoria, nEscritura, nConversion, nLectura;
+	int32 nResets;
+
+	_Prueba_Sensores (3);													//Con la escritura y la memoria llenan las ONEWIRE_COLA_MAX peticiones
+	OneWireSim_RomConCRC (0x2D, 0x4455, aRom);
+	pDS2431 = (OneWireSim_DS2431*) OneWireSim_AnadeDS2431 (aRom)->pDatos;
+	pDS2431->aMemoria[40] = 0x5C;
+	OneWire_ColaInicia ();
+	for (nSensor = 0; nSensor < 3; nSensor++)
+	{
+		aPeticiones[nSensor * 2] = OneWire_ColaConvierte (&Prueba_aRoms[nSensor * 8]);
+		aPeticiones[nSensor * 2 + 1] = OneWire_ColaLeeScratchpad (&Prueba_aRoms[nSensor * 8]);
+	}
+	nEscritura = OneWire_ColaEscribeScratchpad (&Prueba_aRoms[1 * 8], aConfig);
+	nMemoria = OneWire_ColaLeeMemoria (aRom, 40, 8);
+	nResets = OneWireSim.nResets;
+	_Prueba_ColaVacia ();
+	nCorrectas = 0;
+	for (nSensor = 0; nSensor < 3; nSensor++)
+	{
+		if (OneWire_ColaResultado (aPeticiones[nSensor * 2], aDatos) == ONEWIRE_COLA_HECHA &&
+			OneWire_ColaResultado (aPeticiones[nSensor * 2 + 1], aDatos) == ONEWIRE_COLA_HECHA &&
+			make16 (aDatos[1], aDatos[0]) == nSensor * 16)
+		{
+			nCorrectas++;
+		}
+	}
+	_Prueba_Comprueba (nCorrectas == 3, "cola.temperaturas");
+	_Prueba_Comprueba (OneWire_ColaResultado (nEscritura, aDatos) == ONEWIRE_COLA_HECHA, "cola.escribe_scratchpad");
+	_Prueba_Comprueba (OneWire_ColaResultado (nMemoria, aDatos) == ONEWIRE_COLA_HECHA && aDatos[0] == 0x5C, "cola.memoria");
+	_Prueba_Comprueba (OneWireSim.nResets - nResets < 8, "cola.agrupa");	//Menos que una transaccion por peticion
+	_Prueba_Comprueba (OneWire_ColaConvierte ((int8*)"\x28\1\2\3\4\5\6\7") == ONEWIRE_COLA_NINGUNA, "cola.id_erroneo");
+	_Prueba_Comprueba (OneWire_ColaResultado (ONEWIRE_COLA_NINGUNA, aDatos) == ONEWIRE_COLA_ERROR, "cola.resultado_ninguna");
+
+	((OneWireSim_DS18B20*) OneWireSim.aEsclavos[0].pDatos)->nConversion = 5000000L;	//Conversion que no termina: falla tambien la lectura
+	nConversion = OneWire_ColaConvierte (&Prueba_aRoms[0]);
+	nLectura = OneWire_ColaLeeScratchpad (&Prueba_aRoms[0]);
+	_Prueba_ColaVacia ();
+	_Prueba_Comprueba (OneWire_ColaResultado (nConversion, aDatos) == ONEWIRE_COLA_ERROR, "cola.conversion_fallida");
+	_Prueba_Comprueba (OneWire_ColaResultado (nLectura, aDatos) == ONEWIRE_COLA_ERROR, "cola.lectura_tras_fallo");
+}
+
+#if !defined (ONEWIRE_UART) && !defined (ONEWIRE_TIEMPOS_FIJOS)
+/**
+******************************************************
+* @brief Lee el scratchpad del dispositivo direccionado
+*
+* @return Temperatura del scratchpad, 0xFFFF si el CRC no es correcto
+*/
+int16 _Prueba_Scratchpad (void)
+{
+	int8 aDatos[9], nByte;
+
+	OneWire_SendByte (0xBE);
+	for (nByte = 0; nByte < 9; nByte++)
+	{
+		aDatos[nByte] = OneWire_ReceiveByte ();
+	}
+	if (OneWire_CRCBloque (0, aDatos, 9) != 0)
+	{
+		return 0xFFFF;
+	}
+	return make16 (aDatos[1], aDatos[0]);
+}
+/**
+******************************************************
+* @brief Overdrive Skip ROM y Match ROM, y vuelta a velocidad estandar cuando nadie responde en overdrive
+*/
+void Prueba_Overdrive (void)
+{
+	int32 nViolaciones;
+
+	_Prueba_Sensores (1);
+	nViolaciones = OneWireSim.nViolaciones;
+	_Prueba_Comprueba (OneWire_OverdriveSkipROM () == 0 && OneWire_Perfil.lOverdrive, "overdrive.skip");
+	_Prueba_Comprueba (_Prueba_Scratchpad () == 85*16, "overdrive.skip_lectura");	//Sin conversiones, el valor del encendido
+	_Prueba_Comprueba (OneWireSim.nViolaciones == nViolaciones, "overdrive.skip_sin_violaciones");
+	OneWire_Velocidad (0);
+
+	_Prueba_Sensores (3);
+	OneWire_SkipROM ();
+	OneWire_SendByte (0x44);
+	OneWireSim_DelayUs (ONEWIRE_SIM_CONVERSION);
+	nViolaciones = OneWireSim.nViolaciones;
+	_Prueba_Comprueba (OneWire_OverdriveMatchROM (&Prueba_aRoms[2 * 8]) == 0 && OneWire_Perfil.lOverdrive, "overdrive.match");
+	_Prueba_Comprueba (_Prueba_Scratchpad () == 2*16, "overdrive.match_lectura");
+	_Prueba_Comprueba (OneWire_Reset () == 0 && OneWire_Perfil.lOverdrive, "overdrive.reset");
+	OneWireSim_Desconecta (2);												//El unico esclavo en overdrive deja de responder
+	_Prueba_Comprueba (OneWire_Reset () == 0 && !OneWire_Perfil.lOverdrive, "overdrive.vuelta_estandar");
+	OneWire_MatchROM (&Prueba_aRoms[1 * 8]);
+	_Prueba_Comprueba (_Prueba_Scratchpad () == 1*16, "overdrive.estandar_lectura");
+	_Prueba_Comprueba (OneWireSim.nViolaciones == nViolaciones, "overdrive.sin_violaciones");
+}
+#endif
+#ifdef ONEWIRE_ESTADISTICAS
+/**
+******************************************************
+* @brief Contadores de una busqueda, de un reset sin presencias y de los bytes de una lectura
+*/
+void Prueba_Estadisticas (void)
+{
+	OneWire_Busqueda stBusqueda;
+	OneWire_Estadisticas stEst;
+	int8 aRom[8], nByte;
+	int16 nEncontrados, nLectura;
+	int64 nInicio;
+
+	_Prueba_Sensores (PRUEBA_SENSORES);
+	OneWire_EstadisticasBorra ();
+	nInicio = OneWireSim.nTiempo;
+	nEncontrados = _Prueba_Recorre (&stBusqueda, OneWire_SearchFirst (&stBusqueda, aRom), aRom, 0);
+	OneWire_EstadisticasCaptura (&stEst);
+	_Prueba_Comprueba (nEncontrados == PRUEBA_SENSORES, "estadisticas.busqueda");
+	_Prueba_Comprueba (stEst.nBusquedas == 1 && stEst.nPasadas == PRUEBA_SENSORES && stEst.nReintentosBusqueda == 0, "estadisticas.pasadas");
+	_Prueba_Comprueba (stEst.nResets == PRUEBA_SENSORES && stEst.nResetsSinPresencia == 0, "estadisticas.resets");
+	_Prueba_Comprueba (stEst.nComprobacionesCRC == PRUEBA_SENSORES && stEst.nErroresCRC == 0, "estadisticas.crc");
+	_Prueba_Comprueba (stEst.nTiempoReset > 0 && stEst.nTiempoBusqueda >= stEst.nTiempoReset, "estadisticas.tiempos");
+	_Prueba_Comprueba (stEst.nTiempoBusqueda <= OneWireSim.nTiempo - nInicio, "estadisticas.tiempo_busqueda");
+
+	OneWire_EstadisticasBorra ();
+	OneWire_SkipROM ();														//Con varios sensores solo cuentan los bytes, no los datos
+	OneWire_SendByte (0xBE);
+	for (nByte = 0; nByte < 9; nByte++)
+	{
+		OneWire_ReceiveByte ();
+	}
+	OneWire_EstadisticasCaptura (&stEst);
+	_Prueba_Comprueba (stEst.nResets == 1 && stEst.nBytesEnviados == 2 && stEst.nBytesRecibidos == 9, "estadisticas.bytes");
+
+	//Los reintentos de la busqueda con ruido se cuentan igual que en la estructura de la busqueda
+	for (nLectura = 50; nLectura < 3000 && stBusqueda.nReintentos == 0; nLectura += 61)
+	{
+		OneWire_EstadisticasBorra ();
+		OneWireSim.nLecturaFallida = nLectura;
+		_Prueba_Recorre (&stBusqueda, OneWire_SearchFirst (&stBusqueda, aRom), aRom, 0);
+	}
+	OneWireSim.nLecturaFallida = 0;
+	OneWire_EstadisticasCaptura (&stEst);
+	_Prueba_Comprueba (stEst.nReintentosBusqueda == stBusqueda.nReintentos, "estadisticas.reintentos");
+
+	OneWireSim_Termina ();
+	OneWireSim_Inicia ();
+	OneWire_EstadisticasBorra ();
+	OneWire_Reset ();
+	OneWire_EstadisticasCaptura (&stEst);
+	_Prueba_Comprueba (stEst.nResets == 1 && stEst.nResetsSinPresencia == 1, "estadisticas.sin_presencia");
+}
+#endif
+/**
+******************************************************
+* @brief Verificacion de Id's conocidos, uno a uno y en lista
+*
+* La lista tiene los 12 sensores del bus, dos de ellos desconectados, un Id valido que nunca ha estado y uno con
+* el CRC erroneo
+*/
+void Prueba_Verifica (void)
+{
+	int8 aLista[(PRUEBA_SENSORES + 2) * 8], aResultados[PRUEBA_SENSORES + 2];
+	int8 nSensor;
+	int1 lCorrectos;
+	int32 nResets;
+
+	_Prueba_Sensores (PRUEBA_SENSORES);
+	memcpy (aLista, Prueba_aRoms, PRUEBA_SENSORES * 8);
+	OneWireSim_RomConCRC (0x28, 0x9999, &aLista[PRUEBA_SENSORES * 8]);
+	memcpy (&aLista[(PRUEBA_SENSORES + 1) * 8], Prueba_aRoms, 8);
+	aLista[(PRUEBA_SENSORES + 1) * 8 + 7] ^= 0x01;
+	OneWireSim_Desconecta (3);
+	OneWireSim_Desconecta (4);
+
+	_Prueba_Comprueba (OneWire_Verifica (&Prueba_aRoms[0]) == ONEWIRE_VERIFICA_PRESENTE, "verifica.presente");
+	_Prueba_Comprueba (OneWire_Verifica (&Prueba_aRoms[3 * 8]) == ONEWIRE_VERIFICA_AUSENTE, "verifica.ausente");
+	nResets = OneWireSim.nResets;
+	_Prueba_Comprueba (OneWire_Verifica (&aLista[(PRUEBA_SENSORES + 1) * 8]) == ONEWIRE_VERIFICA_CRC, "verifica.crc");
+	_Prueba_Comprueba (OneWireSim.nResets == nResets, "verifica.crc_sin_bus");
+
+	nResets = OneWireSim.nResets;
+	_Prueba_Comprueba (OneWire_VerificaLista (aLista, PRUEBA_SENSORES + 2, aResultados) == PRUEBA_SENSORES - 2, "verifica.lista_presentes");
+	lCorrectos = 1;
+	for (nSensor = 0; nSensor < PRUEBA_SENSORES; nSensor++)
+	{
+		lCorrectos &= aResultados[nSensor] == ((nSensor == 3 || nSensor == 4) ? ONEWIRE_VERIFICA_AUSENTE : ONEWIRE_VERIFICA_PRESENTE);
+	}
+	lCorrectos &= aResultados[PRUEBA_SENSORES] == ONEWIRE_VERIFICA_AUSENTE;
+	lCorrectos &= aResultados[PRUEBA_SENSORES + 1] == ONEWIRE_VERIFICA_CRC;
+	_Prueba_Comprueba (lCorrectos, "verifica.lista_resultados");
+	_Prueba_Comprueba (OneWireSim.nResets - nResets <= PRUEBA_SENSORES + 1, "verifica.lista_pasadas");	//Como maximo una por Id valido
+}
+/**
+******************************************************
+* @brief Reset, busqueda y lectura simultaneas en los buses de un puerto
+*
+* Los buses tienen 3, 1, 0 y 5 DS18B20. El sensor n del bus b mide b*10+n grados
+*/
+void Prueba_Paralelo (void)
+{
+	OneWirePar_Busqueda stBusqueda;
+	int8 aDispositivos[PRUEBA_BUSES] = {3, 1, 0, 5};
+	int8 aRom[8], aRoms[64], aDatos[8], aPrimeros[64], aScratchpad[9][8], aLeido[9];
+	int8 nBus, nSensor, nByte, cBuses, cEncontrados, nPasadas;
+	int8 aEncontrados[PRUEBA_BUSES];
+	int1 lConectados, lCorrectos;
+
+	OneWireSim_Termina ();
+	OneWireSim_PuertoInicia (PRUEBA_BUSES);
+	cBuses = 0;
+	for (nBus = 0; nBus < PRUEBA_BUSES; nBus++)
+	{
+		OneWireSim_PuertoSelecciona (nBus);
+		for (nSensor = 0; nSensor < aDispositivos[nBus]; nSensor++)
+		{
+			OneWireSim_RomConCRC (0x28, 0x2000 + nBus * 0x100 + nSensor, aRom);
+			OneWireSim_AnadeDS18B20 (aRom, (int16)((nBus * 10 + nSensor) * 16));
+		}
+		bit_set (cBuses, nBus);
+	}
+	OneWirePar_Inicia ();
+	_Prueba_Comprueba (OneWirePar_Reset (cBuses) == 0x0B, "paralelo.presencias");
+
+	nPasadas = 0;
+	lConectados = 1;
+	for (nBus = 0; nBus < PRUEBA_BUSES; nBus++)
+	{
+		aEncontrados[nBus] = 0;
+	}
+	for (cEncontrados = OneWirePar_SearchFirst (&stBusqueda, cBuses, aRoms); cEncontrados; cEncontrados = OneWirePar_SearchNext (&stBusqueda, aRoms))
+	{
+		nPasadas++;
+		for (nBus = 0; nBus < PRUEBA_BUSES; nBus++)
+		{
+			if (!bit_test (cEncontrados, nBus))
+			{
+				continue;
+			}
+			OneWireSim_PuertoSelecciona (nBus);
+			lConectados &= _Prueba_Conectado (&aRoms[nBus * 8]);
+			if (aEncontrados[nBus] == 0)
+			{
+				memcpy (&aPrimeros[nBus * 8], &aRoms[nBus * 8], 8);
+			}
+			aEncontrados[nBus]++;
+		}
+	}
+	_Prueba_Comprueba (memcmp (aEncontrados, aDispositivos, PRUEBA_BUSES) == 0, "paralelo.busqueda");
+	_Prueba_Comprueba (lConectados, "paralelo.busqueda_ids");
+	_Prueba_Comprueba (nPasadas == 5, "paralelo.busqueda_pasadas");
+
+	//Conversion en todos los sensores y lectura del primer sensor de cada bus con Match ROM
+	cBuses = 0x0B;
+	OneWirePar_Reset (cBuses);
+	OneWirePar_SendByte (cBuses, 0xCC);
+	OneWirePar_SendByte (cBuses, 0x44);
+	OneWireSim_PuertoDelayUs (ONEWIRE_SIM_CONVERSION);
+	OneWirePar_Reset (cBuses);
+	OneWirePar_SendByte (cBuses, 0x55);
+	for (nByte = 0; nByte < 8; nByte++)
+	{
+		for (nBus = 0; nBus < 8; nBus++)
+		{
+			aDatos[nBus] = (nBus < PRUEBA_BUSES) ? aPrimeros[nBus * 8 + nByte] : 0;
+		}
+		OneWirePar_SendBytes (cBuses, aDatos);
+	}
+	OneWirePar_SendByte (cBuses, 0xBE);
+	for (nByte = 0; nByte < 9; nByte++)
+	{
+		OneWirePar_ReceiveByte (cBuses, aScratchpad[nByte]);
+	}
+	lCorrectos = 1;
+	for (nBus = 0; nBus < PRUEBA_BUSES; nBus++)
+	{
+		if (!bit_test (cBuses, nBus))
+		{
+			continue;
+		}
+		for (nByte = 0; nByte < 9; nByte++)
+		{
+			aLeido[nByte] = aScratchpad[nByte][nBus];
+		}
+		nSensor = aPrimeros[nBus * 8 + 1];									//Byte bajo del numero de serie
+		lCorrectos &= OneWire_CRCBloque (0, aLeido, 9) == 0;
+		lCorrectos &= make16 (aLeido[1], aLeido[0]) == (int16)((nBus * 10 + nSensor) * 16);
+	}
+	_Prueba_Comprueba (lCorrectos, "paralelo.lectura");
+	OneWireSim_Termina ();
+}
+#if defined (ONEWIRE_INTERRUPCIONES) && !(defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482))
+/**
+******************************************************
+* @brief Busqueda con una rutina de interrupcion que entra en cada espera no bloqueada
+*
+* Una rutina de 50 us alargaria el 0 de un slot de escritura por encima de 120 us si no estuviera bloqueado.
+* Solo con los slots por software: el motor no bloqueante genera los slots dentro de su propia interrupcion y
+* con UART o DS2482 los tiempos del bus los pone el periferico
+*/
+void Prueba_Interrupciones (void)
+{
+	OneWire_Busqueda stBusqueda;
+	int8 aRom[8];
+	int16 nEncontrados;
+
+	_Prueba_Sensores (PRUEBA_SENSORES);
+	OneWireSimInt.nBloqueoMax = 0;
+	OneWireSimInt.nRutina = 50;
+	nEncontrados = _Prueba_Recorre (&stBusqueda, OneWire_SearchFirst (&stBusqueda, aRom), aRom, 0);
+	OneWireSimInt.nRutina = 0;
+	_Prueba_Comprueba (nEncontrados == PRUEBA_SENSORES, "interrupciones.busqueda");
+	_Prueba_Comprueba (OneWireSimInt.nBloqueoMax <= ONEWIRE_BLOQUEO_MAX, "interrupciones.bloqueo_max");
+}
+#endif
+#if !defined (ONEWIRE_UART) && !defined (ONEWIRE_DS2482) && !defined (ONEWIRE_TIEMPOS_FIJOS)
+/**
+******************************************************
+* @brief Calibracion de los tiempos con un bus lento y vuelta a los tiempos estandar
+*/
+void Prueba_Calibracion (void)
+{
+	static OneWire_Inventario stInventario;
+	static int16 aTemperaturas[ONEWIRE_INVENTARIO_MAX];
+	OneWire_Calibracion stCalibracion;
+	int8 nDispositivo, nCorrectas;
+
+	_Prueba_Sensores (PRUEBA_SENSORES);
+	OneWireSim.nSubida = 5;
+	_Prueba_Comprueba (OneWire_Calibra (&stCalibracion), "calibracion.mide");
+	_Prueba_Comprueba (stCalibracion.nSubida >= 5 && stCalibracion.nPresenciaInicio <= stCalibracion.nPresenciaFin, "calibracion.medidas");
+	_Prueba_Comprueba (OneWire_Perfil.nResetMuestreo + OneWire_Perfil.nResetFin >= ONEWIRE_CALIBRA_RESET_ALTO, "calibracion.reset_alto");
+	OneWireSim.nViolaciones = 0;
+	OneWire_InventarioInicia (&stInventario);
+	OneWire_InventarioActualiza (&stInventario);
+	nCorrectas = OneWire_TempMuestrea (&stInventario, aTemperaturas);
+	for (nDispositivo = 0; nDispositivo < stInventario.nDispositivos; nDispositivo++)
+	{
+		if (aTemperaturas[nDispositivo] == ONEWIRE_TEMP_ERROR)
+		{
+			nCorrectas = 0;
+		}
+	}
+	_Prueba_Comprueba (nCorrectas == PRUEBA_SENSORES && OneWireSim.nViolaciones == 0, "calibracion.bus");
+	OneWire_CalibraBorra ();
+	_Prueba_Comprueba (OneWire_Perfil.nResetBajo == ONEWIRE_STD_RESET_BAJO && OneWire_Perfil.nEscrituraBit == ONEWIRE_STD_ESCRITURA_BIT, "calibracion.borra");
+	OneWireSim.nSubida = 0;
+}
+#endif
+
+#ifdef ONEWIRE_UART
+/**
+******************************************************
+* @brief Bus generado con la UART sobre el pseudo-terminal del simulador
+*
+* Comprueba que los slots pasan de verdad por el pseudo-terminal y que reset, busqueda y lectura del scratchpad
+* funcionan igual que con el bus por software
+*/
+void Prueba_Uart (void)
+{
+	int8 aRom[8], aScratchpad[9];
+	int16 nCRC;
+	int32 nTramas;
+	OneWire_Busqueda stBusqueda;
+
+	_Prueba_Sensores (3);
+	nTramas = OneWireSimSerie.nTramas;
+	_Prueba_Comprueba (OneWire_Reset () == 0, "uart.presencia");
+	_Prueba_Comprueba (_Prueba_Recorre (&stBusqueda, OneWire_SearchFirst (&stBusqueda, aRom), aRom, 0) == 3, "uart.busqueda");
+	OneWire_MatchROM (&Prueba_aRoms[2 * 8]);
+	OneWire_SendByte (0x44);
+	OneWireSim_DelayUs (750000L);
+	nCRC = 0;
+	OneWire_MatchROM (&Prueba_aRoms[2 * 8]);
+	OneWire_SendByte (0xBE);
+	_Prueba_Comprueba (OneWire_ReadBlock (aScratchpad, 9, ONEWIRE_CRC_8, &nCRC), "uart.scratchpad_crc");
+	_Prueba_Comprueba (make16 (aScratchpad[1], aScratchpad[0]) == 2 * 16, "uart.scratchpad_temperatura");
+	_Prueba_Comprueba (OneWireSimSerie.nTramas > nTramas, "uart.pseudo_terminal");
+
+	OneWireSim_Termina ();
+	OneWireSim_Inicia ();
+	_Prueba_Comprueba (OneWire_Reset () == 1, "uart.bus_vacio");
+}
+#endif
+
+int main (void)
+{
+#ifdef ONEWIRE_UART
+	OneWire_UartInicia ();
+#endif
+	Prueba_CRC ();
+	Prueba_Busqueda ();
+	Prueba_Resume ();
+	Prueba_Verifica ();
+	Prueba_Inventario ();
+	Prueba_Lista ();
+	Prueba_Memoria ();
+	Prueba_Cola ();
+#if !defined (ONEWIRE_UART) && !defined (ONEWIRE_TIEMPOS_FIJOS)
+	Prueba_Overdrive ();
+#endif
+	Prueba_Paralelo ();
+#ifdef ONEWIRE_ESTADISTICAS
+	Prueba_Estadisticas ();
+#endif
+#if defined (ONEWIRE_INTERRUPCIONES) && !(defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482))
+	Prueba_Interrupciones ();
+#endif
+#if !defined (ONEWIRE_UART) && !defined (ONEWIRE_DS2482) && !defined (ONEWIRE_TIEMPOS_FIJOS)
+	Prueba_Calibracion ();
+#endif
+#ifdef ONEWIRE_UART
+	Prueba_Uart ();
+	OneWireSim_UartCierra ();
+#endif
+	OneWireSim_Termina ();
+	printf ("%u comprobaciones, %u fallos\n", Prueba_nComprobaciones, Prueba_nFallos);
+	return Prueba_nFallos;
+}
@@ -11,11 +11,51 @@
 
 
 
+/**
+******************************************************
+* @brief Genera el pulso de reset con los tiempos del perfil activo
+*
+* Funcion interna. 
+*
+* @return Devuelve 0 si hay algun dispositivo conectado, 1 en caso contrario
+*
+* @see OneWire_Reset()
+*/
+int1 _OneWire_PulsoReset (void)
+{
+	//-------------------------------------------------------------   
+   	//Definicion de variables
+   	//-------------------------------------------------------------   
+   	int lEstadoPin1W;                                       
+   	//-------------------------------------------------------------   
+#ifdef ONEWIRE_ASYNC
+	OneWire_AsyncReset ();												//Con el motor no bloqueante solo esperamos a que termine
+	OneWire_AsyncEspera ();
+	lEstadoPin1W = !OneWire_Async.lPresencia;
+#elif defined (ONEWIRE_UART)
+	lEstadoPin1W = OneWire_UartReset ();								//Byte 0xF0 a 9600 baudios
+#elif defined (ONEWIRE_DS2482)
+	lEstadoPin1W = !(OneWire_DS2482Comando (ONEWIRE_DS2482_RESET, 0, 0) & ONEWIRE_DS2482_PPD);
+#else
+   	_OneWire_PinLow ();													//Ponemos la salida a 0 durante 480 us
+   	_OneWire_DelayUs (_ONEWIRE_T_RESET_BAJO);
+   	_OneWire_BloqueaSi (_ONEWIRE_T_RESET_MUESTREO)						//Una interrupcion puede alargar el reset, no retrasar la lectura
+   	_OneWire_PinFloat ();												//Nos ponemos en modo entrada y esperamos 60 us para que se estabilicen los esclavos
+   	_OneWire_DelayUs (_ONEWIRE_T_RESET_MUESTREO);
+   	lEstadoPin1W = _OneWire_PinRead ();										//A los 60 us, leemos el bus
+   	_OneWire_Desbloquea ();
+   	_OneWire_DelayUs (_ONEWIRE_T_RESET_FIN);	
+#endif
+   	return (lEstadoPin1W);												//Retornamos el estado del bus  1, si no haba esclavo y 0 si haba esclavo                                  
+}
 /**
 ******************************************************
 * @brief Resetea el bus 1 Wire
 * @return Devuelve 0 si hay algun dispositivo conectado, 1 en caso contrario
 *
+* Si el bus esta en overdrive y ningun dispositivo responde, se vuelve a velocidad estandar y se repite
+* el reset, que con la duracion estandar devuelve a todos los dispositivos a velocidad estandar
+*
 * Ejemplo:
 *
 *	int lEstado = 0;
@@ -31,17 +71,81 @@
 int1 OneWire_Reset (void)
 {
 	//-------------------------------------------------------------   
-   	//Definicion de variables
-   	//-------------------------------------------------------------   
-   	int lEstadoPin1W;                                       
-   	//-------------------------------------------------------------   
-   	output_low (Pin1W);													//Ponemos la salida a 0 durante 480 us
-   	delay_us (480);
-   	output_float (Pin1W);												//Nos ponemos en modo entrada y esperamos 60 us para que se estabilicen los esclavos
-   	delay_us(60);
-   	lEstadoPin1W = input (Pin1W);										//A los 60 us, leemos el bus
-   	delay_us(240);	
-   	return (lEstadoPin1W);												//Retornamos el estado del bus  1, si no haba esclavo y 0 si haba esclavo                                  
+	//Definicion de variables
+	//-------------------------------------------------------------   
+	int1 lEstado;
+	_OneWire_EstMarca (nInicio)
+	//-------------------------------------------------------------   
+
+	_OneWire_EstInicio (nInicio)
+	OneWire_Resume.lValido = 0;											//El comando ROM que siga puede no ser Match ROM
+	lEstado = _OneWire_PulsoReset ();
+	if ( lEstado && OneWire_Perfil.lOverdrive )							//Nadie responde en overdrive
+	{
+		OneWire_Velocidad (0);
+		lEstado = _OneWire_PulsoReset ();
+	}
+	_OneWire_EstCuenta (nResets)
+	_OneWire_EstSuma (nResetsSinPresencia, lEstado)
+	_OneWire_EstTiempo (nTiempoReset, nInicio)
+	return (lEstado);
+}
+/**
+******************************************************
+* @brief Selecciona los tiempos de velocidad estandar u overdrive
+*
+* Solo cambia los tiempos del maestro. Para pasar los dispositivos a overdrive deben usarse
+* OneWire_OverdriveSkipROM() u OneWire_OverdriveMatchROM()
+*
+* @param lOverdrive 1 para overdrive, 0 para velocidad estandar
+*
+* Ejemplo:
+*
+*	OneWire_Velocidad (0);
+*
+* Resultado:
+*
+*	OneWire_Perfil con los tiempos ONEWIRE_STD_xxx, o los calibrados con OneWire_Calibra()
+*
+* @see OneWire_OverdriveSkipROM(), OneWire_OverdriveMatchROM()
+*/
+void OneWire_Velocidad (int1 lOverdrive)
+{
+	//-------------------------------------------------------------   
+	//Definicion de variables
+	//-------------------------------------------------------------   
+#ifdef ONEWIRE_DS2482
+	int1 lAnterior;
+#endif
+	//-------------------------------------------------------------   
+
+#ifdef ONEWIRE_DS2482
+	lAnterior = OneWire_Perfil.lOverdrive;
+#endif
+	if ( lOverdrive )
+	{
+		OneWire_Perfil.nResetBajo = ONEWIRE_OD_RESET_BAJO;
+		OneWire_Perfil.nResetMuestreo = ONEWIRE_OD_RESET_MUESTREO;
+		OneWire_Perfil.nResetFin = ONEWIRE_OD_RESET_FIN;
+		OneWire_Perfil.nEscrituraBajo = ONEWIRE_OD_ESCRITURA_BAJO;
+		OneWire_Perfil.nEscrituraBit = ONEWIRE_OD_ESCRITURA_BIT;
+		OneWire_Perfil.nEscrituraRecupera = ONEWIRE_OD_ESCRITURA_RECUPERA;
+		OneWire_Perfil.nLecturaBajo = ONEWIRE_OD_LECTURA_BAJO;
+		OneWire_Perfil.nLecturaMuestreo = ONEWIRE_OD_LECTURA_MUESTREO;
+		OneWire_Perfil.nLecturaRecupera = ONEWIRE_OD_LECTURA_RECUPERA;
+		OneWire_Perfil.nBloqueEscrituraBit = ONEWIRE_OD_BLOQUE_ESCRITURA_BIT;
+		OneWire_Perfil.nBloqueLecturaRecupera = ONEWIRE_OD_BLOQUE_LECTURA_RECUPERA;
+		OneWire_Perfil.nBloqueRecupera = ONEWIRE_OD_BLOQUE_RECUPERA;
+	}else{
+		memcpy (&OneWire_Perfil, &OneWire_PerfilEstandar, sizeof (OneWire_Tiempos));	//Los de las macros o los de la ultima calibracion
+	}
+#ifdef ONEWIRE_DS2482
+	if ( lOverdrive != lAnterior )										//Con el DS2482 la velocidad es un bit de configuracion
+	{
+		OneWire_DS2482Configura (lOverdrive ? (OneWire_DS2482Config | ONEWIRE_DS2482_1WS) : (OneWire_DS2482Config & ~ONEWIRE_DS2482_1WS));
+	}
+#endif
+	OneWire_Perfil.lOverdrive = lOverdrive;
 }
 /**
 ******************************************************
@@ -63,22 +167,16 @@ int1 OneWire_Reset (void)
 */
 void OneWire_Write  (int1 lBit)
 {
-	if ( lBit )
-	{
-		output_low (Pin1W);													//Ponemos durante 10 us el bus a 0 para indicar que se inicia un bit
-		delay_us (10);
-		output_high (Pin1W);												//Ponemos el bus a 1 durante 70 us
-		delay_us(70);
-		output_float (Pin1W);												//Dejamos el bus en alta impedancia
-		delay_us(2);
-	}else{
-		output_low (Pin1W);													//Ponemos durante 10 us el bus a 0 para indicar que se inicia un bit
-		delay_us (10);
-		output_low (Pin1W);													//Ponemos el bus a 0 durante 70 us
-		delay_us(70);
-		output_float (Pin1W);												//Dejamos el bus en alta impedancia
-		delay_us(2);
-	}
+#ifdef ONEWIRE_ASYNC
+	OneWire_AsyncWrite (lBit);
+	OneWire_AsyncEspera ();
+#elif defined (ONEWIRE_UART)
+	OneWire_UartBits (lBit, 1);
+#elif defined (ONEWIRE_DS2482)
+	OneWire_DS2482Comando (ONEWIRE_DS2482_BIT, lBit ? 0x80 : 0x00, 1);
+#else
+	_OneWire_SlotEscribe (lBit, _ONEWIRE_T_ESCRITURA_BIT, _ONEWIRE_T_ESCRITURA_RECUPERA)	//10 us a 0, 70 us con el bit y el bus en alta impedancia
+#endif
 }
 /**
 ******************************************************
@@ -96,12 +194,11 @@ void OneWire_Write  (int1 lBit)
 */
 void OneWire_Write_1 (void)
 {
-	output_low (Pin1W);													//Ponemos durante 10 us el bus a 0 para indicar que se inicia un bit
-	delay_us (10);
-	output_high (Pin1W);												//Ponemos el bus a 1 durante 70 us
-	delay_us(70);
-	output_float (Pin1W);												//Dejamos el bus en alta impedancia
-	delay_us(2);
+#if defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482)
+	OneWire_Write (1);
+#else
+	_OneWire_SlotEscribe (1, _ONEWIRE_T_ESCRITURA_BIT, _ONEWIRE_T_ESCRITURA_RECUPERA)
+#endif
 }
 /**
 ******************************************************
@@ -119,12 +216,11 @@ void OneWire_Write_1 (void)
 */
 void OneWire_Write_0 (void)
 {
-	output_low (Pin1W);													//Ponemos durante 10 us el bus a 0 para indicar que se inicia un bit
-	delay_us (10);
-	output_low (Pin1W);													//Ponemos el bus a 0 durante 70 us
-	delay_us(70);
-	output_float (Pin1W);												//Dejamos el bus en alta impedancia
-	delay_us(2);
+#if defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482)
+	OneWire_Write (0);
+#else
+	_OneWire_SlotEscribe (0, _ONEWIRE_T_ESCRITURA_BIT, _ONEWIRE_T_ESCRITURA_RECUPERA)
+#endif
 }
 /**
 ******************************************************
@@ -145,24 +241,109 @@ void OneWire_Write_0 (void)
 int1 OneWire_LeeBit (void)
 {
 	int1 lBitLeido;
-	output_low (Pin1W);													//Ponemos el bus a 0 durante 2 us para indicar al escalvo que puede poner el bit que quiere transmitir
-	delay_us(2);
-   	output_float (Pin1W);												//Dejamos al bus en escucha durante 15 us para que el escalvo estabilice su salida
-   	delay_us(15);
-	lBitLeido=input(Pin1W);												//Leemos el bus 
-	delay_us(50);														//Temporizamos 50 us para leer el siguiente bit
+#ifdef ONEWIRE_ASYNC
+	OneWire_AsyncLeeBit ();
+	OneWire_AsyncEspera ();
+	lBitLeido = OneWire_Async.lBit;
+#elif defined (ONEWIRE_UART)
+	lBitLeido = OneWire_UartBits (1, 1);
+#elif defined (ONEWIRE_DS2482)
+	lBitLeido = (OneWire_DS2482Comando (ONEWIRE_DS2482_BIT, 0x80, 1) & ONEWIRE_DS2482_SBR) != 0;
+#else
+	_OneWire_SlotLee (lBitLeido, _ONEWIRE_T_LECTURA_RECUPERA)			//2 us a 0, lectura a los 15 us y 50 us hasta el siguiente slot
+#endif
 
 	return lBitLeido;													//Devolvemos el bit leido	
 }
 /**
 ******************************************************
+* @brief Resuelve una posicion de bit de la busqueda de Id's ( triplete )
+*
+* Lee el bit y su complemento que envian los dispositivos y escribe la direccion elegida, los tres slots seguidos
+* sin pasar por OneWire_LeeBit() ni OneWire_Write() y con los tiempos minimos de OneWire_WriteBlock() y
+* OneWire_ReadBlock(). Con la UART el bit y el complemento van en una sola transferencia; la escritura necesita su
+* eco, asi que va en otra. Si los dos bits leidos son distintos la direccion es el bit leido, si los dos son 0
+* ( discrepancia ) se escribe lDireccion
+*
+* @param lDireccion Direccion a tomar si hay discrepancia
+* @return Bits ONEWIRE_TRIPLET_BIT, ONEWIRE_TRIPLET_COMPLEMENTO y ONEWIRE_TRIPLET_DIRECCION
+*
+* Ejemplo:
+*
+*	int8 nTriplet;
+*
+*	nTriplet = OneWire_Triplet (0);
+*
+* Resultado:
+*
+*	nTriplet = 0 si hay discrepancia y se ha tomado el 0
+*
+* @see OneWire_LeeBit(), OneWire_Write()
+*/
+int8 OneWire_Triplet (int1 lDireccion)
+{
+	//-------------------------------------------------------------   
+	//Definicion de variables
+	//-------------------------------------------------------------   
+	int1 lBitLeido, lBitComplemento;
+	int8 nTriplet;
+	//-------------------------------------------------------------   
+
+#ifdef ONEWIRE_DS2482
+	nTriplet = OneWire_DS2482Comando (ONEWIRE_DS2482_TRIPLET, lDireccion ? 0x80 : 0x00, 1);
+	lBitLeido = (nTriplet & ONEWIRE_DS2482_SBR) != 0;					//El DS2482 hace los tres slots con un solo comando
+	lBitComplemento = (nTriplet & ONEWIRE_DS2482_TSB) != 0;
+	lDireccion = (nTriplet & ONEWIRE_DS2482_DIR) != 0;
+#elif defined (ONEWIRE_UART)
+	nTriplet = OneWire_UartBits (0xFF, 2);								//Bit y complemento encadenados
+	lBitLeido = bit_test (nTriplet, 0);
+	lBitComplemento = bit_test (nTriplet, 1);
+#elif defined (ONEWIRE_ASYNC)
+	lBitLeido = OneWire_LeeBit ();
+	lBitComplemento = OneWire_LeeBit ();
+#else
+	_OneWire_SlotLee (lBitLeido, _ONEWIRE_T_BLOQUE_LECTURA_RECUPERA)		//Slot de lectura del bit
+	_OneWire_SlotLee (lBitComplemento, _ONEWIRE_T_BLOQUE_LECTURA_RECUPERA)	//Slot de lectura del complemento
+#endif
+	if ( lBitLeido != lBitComplemento )
+	{
+		lDireccion = lBitLeido;											//Todos los dispositivos tienen el mismo bit
+	}
+	nTriplet = 0;
+	if ( lBitLeido )
+	{
+		nTriplet |= ONEWIRE_TRIPLET_BIT;
+	}
+	if ( lBitComplemento )
+	{
+		nTriplet |= ONEWIRE_TRIPLET_COMPLEMENTO;
+	}
+	if ( lBitLeido && lBitComplemento )									//Nadie responde, no escribimos nada
+	{
+		return nTriplet;
+	}
+	if ( lDireccion )
+	{
+		nTriplet |= ONEWIRE_TRIPLET_DIRECCION;
+	}
+#ifdef ONEWIRE_DS2482
+	//La direccion ya la ha escrito el DS2482
+#elif defined (ONEWIRE_UART)
+	OneWire_UartBits (lDireccion ? 0xFF : 0x00, 1);
+#elif defined (ONEWIRE_ASYNC)
+	OneWire_Write (lDireccion);
+#else
+	_OneWire_SlotEscribe (lDireccion, _ONEWIRE_T_BLOQUE_ESCRITURA_BIT, _ONEWIRE_T_BLOQUE_RECUPERA)	//Slot de escritura de la direccion
+#endif
+	return nTriplet;
+}
+/**
+******************************************************
 * @brief Envia un byte el bus 1 Wire
 *
 * @param cDato Byte a transmitir
 *
-* Funciones utilizadas
-*	- OneWire_Write_1()
-*	- OneWire_Write_0()
+* Los slots se generan en linea con _OneWire_SlotEscribe(), sin llamar a OneWire_Write_1() ni OneWire_Write_0()
 *
 * Ejemplo:
 *
@@ -180,20 +361,30 @@ void OneWire_SendByte(byte cDato)
 	//-------------------------------------------------------------   
 	//Definicion de variables
 	//-------------------------------------------------------------   
-	int nBit;
+#if !(defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482))
+	int nBit;															//Solo para el bus por software
+#endif
+	_OneWire_EstMarca (nInicio)
 	//-------------------------------------------------------------   
 
+	_OneWire_EstInicio (nInicio)
+#ifdef ONEWIRE_ASYNC
+	OneWire_AsyncSendByte (cDato);
+	OneWire_AsyncEspera ();
+#elif defined (ONEWIRE_UART)
+	OneWire_UartBits (cDato, 8);										//Los 8 slots en una sola transferencia
+#elif defined (ONEWIRE_DS2482)
+	OneWire_DS2482Comando (ONEWIRE_DS2482_ESCRIBE_BYTE, cDato, 1);
+#else
 	for ( nBit = 0; nBit < 8; nBit++ )					 				//Escribimos 8 bits empezando por el de menor peso		
 	{
-		if ( cDato & (1<<nBit) )										//Si el bit a transmitir es 1
-		{
-			OneWire_Write_1();											//Transmitimos 1
-		}else{															//En caso contrario
-			OneWire_Write_0();											//Transmitimos 0
-		}
+		_OneWire_SlotEscribe (cDato & 0x01, _ONEWIRE_T_ESCRITURA_BIT, _ONEWIRE_T_ESCRITURA_RECUPERA)
+		cDato >>= 1;
 	}
-	output_float (Pin1W);												//Dejamos al bus en alta impedancia
-
+	_OneWire_PinFloat ();												//Dejamos al bus en alta impedancia
+#endif
+	_OneWire_EstCuenta (nBytesEnviados)
+	_OneWire_EstTiempo (nTiempoBytes, nInicio)
 }
 /**
 ******************************************************
@@ -217,23 +408,245 @@ byte OneWire_ReceiveByte()
 	//-------------------------------------------------------------   
 	//Definicion de variables
 	//-------------------------------------------------------------   
-	int nBit;
+#if !(defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482))
+	int nBit;															//Solo para el bus por software
+	int1 lBit;
+#endif
 	byte bDato=0;
+	_OneWire_EstMarca (nInicio)
 	//-------------------------------------------------------------   
 	
+	_OneWire_EstInicio (nInicio)
+#ifdef ONEWIRE_ASYNC
+	OneWire_AsyncReceiveByte ();
+	OneWire_AsyncEspera ();
+	bDato = OneWire_Async.cDato;
+#elif defined (ONEWIRE_UART)
+	bDato = OneWire_UartBits (0xFF, 8);
+#elif defined (ONEWIRE_DS2482)
+	OneWire_DS2482Comando (ONEWIRE_DS2482_LEE_BYTE, 0, 0);
+	bDato = _OneWire_DS2482LeeDato ();
+	_OneWireI2C_Parada ();
+#else
 	for ( nBit = 0; nBit < 8; nBit++ )									//Vamos a leer 8 bits
 	{
-		output_low (Pin1W);												//Ponemos el bus a 0 durante 2 us para indicar al escalvo que puede poner el bit que quiere transmitir
-		delay_us(2);
-   		output_float (Pin1W);											//Dejamos al bus en escucha durante 15 us para que el escalvo estabilice su salida
-   		delay_us(15);
-		shift_right(&bDato,1,input(Pin1W));								//Lo aadimos al byte que con 
-   		delay_us(50);													//Temporizamos 50 us para leer el siguiente bit
+		_OneWire_SlotLee (lBit, _ONEWIRE_T_LECTURA_RECUPERA)			//2 us a 0, lectura a los 15 us y 50 us hasta el siguiente slot
+		shift_right(&bDato,1,lBit);										//Lo aadimos al byte
 	}
+#endif
+	_OneWire_EstCuenta (nBytesRecibidos)
+	_OneWire_EstTiempo (nTiempoBytes, nInicio)
 	return (bDato);														//Retornamos el byte leido
 }
 /**
 ******************************************************
+* @brief Recibe 1 byte del bus 1 Wire y lo acumula en un CRC
+*
+* Permite ir calculando el CRC mientras se reciben los datos, de forma que esta disponible al recibir el ultimo byte
+*
+* @param pCRC Puntero al CRC acumulado, inicialmente debe ser 0
+* @return Retorna el Byte recibido por el bus
+*
+* Ejemplo:
+*
+*	int8 aScratchpad[9], nByte, nCRC = 0;
+*
+*	for (nByte=0;nByte<9;nByte++)
+*	{
+*		aScratchpad[nByte] = OneWire_ReceiveByteCRC (&nCRC);
+*	}
+*
+* Resultado:
+*
+*	nCRC = 0 si los 9 bytes, incluido el CRC enviado por el dispositivo, son correctos
+*
+* @see OneWire_ReceiveByte(), OneWire_CRC()
+*/
+byte OneWire_ReceiveByteCRC(int8* pCRC)
+{
+	//-------------------------------------------------------------   
+	//Definicion de variables
+	//-------------------------------------------------------------   
+	byte bDato;
+	//-------------------------------------------------------------   
+
+	bDato = OneWire_ReceiveByte();
+	*pCRC = OneWire_CRC (*pCRC, bDato);
+	return (bDato);
+}
+/**
+******************************************************
+* @brief Envia un bloque de bytes por el bus 1 Wire acumulando su CRC
+*
+* Los slots se encadenan sin llamar a OneWire_SendByte() y con los tiempos minimos del perfil
+* ( nBloqueEscrituraBit y nBloqueRecupera ). El CRC se actualiza despues de cada byte, en la recuperacion del slot
+*
+* @param aDatos Bytes a transmitir
+* @param nBytes Numero de bytes
+* @param nTipoCRC ONEWIRE_CRC_NINGUNO, ONEWIRE_CRC_8 o ONEWIRE_CRC_16
+* @param pCRC CRC acumulado, se actualiza con los bytes enviados ( puede ser NULL con ONEWIRE_CRC_NINGUNO )
+*
+* Ejemplo:
+*
+*	int8 aComando[3] = {0xF0, 0x00, 0x00};
+*	int16 nCRC = 0;
+*
+*	OneWire_MatchROM (aRom);
+*	OneWire_WriteBlock (aComando, 3, ONEWIRE_CRC_16, &nCRC);
+*
+* Resultado:
+*
+*	Comando Read Memory enviado y nCRC con su CRC16 para compararlo con el que devuelva el dispositivo
+*
+* @see OneWire_ReadBlock(), OneWire_SendByte()
+*/
+void OneWire_WriteBlock (int8* aDatos, int8 nBytes, int8 nTipoCRC, int16* pCRC)
+{
+	//-------------------------------------------------------------   
+	//Definicion de variables
+	//-------------------------------------------------------------   
+	int8 nByte;
+#if !(defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482))
+	int8 nBit;															//Solo para el bus por software
+	byte cDato;
+#endif
+	_OneWire_EstMarca (nInicio)
+	//-------------------------------------------------------------   
+
+	_OneWire_EstInicio (nInicio)
+#if defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482)
+#ifdef ONEWIRE_UART
+	OneWire_UartBloque (aDatos, nBytes, 0);
+#elif defined (ONEWIRE_DS2482)
+	OneWire_DS2482Bloque (aDatos, nBytes, 0);
+#else
+	OneWire_AsyncWriteBlock (aDatos, nBytes);
+	OneWire_AsyncEspera ();
+#endif
+	for (nByte = 0; nByte < nBytes; nByte++)
+	{
+		_OneWire_AcumulaCRC (nTipoCRC, pCRC, aDatos[nByte]);
+	}
+#else
+	for (nByte = 0; nByte < nBytes; nByte++)
+	{
+		cDato = aDatos[nByte];
+		for (nBit = 0; nBit < 8; nBit++)
+		{
+			_OneWire_SlotEscribe (cDato & 0x01, _ONEWIRE_T_BLOQUE_ESCRITURA_BIT, _ONEWIRE_T_BLOQUE_RECUPERA)
+			cDato >>= 1;
+		}
+		_OneWire_AcumulaCRC (nTipoCRC, pCRC, aDatos[nByte]);
+	}
+#endif
+	_OneWire_EstSuma (nBytesEnviados, nBytes)
+	_OneWire_EstTiempo (nTiempoBytes, nInicio)
+}
+/**
+******************************************************
+* @brief Recibe un bloque de bytes del bus 1 Wire comprobando su CRC
+*
+* Igual que OneWire_WriteBlock(), los slots se encadenan con los tiempos minimos y el CRC se actualiza
+* al recibir cada byte. Si el bloque termina con el CRC del dispositivo ( el CRC16 se envia invertido )
+* el resultado indica si los datos son correctos. Un mensaje se puede repartir en varios bloques pasando
+* siempre el mismo pCRC, solo el resultado del ultimo tiene sentido
+*
+* @param aDatos Array donde se dejan los bytes recibidos
+* @param nBytes Numero de bytes
+* @param nTipoCRC ONEWIRE_CRC_NINGUNO, ONEWIRE_CRC_8 o ONEWIRE_CRC_16
+* @param pCRC CRC acumulado ( puede ser NULL con ONEWIRE_CRC_NINGUNO )
+* @return 1 si el CRC es correcto o no se comprueba, 0 si no coincide
+*
+* Ejemplo:
+*
+*	int8 aScratchpad[9];
+*	int16 nCRC = 0;
+*
+*	OneWire_MatchROM (aRom);
+*	OneWire_SendByte (0xBE);
+*	if (OneWire_ReadBlock (aScratchpad, 9, ONEWIRE_CRC_8, &nCRC))
+*	{
+*		//Scratchpad correcto
+*	}
+*
+* Resultado:
+*
+*	Los 9 bytes del scratchpad de un DS18B20 leidos y comprobados en una sola llamada
+*
+* @see OneWire_WriteBlock(), OneWire_ReceiveByteCRC()
+*/
+int1 OneWire_ReadBlock (int8* aDatos, int8 nBytes, int8 nTipoCRC, int16* pCRC)
+{
+	//-------------------------------------------------------------   
+	//Definicion de variables
+	//-------------------------------------------------------------   
+	int8 nByte;
+	int1 lCorrecto;
+#if !(defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482))
+	int8 nBit;															//Solo para el bus por software
+	byte cDato;
+	int1 lBit;
+#endif
+	_OneWire_EstMarca (nInicio)
+	//-------------------------------------------------------------   
+
+	_OneWire_EstInicio (nInicio)
+#if defined (ONEWIRE_ASYNC) || defined (ONEWIRE_UART) || defined (ONEWIRE_DS2482)
+#ifdef ONEWIRE_UART
+	OneWire_UartBloque (aDatos, nBytes, 1);
+#elif defined (ONEWIRE_DS2482)
+	OneWire_DS2482Bloque (aDatos, nBytes, 1);
+#else
+	OneWire_AsyncReadBlock (aDatos, nBytes);
+	OneWire_AsyncEspera ();
+#endif
+	for (nByte = 0; nByte < nBytes; nByte++)
+	{
+		_OneWire_AcumulaCRC (nTipoCRC, pCRC, aDatos[nByte]);
+	}
+#else
+	for (nByte = 0; nByte < nBytes; nByte++)
+	{
+		cDato = 0;
+		for (nBit = 0; nBit < 8; nBit++)
+		{
+			_OneWire_SlotLee (lBit, _ONEWIRE_T_BLOQUE_LECTURA_RECUPERA)
+			shift_right (&cDato, 1, lBit);
+		}
+		aDatos[nByte] = cDato;
+		_OneWire_AcumulaCRC (nTipoCRC, pCRC, cDato);
+	}
+#endif
+	_OneWire_EstSuma (nBytesRecibidos, nBytes)
+	_OneWire_EstTiempo (nTiempoBytes, nInicio)
+	if (nTipoCRC == ONEWIRE_CRC_8)
+	{
+		lCorrecto = *pCRC == 0;
+	}else if (nTipoCRC == ONEWIRE_CRC_16){
+		lCorrecto = *pCRC == ONEWIRE_CRC16_RESIDUO;
+	}else{
+		return 1;
+	}
+	_OneWire_EstCRC (lCorrecto)
+	return lCorrecto;
+}
+/**
+******************************************************
+* @brief Acumula un byte en el CRC de un bloque
+*
+* Funcion interna.
+*/
+void _OneWire_AcumulaCRC (int8 nTipoCRC, int16* pCRC, int8 cDato)
+{
+	if (nTipoCRC == ONEWIRE_CRC_8)
+	{
+		*pCRC = OneWire_CRC ((int8)*pCRC, cDato);
+	}else if (nTipoCRC == ONEWIRE_CRC_16){
+		*pCRC = OneWire_CRC16 (*pCRC, cDato);
+	}
+}
+/**
+******************************************************
 * @brief Lee la memoria ROM con el Id del dispositivo 1 Wire 
 *
 * Esta funcion solo se puede usar cuando hay un unico dispositivo en el bus
@@ -262,13 +675,13 @@ byte OneWire_ReceiveByte()
 *
 * @see OneWire_MatchROM(), OneWire_SkipROM (), OneWire_SearchROM ()
 */
-int* OneWire_ReadROM(void)
+int8* OneWire_ReadROM(void)
 {
 	//-------------------------------------------------------------	
 	//Definicion de variables
 	//-------------------------------------------------------------	
 	int8 nByte;
-	char *aRomId = malloc(8);											//Reservamos 8 bytes para almacenar la informacion de la ROM
+	int8 *aRomId = malloc(8);												//Reservamos 8 bytes para almacenar la informacion de la ROM
 	//-------------------------------------------------------------		
 
 	if (!OneWire_Reset ())
@@ -288,6 +701,9 @@ int* OneWire_ReadROM(void)
 *
 * El Dispositivo que contenga el Id enviado esperara la siguiente instruccion, el resto de los esclavos esperaran un pulso reset
 *
+* Si el dispositivo es el mismo de la llamada anterior, no ha habido otro comando ROM entre medias y su familia admite
+* Resume ( ONEWIRE_RESUME_FAMILIA ), se envia 0xA5 en lugar de 0x55 y los 64 bits del Id: 8 slots en lugar de 72
+*
 * @param aId Puntero al array con los 8 bytes de Id correspondientes al dispositivo a direccionar
 *
 * Ejemplo:
@@ -308,15 +724,28 @@ void OneWire_MatchROM (int8* aId)
 	//Definicion de variables
 	//-------------------------------------------------------------	
 	int8 nByte;
+	int1 lResume;
 	//-------------------------------------------------------------	
 
+	lResume = OneWire_Resume.lValido && ONEWIRE_RESUME_FAMILIA (aId[0]);
+	for (nByte=0;nByte<8 && lResume;nByte++)
+	{
+		lResume = (OneWire_Resume.aRom[nByte] == aId[nByte]);
+	}
 	if (!OneWire_Reset ())
 	{
-		OneWire_SendByte(0X55);
-		for (nByte=0;nByte<8;nByte++)
+		if (lResume)
 		{
-			OneWire_SendByte(aId[nByte]);
+			OneWire_SendByte(0XA5);
+		}else{
+			OneWire_SendByte(0X55);
+			OneWire_WriteBlock (aId, 8, ONEWIRE_CRC_NINGUNO, 0);
+			for (nByte=0;nByte<8;nByte++)
+			{
+				OneWire_Resume.aRom[nByte] = aId[nByte];
+			}
 		}
+		OneWire_Resume.lValido = 1;
 	}
 }
 /**
@@ -347,124 +776,87 @@ void OneWire_SkipROM ()
 }
 /**
 ******************************************************
-* @brief Permite leer los 64 bits de identificacion de todos los esclavos conectados al Bus
+* @brief Pasa a overdrive todos los dispositivos del Bus y los direcciona
 *
-* @post Es necesario liberar memoria con free()
+* El reset y el comando 0x3C se envian a velocidad estandar, a partir de ese momento el bus queda en overdrive.
+* Solo debe utilizarse cuando existe un unico esclavo en el Bus o cuando todos admiten overdrive
 *
-* @return Devuelve un puntero a un array con todos los Id's de los distintos esclavos
-* 
-* Por cada esclavo se almacenan 8 Bytes con la siguiente estructura
-*	
-*	00      -> Tipo dispositivo ( 10 para el DS1820,.... )
-*	01 a 06 -> 48 bit del Id del dispositivo ( unico pra cada chip )     
-*	07      -> CRC
+* @return Devuelve 0 si hay algun dispositivo conectado, 1 en caso contrario
+*
+* Ejemplo:
 *
-* Cada una de estas secuencas de 8 Bytes es la que se utiliza en el MatchROM para direccionar un dispositivo unico
+*	OneWire_OverdriveSkipROM ( );
+*	OneWire_SendByte (0x44);
 *
-* Funciones internas utilizadas
-*	- _OneWire_IniciaMapaColisiones()
-*	- _OneWire_SetBitColision()
-*	- _OneWire_LeeBitColision()
-*	- _OneWire_LimpiaMapaColisiones()
+* Resultado:
+*
+*	Comando 0x44 enviado en overdrive al unico dispositivo del Bus
+*
+* @see OneWire_SkipROM(), OneWire_OverdriveMatchROM(), OneWire_Velocidad()
+*/
+int1 OneWire_OverdriveSkipROM (void)
+{
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int1 lEstado;
+	//-------------------------------------------------------------	
 
+	OneWire_Velocidad (0);
+	lEstado = OneWire_Reset ();
+	if (!lEstado)
+	{
+		OneWire_SendByte(0X3C);
+		OneWire_Velocidad (1);
+	}
+	return lEstado;
+}
+/**
+******************************************************
+* @brief Pasa a overdrive un dispositivo del Bus y lo direcciona
 *
-* Ejemplo:
+* El reset y el comando 0x69 se envian a velocidad estandar y el Id ya en overdrive. El resto de dispositivos
+* sigue en velocidad estandar esperando un reset, por lo que el siguiente OneWire_Reset() en overdrive solo
+* lo atendera el dispositivo direccionado ( o se volvera a velocidad estandar si ya no responde )
 *
-*	int* aId;
+* @param aId Puntero al array con los 8 bytes de Id correspondientes al dispositivo a direccionar
+* @return Devuelve 0 si hay algun dispositivo conectado, 1 en caso contrario
 *
-*	aId = OneWire_SearchROM ();
-*	.
-*	.
-*	.
-*	free (aId);
+* Ejemplo:
+*
+*	int8 aId[8] = {0x28,0x30,0xC5,0xC8,0x00,0x00,0x00,0x5A};
 *
+*	OneWire_OverdriveMatchROM ( aId );
 *
 * Resultado:
 *
-*	Se alamacena en aId todas las direcciones de los esclavos
+*	Dispositivo aId direccionado y bus en overdrive
 *
-* @see OneWire_ReadROM(), OneWire_MatchROM(), OneWire_SkipROM() 
+* @see OneWire_MatchROM(), OneWire_OverdriveSkipROM(), OneWire_Velocidad()
 */
-int* OneWire_SearchROM (void)
+int1 OneWire_OverdriveMatchROM (int8* aId)
 {
-	//Esta funcion es compleja y es necesario interpretar la informacion de las especificaciones del protocolo para poder entnederla
-	//Cuando se envia el comando 0XF0 todos los escalvos responden con el primer bit de su Id y el siguiente bit que envian es el complemento de ese bit.
-	//Si todos tienen el primer bit igual, el complemento que se leera ser lo contario del inicial ( Ej, si el primer bit es un 1 para todos, el complemento es 0 )
-	//El maestro responde con el mismo bit y todos los esclavos pasan a enviar el siguiente bit
-	//Si algun esclavo tiene el bit distinto al resto, en el bit principal se recibira un 0 y en el complemento tambien se recibira 0
-	//En ese caso lo tratamos como una colision
-	//Enviamos primero un 0 con lo que solo responderan al siguiente bit todos los que tengan ese 0, los que tengan 1 se quedan a la espera de un reset
-	//pero tenemos que tener en cuenta que en la siguiente vuelta tenemos qu eponer un 1
-	//En la funcion, recorremos todo el id y primero tartamos la colision mas lejana y vamos recorriendo los id hacia el primer bit. 
 	//-------------------------------------------------------------	
 	//Definicion de variables
 	//-------------------------------------------------------------	
-	int8 aMapaColisiones[8];
-	int1 lBitLeido, lBitComplemento, lColision, lBusqueda;
-	int8 nPosBit, nBitColisionActual, nBitColisionAnterior;
-	int8 nByte, nBit, nDispositivo, nDispTmp, nColisiones ;
-	byte Pruebal;
-	int8 *aRomId = malloc(8);						//Reservamos 8 bytes para almacenar la informacion de la ROM
-	//-------------------------------------------------------------		
-	_OneWire_IniciaMapaColisiones (aMapaColisiones);
-	nDispositivo=0;
+	int8 nByte;
+	int1 lEstado;
+	//-------------------------------------------------------------	
 
-	if (!OneWire_Reset ())
+	OneWire_Velocidad (0);
+	lEstado = OneWire_Reset ();
+	if (!lEstado)
 	{
-
-		Pruebal=0;
-		nBitColisionActual=0;
-		lBusqueda=1;
-		nDispTmp=1;
-		nColisiones=0;
-
-		while (lBusqueda)
+		OneWire_SendByte(0X69);
+		OneWire_Velocidad (1);
+		for (nByte=0;nByte<8;nByte++)
 		{
-			Pruebal=0;
-			lColision=0;
-			OneWire_Reset ();
-			nPosBit = 0;
-			OneWire_SendByte(0XF0);
-			nBitColisionAnterior=0;
-			nBitColisionActual=0;
-			for (nByte=0;nByte<8;nByte++)
-			{
-				for (nBit=0;nBit<8;nBit++)
-				{
-					lBitLeido=OneWire_LeeBit();														//Recibimos bit principal 
-					lBitComplemento=OneWire_LeeBit();												//Recibimos bit complemento
-					if ( lBitLeido == 0  & lBitComplemento == 0 )									//Si el Bit principal y su complemento son iguales, hay coision
-					{
-						lBitLeido = _OneWire_LeeBitColision ( nPosBit, aMapaColisiones );			//Leemos del mapa de colisiones el bit que tenemos que enviar ( al principio es 0 )
-						nBitColisionAnterior=nBitColisionActual;									//En nBitCilisionAnterior nos quedara la posicion de la penultima colision									
-						nBitColisionActual=nPosBit;													//En nBitColisionActual nos quedara la ultima colision 
-						if ( lBitLeido )															//Si el bit a enviar es 1, hemos terminado con esta colision y debemos tratar
-						{																			//la anterio	
-							nBitColisionActual = nBitColisionAnterior;								//por lo que ponemos en colision actual la anteior ya que hemso llegado al final de la actual
-						}
-					}
-					OneWire_Write  ( lBitLeido );													//Escribimos en el bus el bit leido del bus o del mapa de colisiones segun corresponda
-					shift_right(&Pruebal,1,lBitLeido);												//Grabamos ese bit en el byte del id correspondiente al dispositivo actual
-					nPosBit++;	
-				}
-				aRomId[nByte+(nDispositivo*8)]=Pruebal;												//Cuando hemos recorrido un paquete de 8 bits, almacenamos en aRomId el Byte leido
-			} 
-			if ( nBitColisionActual == 0 & nBitcolisionAnterior == 0)
-			{
-				lBusqueda=0;
-			}else{
-
-				nDispositivo++;
-   				aRomId = realloc (aRomId, (nDispositivo+1)*8);										//Cuando hemos obtenido los 8 Bytes, 
-				_OneWire_SetBitColision (nBitColisionActual, aMapaColisiones);						//Grabamos 1 en el bit de colision que si hemos enviado el 0, estara en la ultima colision
-																									//Pero si era un 1 , esa colision se ha finalizado y pasamos a la colision anterior
-				_OneWire_LimpiaMapaColisiones (nBitColisionActual, aMapaColisiones);					//Borramos el mapa da colisiones delde el bit que hemos marcado como 1 pra poder buscar colisiones
-			}																						//en esta nueva rama
+			OneWire_SendByte(aId[nByte]);
+			OneWire_Resume.aRom[nByte] = aId[nByte];
 		}
+		OneWire_Resume.lValido = 1;										//Siguiente OneWire_MatchROM() del mismo dispositivo con Resume
 	}
-			delay_ms(10);
-			return aRomId;
-
+	return lEstado;
 }
 /**
 ******************************************************
@@ -472,7 +864,7 @@ int* OneWire_SearchROM (void)
 *
 * @post Es necesario liberar memoria con free()
 *
-* @return Devuelve un puntero a un array con todos los Id's de los distintos esclavos
+* @return Devuelve un puntero a un array con todos los Id's de los distintos esclavos, NULL si no hay memoria
 * 
 * Por cada esclavo se almacenan 8 Bytes con la siguiente estructura
 *	
@@ -480,18 +872,15 @@ int* OneWire_SearchROM (void)
 *	01 a 06 -> 48 bit del Id del dispositivo ( unico pra cada chip )     
 *	07      -> CRC
 *
-* Cada una de estas secuencas de 8 Bytes es la que se utiliza en el MatchROM para direccionar un dispositivo unico
+* Cada una de estas secuencas de 8 Bytes es la que se utiliza en el MatchROM para direccionar un dispositivo unico.
+* Tras el ultimo Id hay 8 bytes a 0 ( familia 0 ), que marcan el fin de la tabla; sin esclavos es lo unico que hay
 *
 * Funciones internas utilizadas
-*	- _OneWire_IniciaMapaColisiones()
-*	- _OneWire_SetBitColision()
-*	- _OneWire_LeeBitColision()
-*	- _OneWire_LimpiaMapaColisiones()
-
+*	- _OneWire_SearchPasada()
 *
 * Ejemplo:
 *
-*	int* aId;
+*	int8* aId;
 *
 *	aId = OneWire_SearchROM ();
 *	.
@@ -504,260 +893,944 @@ int* OneWire_SearchROM (void)
 *
 *	Se alamacena en aId todas las direcciones de los esclavos
 *
-* @see OneWire_ReadROM(), OneWire_MatchROM(), OneWire_SkipROM() 
+* @see OneWire_ReadROM(), OneWire_MatchROM(), OneWire_SkipROM(), OneWire_SearchFirst()
 */
-int* OneWire_CuentaDispositivos(void)
+int8* OneWire_SearchROM (void)
 {
-	//Esta funcion es similar a OneWire_SearchROM, la filosofia es la misma pero solo devuelve el Numero de Dispositivos
+	//Cada pasada por el arbol de Id's obtiene un dispositivo, ver _OneWire_SearchPasada()
 	//-------------------------------------------------------------	
 	//Definicion de variables
 	//-------------------------------------------------------------	
-	int8 aMapaColisiones[8];
-	int1 lBitLeido, lBitComplemento, lColision, lBusqueda;
-	int8 nPosBit, nBitColisionActual, nBitColisionAnterior;
-	int8 nByte, nBit, nDispositivo, nDispTmp, nColisiones ;
-	_OneWire_IniciaMapaColisiones (aMapaColisiones);
+	OneWire_Busqueda stBusqueda;
+	int8 nByte, nDispositivo;
+	int8 *aRomId = malloc(8);											//Reservamos 8 bytes para almacenar la informacion de la ROM
+	int8 *aAmpliado;
+	//-------------------------------------------------------------		
 
-	if (!OneWire_Reset ())
+	if (aRomId == NULL)
 	{
-
-		nDispositivo=1;
-
-		nBitColisionActual=0;
-		lBusqueda=1;
-		nDispTmp=1;
-		nColisiones=0;
-		while (lBusqueda)
+		return NULL;
+	}
+	nDispositivo = 0;
+	if (OneWire_SearchFirst (&stBusqueda, aRomId))
+	{
+		do
 		{
-			lColision=0;
-			OneWire_Reset ();
-			nPosBit = 0;
-			OneWire_SendByte(0XF0);
-			nBitColisionAnterior=0;
-			nBitColisionActual=0;
-			for (nByte=0;nByte<8;nByte++)
-			{
-				for (nBit=0;nBit<8;nBit++)
-				{
-					lBitLeido=OneWire_LeeBit();														//Recibimos bit principal 
-					lBitComplemento=OneWire_LeeBit();												//Recibimos bit complemento
-					if ( lBitLeido == 0  & lBitComplemento == 0 )							//Si el Bit principal y su complemento son iguales, hay coision
-					{
-						lBitLeido = _OneWire_LeeBitColision ( nPosBit, aMapaColisiones );	//Leemos del mapa de colisiones el bit que tenemos que enviar ( al principio es 0 )
-						nBitColisionAnterior=nBitColisionActual;							//En nBitCilisionAnterior nos quedara la posicion de la penultima colision									
-						nBitColisionActual=nPosBit;											//En nBitColisionActual nos quedara la ultima colision 
-						if ( lBitLeido )													//Si el bit a enviar es 1, hemos terminado con esta colision y debemos tratar
-						{																	//la anterio	
-							nBitColisionActual = nBitColisionAnterior;						//por lo que ponemos en colision actual la anteior ya que hemso llegado al final de la actual
-						}
-					}
-					OneWire_Write  ( lBitLeido );											//Escribimos en el bus el bit leido del bus o del mapa de colisiones segun corresponda
-					nPosBit++;	
-				}
-			} 
-			if ( nBitColisionActual == 0 & nBitcolisionAnterior == 0)
+			nDispositivo++;
+			aAmpliado = realloc (aRomId, ((int16)nDispositivo+1)*8);	//Hueco para el siguiente Id, en 8 bits se desborda a partir de 32
+			if (aAmpliado == NULL)
 			{
-				lBusqueda=0;
-			}else{
-
-				nDispositivo++;
-				_OneWire_SetBitColision (nBitColisionActual, aMapaColisiones);					//Grabamos 1 en el bit de colision que si hemos enviado el 0, estara en la ultima colision
-																							//Pero si era un 1 , esa colision se ha finalizado y pasamos a la colision anterior
-				_OneWire_LimpiaMapaColisiones (nBitColisionActual, aMapaColisiones);				//Borramos el mapa da colisiones delde el bit que hemos marcado como 1 pra poder buscar colisiones
-			}																				//en esta nueva rama
-		}
+				free (aRomId);
+				return NULL;
+			}
+			aRomId = aAmpliado;
+		} while (OneWire_SearchNext (&stBusqueda, &aRomId[(int16)nDispositivo*8]));
 	}
-			delay_ms(10);
-			return nDispositivo;
-
+	for (nByte=0;nByte<8;nByte++)										//El hueco que sobra marca el fin de la tabla
+	{
+		aRomId[(int16)nDispositivo*8 + nByte] = 0;
+	}
+	_OneWire_DelayMs (10);
+	return aRomId;
 }
 /**
 ******************************************************
-* @brief Funcion utilizada para el calculo del CRC 1 Wire
+* @brief Cuenta los esclavos conectados al Bus
 *
-* @param crc Este Byte es el dato del calculo del CRC con el byte anterior, inicialmente debe ser 0
-* @param nData Nuevo Byte de la cadena para el calculo del CRC 
+* Recorre el arbol de Id's igual que OneWire_SearchROM() pero sin almacenarlos
 *
+* Funciones internas utilizadas
+*	- _OneWire_SearchPasada()
+*
+* @return Numero de dispositivos en el bus
 *
 * Ejemplo:
 *
-*	int cDirDS1820[] = {16, 192, 196, 197, 198, 0, 0 };
-*	int nCRC = 0;
-*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[0] );
-*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[1] );
-*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[2] );
-*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[3] );
-*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[4] );
-*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[5] );
-*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[6] );
+*	int8 nDispositivos;
+*
+*	nDispositivos = OneWire_CuentaDispositivos ();
 *
 * Resultado:
 *
-*	nCRC = 99
+*	nDispositivos = 3
+*
+* @see OneWire_SearchROM(), OneWire_SearchFirst()
 */
-int OneWire_CRC ( int crc, int nData )
+int8 OneWire_CuentaDispositivos(void)
 {
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	OneWire_Busqueda stBusqueda;
+	int8 aRom[8];
+	int8 nDispositivo;
+	int1 lEncontrado;
+	//-------------------------------------------------------------	
 
-	int nBit = 0;
+	nDispositivo = 0;
+	for (lEncontrado = OneWire_SearchFirst (&stBusqueda, aRom); lEncontrado; lEncontrado = OneWire_SearchNext (&stBusqueda, aRom))
+	{
+		nDispositivo++;
+	}
+	_OneWire_DelayMs (10);
+	return nDispositivo;
+}
+/**
+******************************************************
+* @brief Inicia una busqueda de dispositivos y obtiene el primero
+*
+* A diferencia de OneWire_SearchROM() no reserva memoria. El estado de la busqueda se guarda en una estructura
+* del llamador y cada llamada a OneWire_SearchNext() obtiene el siguiente Id, por lo que la busqueda se puede
+* repartir entre otras tareas o abandonar en cualquier momento
+*
+* Funciones internas utilizadas
+*	- _OneWire_SearchPasada()
+*
+* @param pBusqueda Estructura con el estado de la busqueda
+* @param aRom Array de 8 bytes donde se deja el Id encontrado, con el CRC ya comprobado
+* @return 1 si se ha encontrado un dispositivo, 0 si no hay ninguno
+*
+* Ejemplo:
+*
+*	OneWire_Busqueda stBusqueda;
+*	int8 aTabla[10][8];
+*	int8 nDispositivos = 0;
+*	int1 lEncontrado;
+*
+*	lEncontrado = OneWire_SearchFirst (&stBusqueda, aTabla[0]);
+*	while (lEncontrado && nDispositivos < 10)
+*	{
+*		nDispositivos++;
+*		if (nDispositivos < 10)
+*		{
+*			lEncontrado = OneWire_SearchNext (&stBusqueda, aTabla[nDispositivos]);
+*		}
+*	}
+*
+* Resultado:
+*
+*	aTabla contiene los Id's de los dispositivos del bus ( hasta 10 ) sin usar memoria dinamica
+*
+* @see OneWire_SearchNext(), OneWire_SearchROM()
+*/
+int1 OneWire_SearchFirst (OneWire_Busqueda* pBusqueda, int8* aRom)
+{
+	pBusqueda->nUltimaDiscrepancia = 0;
+	pBusqueda->nUltimaDiscrepanciaFamilia = 0;
+	pBusqueda->lUltimoDispositivo = 0;
+	pBusqueda->cComando = 0xF0;
+	pBusqueda->lFamilia = 0;
+	pBusqueda->nReintentos = 0;
+	_OneWire_EstCuenta (nBusquedas)
+	return OneWire_SearchNext (pBusqueda, aRom);
+}
+/**
+******************************************************
+* @brief Inicia una busqueda limitada a los dispositivos de una familia y obtiene el primero
+*
+* Se prepara el camino con el codigo de familia y ceros y la ultima discrepancia en la posicion 64, de forma
+* que la primera pasada va directamente al primer Id de la familia. Las siguientes llamadas a OneWire_SearchNext()
+* solo recorren las ramas de esa familia y terminan en cuanto la siguiente discrepancia esta en el codigo de familia
+*
+* @param pBusqueda Estructura con el estado de la busqueda
+* @param cFamilia Codigo de familia ( 0x28 DS18B20, 0x10 DS1820,... )
+* @param aRom Array de 8 bytes donde se deja el Id encontrado
+* @return 1 si se ha encontrado un dispositivo de la familia, 0 si no hay ninguno
+*
+* Ejemplo:
+*
+*	OneWire_Busqueda stBusqueda;
+*	int8 aRom[8];
+*	int1 lEncontrado;
+*
+*	for (lEncontrado = OneWire_SearchFamilia (&stBusqueda, 0x28, aRom); lEncontrado; lEncontrado = OneWire_SearchNext (&stBusqueda, aRom))
+*	{
+*		//aRom es un DS18B20
+*	}
+*
+* Resultado:
+*
+*	Se recorren solo los DS18B20 del bus
+*
+* @see OneWire_SearchFirst(), OneWire_SearchNext(), OneWire_AlarmSearchFirst()
+*/
+int1 OneWire_SearchFamilia (OneWire_Busqueda* pBusqueda, int8 cFamilia, int8* aRom)
+{
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 nByte;
+	//-------------------------------------------------------------	
 
-	crc ^= nData;
-	for ( nBit = 0; nBit < 8; nBit++ )
+	pBusqueda->aRom[0] = cFamilia;
+	for (nByte=1;nByte<8;nByte++)
 	{
-		if (crc & 0x01)
-		{
-	    	crc = (crc >> 1) ^ 0x8C;
-		}else{
-	        crc >>= 1;			
-		}
-	    
+		pBusqueda->aRom[nByte] = 0;
 	}
-	return crc;
+	pBusqueda->nUltimaDiscrepancia = 64;
+	pBusqueda->nUltimaDiscrepanciaFamilia = 0;
+	pBusqueda->lUltimoDispositivo = 0;
+	pBusqueda->cComando = 0xF0;
+	pBusqueda->cFamilia = cFamilia;
+	pBusqueda->nReintentos = 0;
+	pBusqueda->lFamilia = 1;
+	_OneWire_EstCuenta (nBusquedas)
+	return OneWire_SearchNext (pBusqueda, aRom);
 }
 /**
 ******************************************************
-* @brief Inicializa el array del Mapa de Colisiones
+* @brief Inicia una busqueda condicional ( 0xEC ) y obtiene el primer dispositivo en alarma
 *
-* Funcion interna. 
+* Solo responden los dispositivos con la condicion de alarma activa, por lo que el tiempo de bus
+* depende del numero de dispositivos en alarma y no del total
 *
-* Pone a 0 todos los bits del mapa de colisiones
-*	
-* @param HBIt Array con los 64 bits del Mapa de Colisiones ( 8 Bytes )
+* @param pBusqueda Estructura con el estado de la busqueda
+* @param aRom Array de 8 bytes donde se deja el Id encontrado
+* @return 1 si hay algun dispositivo en alarma, 0 si no hay ninguno
 *
 * Ejemplo:
 *
-*		int8 aMapaColisiones[8];
+*	OneWire_Busqueda stBusqueda;
+*	int8 aRom[8];
+*	int8 nAlarmas = 0;
+*	int1 lEncontrado;
 *
-*		_OneWire_IniciaMapaColisiones (aMapaColisiones);
-*	.
+*	for (lEncontrado = OneWire_AlarmSearchFirst (&stBusqueda, aRom); lEncontrado; lEncontrado = OneWire_SearchNext (&stBusqueda, aRom))
+*	{
+*		nAlarmas++;
+*	}
 *
 * Resultado:
 *
-*	Pone a 0 todos los bits de aMapaColisiones
+*	nAlarmas = numero de dispositivos en alarma
+*
+* @see OneWire_SearchFirst(), OneWire_SearchNext()
+*/
+int1 OneWire_AlarmSearchFirst (OneWire_Busqueda* pBusqueda, int8* aRom)
+{
+	pBusqueda->nUltimaDiscrepancia = 0;
+	pBusqueda->nUltimaDiscrepanciaFamilia = 0;
+	pBusqueda->lUltimoDispositivo = 0;
+	pBusqueda->cComando = 0xEC;
+	pBusqueda->lFamilia = 0;
+	pBusqueda->nReintentos = 0;
+	_OneWire_EstCuenta (nBusquedas)
+	return OneWire_SearchNext (pBusqueda, aRom);
+}
+/**
+******************************************************
+* @brief Obtiene el siguiente dispositivo de una busqueda iniciada con OneWire_SearchFirst()
+*
+* Si la pasada falla ( nadie responde a mitad del Id, el CRC no coincide o se ha salido del camino del Id anterior )
+* se recupera el estado guardado antes de la pasada y se repite solo esa rama, hasta ONEWIRE_BUSQUEDA_REINTENTOS
+* veces. Un bit perdido por ruido no obliga a empezar la busqueda de nuevo ni hace perder los dispositivos que faltan.
+* Sin presencia o si nadie responde al primer bit la busqueda termina sin reintentos: un bus vacio o una busqueda
+* de alarmas sin dispositivos en alarma cuestan un solo reset y una pasada.
+* Si tras los reintentos el Id sigue fuera del camino pero su CRC es correcto se acepta ( el dispositivo anterior
+* se ha desconectado durante la busqueda )
 *
+* @param pBusqueda Estructura con el estado de la busqueda
+* @param aRom Array de 8 bytes donde se deja el Id encontrado, con el CRC ya comprobado
+* @return 1 si se ha encontrado un dispositivo, 0 si ya no quedan
 *
-* @see _OneWire_SetBitColision(), _OneWire_LeeBitColision, _OneWire_LimpiaMapaColisiones()
+* @see OneWire_SearchFirst()
 */
-void _OneWire_IniciaMapaColisiones (int* HBit)
+int1 OneWire_SearchNext (OneWire_Busqueda* pBusqueda, int8* aRom)
 {
-	int8 nBitLoop, nByteLoop;
-	for ( nByteLoop = 0; nByteLoop < 8; nByteLoop++ )
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 aCamino[8];
+	int8 nByte, nDiscrepancia, nDiscrepanciaFamilia, nIntento, nPasada;
+	int1 lPasada, lCamino;
+	_OneWire_EstMarca (nInicio)
+	//-------------------------------------------------------------	
+
+	if (pBusqueda->lUltimoDispositivo)
+	{
+		return 0;
+	}
+	for (nByte=0;nByte<8;nByte++)										//Estado para repetir la pasada
 	{
-		for ( nBitLoop = 0; nBitLoop < 8; nBitLoop++)
+		aCamino[nByte] = pBusqueda->aRom[nByte];
+	}
+	nDiscrepancia = pBusqueda->nUltimaDiscrepancia;
+	nDiscrepanciaFamilia = pBusqueda->nUltimaDiscrepanciaFamilia;
+	for (nIntento = 0; ; nIntento++)
+	{
+		_OneWire_EstInicio (nInicio)
+		nPasada = _OneWire_SearchPasada (pBusqueda);
+		_OneWire_EstTiempo (nTiempoBusqueda, nInicio)
+		lPasada = (nPasada == ONEWIRE_PASADA_CORRECTA);
+		lCamino = 1;
+		if (lPasada)
+		{
+			lPasada = OneWire_CRCBloque (0, pBusqueda->aRom, 8) == 0;
+			_OneWire_EstCRC (lPasada)
+			if (!(pBusqueda->lFamilia && nDiscrepancia == 64))				//La primera pasada de familia no sigue un Id real
+			{
+				lCamino = _OneWire_SearchCamino (aCamino, pBusqueda->aRom, nDiscrepancia);
+			}
+		}
+		if ((lPasada && lCamino) || nPasada == ONEWIRE_PASADA_VACIA || nIntento >= ONEWIRE_BUSQUEDA_REINTENTOS)
 		{
-			bit_clear (HBit[nByteLoop], nBitLoop);
+			break;
+		}
+		for (nByte=0;nByte<8;nByte++)
+		{
+			pBusqueda->aRom[nByte] = aCamino[nByte];
+		}
+		pBusqueda->nUltimaDiscrepancia = nDiscrepancia;
+		pBusqueda->nUltimaDiscrepanciaFamilia = nDiscrepanciaFamilia;
+		pBusqueda->lUltimoDispositivo = 0;
+		pBusqueda->nReintentos++;
+		_OneWire_EstCuenta (nReintentosBusqueda)
+	}
+	if (!lPasada)
+	{
+		pBusqueda->nUltimaDiscrepancia = 0;								//Sin dispositivos o fallo repetido, la busqueda termina
+		pBusqueda->nUltimaDiscrepanciaFamilia = 0;
+		pBusqueda->lUltimoDispositivo = 1;
+		return 0;
+	}
+	if (pBusqueda->lFamilia)
+	{
+		if (pBusqueda->aRom[0] != pBusqueda->cFamilia)					//Ya estamos fuera de la familia
+		{
+			pBusqueda->lUltimoDispositivo = 1;
+			return 0;
+		}
+		if (pBusqueda->nUltimaDiscrepancia <= 8)						//La siguiente rama ya cambia el codigo de familia
+		{
+			pBusqueda->lUltimoDispositivo = 1;
 		}
 	}
+	for (nByte=0;nByte<8;nByte++)
+	{
+		aRom[nByte] = pBusqueda->aRom[nByte];
+	}
+	return 1;
 }
 /**
 ******************************************************
-* @brief Limpia el array del Mapa de Colisiones a partir de un determinado Bit
+* @brief Comprueba si un dispositivo conocido sigue en el bus
 *
-* Funcion interna. 
+* Hace una sola pasada de busqueda siguiendo los bits del Id ( _OneWire_SearchDirigida() ), sin recorrer el
+* arbol. Si el dispositivo no esta la pasada termina en el primer bit que ya no tiene ningun dispositivo
+*
+* @param aRom Id de 8 bytes del dispositivo
+* @return ONEWIRE_VERIFICA_PRESENTE, ONEWIRE_VERIFICA_AUSENTE o ONEWIRE_VERIFICA_CRC si el Id no es valido ( no se usa el bus )
+*
+* Ejemplo:
+*
+*	if (OneWire_Verifica (aSensor) != ONEWIRE_VERIFICA_PRESENTE)
+*	{
+*		//El sensor se ha desconectado
+*	}
 *
-* Cuando se detecta una posicion de bit con colision, se ponen a 0 todos los bits posteriores
-* a la posicion con colision para iniciar una nueva rama
+* Resultado:
 *
-* @param nPosBit Posicion de bit desde donde se quiere limpiar	
-* @param HBIt Array con los 64 bits del Mapa de Colisiones ( 8 Bytes )
+*	Una pasada de 64 bits en lugar de una busqueda completa
+*
+* @see OneWire_VerificaLista(), OneWire_SearchFirst()
+*/
+int8 OneWire_Verifica (int8* aRom)
+{
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 aDiscrepancias[8];
+	//-------------------------------------------------------------	
+
+	if (OneWire_CRCBloque (0, aRom, 8) != 0)
+	{
+		return ONEWIRE_VERIFICA_CRC;
+	}
+	if (_OneWire_SearchDirigida (aRom, aDiscrepancias) != 64)
+	{
+		return ONEWIRE_VERIFICA_AUSENTE;
+	}
+	return ONEWIRE_VERIFICA_PRESENTE;
+}
+/**
+******************************************************
+* @brief Comprueba una lista de dispositivos conocidos
+*
+* Cada pasada dirigida dice tambien que ramas del arbol existen junto al camino seguido. Si el siguiente Id se
+* separa del ultimo Id comprobado en una posicion sin discrepancia, o mas alla del bit en el que fallo la
+* pasada, ese dispositivo no esta y no se usa el bus. Solo se hace una pasada por cada dispositivo presente
+* y por los ausentes cuya rama todavia tiene dispositivos.
+*
+* Los prefijos comunes se aprovechan si la lista esta en el orden en el que la devuelve la busqueda
+* ( OneWire_SearchROM(), OneWire_Inventario )
+*
+* @param aRoms Id's de los dispositivos, 8 bytes seguidos cada uno
+* @param nDispositivos Numero de Id's de la lista
+* @param aResultados Array donde se deja el resultado de cada Id ( ONEWIRE_VERIFICA_xxx )
+* @return Numero de dispositivos presentes
 *
 * Ejemplo:
 *
-*		int8 aMapaColisiones[8];
+*	int8 aSensores[20][8];
+*	int8 aEstado[20];
 *
-*		_OneWire_LimpiaMapaColisiones ( 45, aMapaColisiones);
-*	.
+*	if (OneWire_VerificaLista (aSensores, 20, aEstado) < 20)
+*	{
+*		//aEstado indica los que faltan
+*	}
 *
 * Resultado:
 *
-*	Pone a 0 todos los bits siguientes a la posicion 45
+*	Una pasada por sensor presente; los de una rama que ha desaparecido se resuelven casi sin usar el bus
+*
+* @see OneWire_Verifica()
+*/
+int8 OneWire_VerificaLista (int8* aRoms, int8 nDispositivos, int8* aResultados)
+{
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 aDiscrepancias[8];
+	int8 nDispositivo, nPasada, nBits, nPosicion, nPresentes;
+	int8* aRom;
+	//-------------------------------------------------------------	
+
+	nPresentes = 0;
+	nPasada = ONEWIRE_VERIFICA_NINGUNA;
+	for (nDispositivo = 0; nDispositivo < nDispositivos; nDispositivo++)
+	{
+		aRom = &aRoms[(int16)nDispositivo * 8];
+		if (OneWire_CRCBloque (0, aRom, 8) != 0)
+		{
+			aResultados[nDispositivo] = ONEWIRE_VERIFICA_CRC;
+			continue;
+		}
+		if (nPasada != ONEWIRE_VERIFICA_NINGUNA)							//Lo que ya sabemos por la ultima pasada
+		{
+			nPosicion = _OneWire_RomDiferencia (&aRoms[(int16)nPasada * 8], aRom);
+			if (nPosicion == 0)
+			{
+				aResultados[nDispositivo] = aResultados[nPasada];			//Id repetido
+			}else if (nPosicion > nBits + 1){
+				aResultados[nDispositivo] = ONEWIRE_VERIFICA_AUSENTE;			//Comparte el camino que ya no tiene dispositivos
+			}else if (nPosicion <= nBits && !bit_test (aDiscrepancias[(nPosicion - 1) >> 3], (nPosicion - 1) & 7)){
+				aResultados[nDispositivo] = ONEWIRE_VERIFICA_AUSENTE;			//En esa posicion todos tenian el otro bit
+			}else{
+				nPosicion = 0xFF;
+			}
+			if (nPosicion != 0xFF)
+			{
+				if (aResultados[nDispositivo] == ONEWIRE_VERIFICA_PRESENTE)
+				{
+					nPresentes++;
+				}
+				continue;
+			}
+		}
+		nBits = _OneWire_SearchDirigida (aRom, aDiscrepancias);
+		nPasada = nDispositivo;
+		if (nBits == 64)
+		{
+			aResultados[nDispositivo] = ONEWIRE_VERIFICA_PRESENTE;
+			nPresentes++;
+		}else{
+			aResultados[nDispositivo] = ONEWIRE_VERIFICA_AUSENTE;
+		}
+	}
+	return nPresentes;
+}
+/**
+******************************************************
+* @brief Recorre una rama del arbol de Id's
+*
+* Funcion interna. 
 *
+* En cada posicion de bit los dispositivos que siguen en la busqueda envian su bit y el complemento.
+* Si ambos son 0 hay dispositivos con los dos valores ( discrepancia ). Por debajo de la ultima discrepancia
+* se repite el camino del Id anterior, en la ultima se toma el 1 y por encima el 0. La discrepancia
+* mas alta en la que se ha tomado el 0 es la que habra que cambiar en la siguiente pasada.
+* Cada posicion se resuelve con un solo OneWire_Triplet()
 *
-* @see _OneWire_SetBitColision(), _OneWire_LeeBitColision(), _OneWire_IniciaMapaColisiones()
+* @param pBusqueda Estructura con el estado de la busqueda, se actualiza con el Id encontrado
+* @return ONEWIRE_PASADA_CORRECTA si se han leido los 64 bits, ONEWIRE_PASADA_VACIA si no hay presencia o nadie
+* responde al primer bit y ONEWIRE_PASADA_FALLIDA si nadie responde mas adelante
+*
+* @see OneWire_SearchNext()
 */
+int8 _OneWire_SearchPasada (OneWire_Busqueda* pBusqueda)
+{
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 nPosBit, nUltimoCero, nByte, nMascara, nTriplet;
+	int1 lDireccion;
+	//-------------------------------------------------------------	
 
-void _OneWire_LimpiaMapaColisiones ( int nPosBit, int* HBit )
+	_OneWire_EstCuenta (nPasadas)
+	if (OneWire_Reset ())
+	{
+		return ONEWIRE_PASADA_VACIA;
+	}
+	OneWire_SendByte (pBusqueda->cComando);
+	nUltimoCero = 0;
+	nByte = 0;
+	nMascara = 1;
+	for (nPosBit = 1; nPosBit <= 64; nPosBit++)								//Las posiciones se numeran de 1 a 64, 0 indica que no hay discrepancia
+	{
+		if (nPosBit < pBusqueda->nUltimaDiscrepancia)						//Direccion a tomar si hay discrepancia
+		{
+			lDireccion = (pBusqueda->aRom[nByte] & nMascara) != 0;
+		}else{
+			lDireccion = (nPosBit == pBusqueda->nUltimaDiscrepancia);
+		}
+		nTriplet = OneWire_Triplet (lDireccion);
+		if ((nTriplet & ONEWIRE_TRIPLET_BITS) == ONEWIRE_TRIPLET_BITS)		//Nadie ha respondido
+		{
+			if (nPosBit == 1)												//Ningun dispositivo en la busqueda ( o en alarma )
+			{
+				return ONEWIRE_PASADA_VACIA;
+			}
+			return ONEWIRE_PASADA_FALLIDA;
+		}
+		if ((nTriplet & ONEWIRE_TRIPLET_BITS) == 0 && !(nTriplet & ONEWIRE_TRIPLET_DIRECCION))
+		{
+			nUltimoCero = nPosBit;											//Discrepancia en la que hemos tomado el 0
+			if (nUltimoCero <= 8)
+			{
+				pBusqueda->nUltimaDiscrepanciaFamilia = nUltimoCero;
+			}
+		}
+		if (nTriplet & ONEWIRE_TRIPLET_DIRECCION)
+		{
+			pBusqueda->aRom[nByte] |= nMascara;
+		}else{
+			pBusqueda->aRom[nByte] &= ~nMascara;
+		}
+		nMascara <<= 1;
+		if (nMascara == 0)
+		{
+			nByte++;
+			nMascara = 1;
+		}
+	}
+	pBusqueda->nUltimaDiscrepancia = nUltimoCero;
+	if (nUltimoCero == 0)
+	{
+		pBusqueda->lUltimoDispositivo = 1;
+	}
+	return ONEWIRE_PASADA_CORRECTA;
+}
+/**
+******************************************************
+* @brief Comprueba que una pasada ha seguido el camino del Id anterior
+*
+* Funcion interna. Por debajo de la discrepancia a cambiar la pasada debe repetir los bits del Id anterior y en
+* ella debe tomar el 1. Si no es asi algun bit se ha leido mal ( o los dispositivos de esa rama ya no estan )
+*
+* @param aAnterior Id de la pasada anterior
+* @param aRom Id obtenido en la pasada
+* @param nDiscrepancia Discrepancia que se ha cambiado en la pasada ( 1 a 64, 0 en la primera )
+* @return 1 si el camino es correcto
+*/
+int1 _OneWire_SearchCamino (int8* aAnterior, int8* aRom, int8 nDiscrepancia)
 {
-	int8 nBit, nByte;
-	int8 nBitLoop, nByteLoop;
-	nPosBit++;
-	nByte = nPosBit/8;
-	nBit = nPosbit-(nByte*8);
-	for ( nByteLoop = nByte; nByteLoop < 8; nByteLoop++ )
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 nPosBit, nByte, nMascara;
+	//-------------------------------------------------------------	
+
+	nByte = 0;
+	nMascara = 1;
+	for (nPosBit = 1; nPosBit <= nDiscrepancia; nPosBit++)
 	{
-		for ( nBitLoop = nBit; nBitLoop < 8; nBitLoop++)
+		if (nPosBit < nDiscrepancia)
 		{
-			bit_clear (HBit[nByteLoop], nBitLoop);
+			if ((aRom[nByte] ^ aAnterior[nByte]) & nMascara)
+			{
+				return 0;
+			}
+		}else if (!(aRom[nByte] & nMascara)){
+			return 0;
+		}
+		nMascara <<= 1;
+		if (nMascara == 0)
+		{
+			nByte++;
+			nMascara = 1;
 		}
-		nBit=0;
 	}
+	return 1;
+}
+/**
+******************************************************
+* @brief Recorre la rama del arbol de Id's que lleva a un Id conocido
+*
+* Funcion interna. 
+*
+* Es una pasada de busqueda en la que la direccion de cada posicion la fija el Id, no la ultima discrepancia.
+* Si el dispositivo esta en el bus se leen los 64 bits; si no, en algun punto nadie responde o solo responden
+* dispositivos con el bit contrario. Las discrepancias encontradas por el camino indican que hay dispositivos
+* en otras ramas, lo que permite detectar dispositivos nuevos sin recorrer todo el arbol
+*
+* @param aRom Id de 8 bytes a seguir
+* @param aDiscrepancias Array de 8 bytes donde se marcan las posiciones con discrepancia ( bit 0 del byte 0 = posicion 1 )
+* @return Bits del Id que tiene algun dispositivo del bus: 64 si el dispositivo esta, n si los hay con los n
+* primeros bits pero ninguno con el bit n+1, 0 si no hay pulso de presencia
+*
+* @see _OneWire_SearchPasada(), OneWire_Verifica()
+*/
+int8 _OneWire_SearchDirigida (int8* aRom, int8* aDiscrepancias)
+{
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 nPosBit, nByte, nMascara, nTriplet;
+	int1 lDireccion;
+	//-------------------------------------------------------------	
 
+	_OneWire_EstCuenta (nPasadasDirigidas)
+	for (nByte=0;nByte<8;nByte++)
+	{
+		aDiscrepancias[nByte] = 0;
+	}
+	if (OneWire_Reset ())
+	{
+		return 0;
+	}
+	OneWire_SendByte (0xF0);
+	nByte = 0;
+	nMascara = 1;
+	for (nPosBit = 1; nPosBit <= 64; nPosBit++)
+	{
+		lDireccion = (aRom[nByte] & nMascara) != 0;
+		nTriplet = OneWire_Triplet (lDireccion);
+		if ((nTriplet & ONEWIRE_TRIPLET_BITS) == ONEWIRE_TRIPLET_BITS)		//Nadie ha respondido
+		{
+			return nPosBit - 1;
+		}
+		if ((nTriplet & ONEWIRE_TRIPLET_BITS) == 0)
+		{
+			aDiscrepancias[nByte] |= nMascara;
+		}
+		if (((nTriplet & ONEWIRE_TRIPLET_DIRECCION) != 0) != lDireccion)	//Solo quedan dispositivos con el bit contrario
+		{
+			return nPosBit - 1;
+		}
+		nMascara <<= 1;
+		if (nMascara == 0)
+		{
+			nByte++;
+			nMascara = 1;
+		}
+	}
+	return 64;
 }
+/**
+******************************************************
+* @brief Primera posicion en la que se separan dos Id's
+*
+* Funcion interna. Las posiciones se numeran como en la busqueda, de 1 ( bit 0 del byte 0 ) a 64
+*
+* @return Posicion del primer bit distinto, 0 si los Id's son iguales
+*/
+int8 _OneWire_RomDiferencia (int8* aRom1, int8* aRom2)
+{
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 nByte, nBit, nDiferencia;
+	//-------------------------------------------------------------	
 
+	for (nByte = 0; nByte < 8; nByte++)
+	{
+		nDiferencia = aRom1[nByte] ^ aRom2[nByte];
+		if (nDiferencia)
+		{
+			for (nBit = 0; !bit_test (nDiferencia, nBit); nBit++)
+			{
+			}
+			return nByte * 8 + nBit + 1;
+		}
+	}
+	return 0;
+}
 /**
 ******************************************************
-* @brief Lee un bit del mapa de colisiones
+* @brief Confirma con pasadas dirigidas que en el bus estan exactamente los Id's de una tabla
 *
-* Funcion interna. 
+* Funcion interna. Un dispositivo nuevo comparte con alguno de los conocidos un camino hasta la posicion en la que
+* se separa. Al seguir ese Id conocido aparece una discrepancia en esa posicion que ningun otro Id conocido explica,
+* asi que basta comparar las discrepancias de cada pasada con las posiciones en las que los demas Id's se separan
+* del seguido. Una discrepancia solo dice que hay algun dispositivo en cada rama, no cual, por eso cada Id necesita
+* su propia pasada completa. Las usan OneWire_Inventario y OneWire_Lista
+*
+* @param aRoms Id's, 8 bytes seguidos cada uno
+* @param nDispositivos Numero de Id's, con 0 solo se comprueba que nadie responde al reset
+* @return 1 si el bus coincide con la tabla, 0 si hay que recorrer el arbol
+*/
+int1 _OneWire_ConfirmaRoms (int8* aRoms, int8 nDispositivos)
+{
+	//-------------------------------------------------------------	
+	//Definicion de variables
+	//-------------------------------------------------------------	
+	int8 aDiscrepancias[8], aEsperadas[8];
+	int8 nDispositivo, nOtro, nByte, nPosicion;
+	int8* aRom;
+	//-------------------------------------------------------------	
+
+	if (nDispositivos == 0)
+	{
+		return OneWire_Reset ();											//Sin pulso de presencia el bus sigue vacio
+	}
+	for (nDispositivo = 0; nDispositivo < nDispositivos; nDispositivo++)
+	{
+		aRom = &aRoms[(int16)nDispositivo * 8];
+		if (_OneWire_SearchDirigida (aRom, aDiscrepancias) != 64)
+		{
+			return 0;
+		}
+		for (nByte = 0; nByte < 8; nByte++)
+		{
+			aEsperadas[nByte] = 0;
+		}
+		for (nOtro = 0; nOtro < nDispositivos; nOtro++)
+		{
+			nPosicion = _OneWire_RomDiferencia (aRom, &aRoms[(int16)nOtro * 8]);
+			if (nPosicion != 0)
+			{
+				bit_set (aEsperadas[(nPosicion - 1) >> 3], (nPosicion - 1) & 7);
+			}
+		}
+		for (nByte = 0; nByte < 8; nByte++)
+		{
+			if (aDiscrepancias[nByte] != aEsperadas[nByte])
+			{
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+/**
+******************************************************
+* @brief Tablas del CRC 1 Wire ( X^8 + X^5 + X^4 + 1 )
 *
-* @param nPosBit Posicion del bit que se quiere leer
-* @param HBIt Array con los 64 bits del Mapa de Colisiones ( 8 Bytes )
+* OneWire_TablaCRC contiene el resultado de los 8 desplazamientos para cada valor del byte ( 256 bytes de ROM ).
+* En los PIC con poca memoria de programa se puede definir ONEWIRE_CRC_NIBBLE y se usa OneWire_TablaCRCNibble,
+* que resuelve 4 desplazamientos por consulta con solo 16 bytes
+*/
+#ifdef ONEWIRE_CRC_NIBBLE
+const int8 OneWire_TablaCRCNibble[16] = {
+	0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8, 0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74
+};
+#else
+const int8 OneWire_TablaCRC[256] = {
+	0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+	0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+	0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+	0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+	0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5, 0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+	0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+	0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+	0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B, 0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+	0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+	0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+	0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C, 0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+	0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+	0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+	0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4, 0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+	0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+	0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35
+};
+#endif
+/**
+******************************************************
+* @brief Funcion utilizada para el calculo del CRC 1 Wire
 *
-* Ejemplo:
+* El calculo se hace por tabla, ver OneWire_TablaCRC. Para calcular el CRC de un bloque es mas rapido usar OneWire_CRCBloque()
 *
-*		int8 aMapaColisiones[8];
-*		int1 lBit;
+* @param crc Este Byte es el dato del calculo del CRC con el byte anterior, inicialmente debe ser 0
+* @param nData Nuevo Byte de la cadena para el calculo del CRC 
 *
-*		lBit=_OneWire_LeeBitColision (45, aMapaColisiones);
-*	.
+*
+* Ejemplo:
+*
+*	int cDirDS1820[] = {16, 192, 196, 197, 198, 0, 0 };
+*	int nCRC = 0;
+*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[0] );
+*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[1] );
+*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[2] );
+*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[3] );
+*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[4] );
+*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[5] );
+*	nCRC = OneWire_CRC ( nCRC, cDirDS1820[6] );
 *
 * Resultado:
 *
-*	lBit = 1
+*	nCRC = 99
+*
+* @see OneWire_CRCBloque(), OneWire_ReceiveByteCRC()
+*/
+int OneWire_CRC ( int crc, int nData )
+{
+#ifdef ONEWIRE_CRC_NIBBLE
+	crc ^= nData;
+	crc = (crc >> 4) ^ OneWire_TablaCRCNibble[crc & 0x0F];				//Procesamos el nibble bajo
+	crc = (crc >> 4) ^ OneWire_TablaCRCNibble[crc & 0x0F];				//y a continuacion el alto
+	return crc;
+#else
+	return OneWire_TablaCRC[(int8)(crc ^ nData)];						//Una sola consulta a la tabla sustituye a los 8 desplazamientos
+#endif
+}
+/**
+******************************************************
+* @brief Calcula el CRC 1 Wire de un bloque de bytes
+*
+* @param nCRC CRC de partida, 0 para empezar un calculo nuevo
+* @param aDatos Puntero a los bytes
+* @param nBytes Numero de bytes
+* @return CRC del bloque. Si el ultimo byte del bloque es el CRC, el resultado es 0 cuando los datos son correctos
+*
+* Ejemplo:
+*
+*	int8 aId[8] = {0x10, 0x30, 0xC5, 0xC8, 0x00, 0x00, 0x00, 0xC3};
+*	int8 nCRC;
+*
+*	nCRC = OneWire_CRCBloque ( 0, aId, 8 );
 *
+* Resultado:
 *
-* @see _OneWire_SetBitColision(), _OneWire_LimpiaMapaColisiones(), _OneWire_IniciaMapaColisiones()
+*	nCRC = 0 si el Id es correcto
+*
+* @see OneWire_CRC(), OneWire_ReceiveByteCRC()
 */
-
-int1 _OneWire_LeeBitColision ( int nPosBit, int* HBit )
+int8 OneWire_CRCBloque ( int8 nCRC, int8* aDatos, int8 nBytes )
 {
-	int8 nBit, nByte;
-	nByte = nPosBit/8;
-	nBit = nPosbit-(nByte*8);
-	return bit_test (HBit[nByte], nBit);	
+	while ( nBytes-- )
+	{
+		nCRC = OneWire_CRC ( nCRC, *aDatos++ );
+	}
+	return nCRC;
 }
 /**
 ******************************************************
-* @brief Pone a 1 un bit en el mapa de colisiones
+* @brief Tablas del CRC16 1 Wire ( X^16 + X^15 + X^2 + 1 )
 *
-* Funcion interna. 
+* Es el CRC de los comandos y paginas de las memorias ( DS2431, DS28EC20,... ). Igual que en el CRC de 8 bits, con
+* ONEWIRE_CRC_NIBBLE se usa una tabla de 16 entradas en lugar de la de 256
+*/
+#ifdef ONEWIRE_CRC_NIBBLE
+const int16 OneWire_TablaCRC16Nibble[16] = {
+	0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401, 0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400
+};
+#else
+const int16 OneWire_TablaCRC16[256] = {
+	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+#endif
+/**
+******************************************************
+* @brief Acumula un byte en el CRC16 1 Wire
 *
-* @param nPosBit Posicion del bit que se quiere poner a 1
-* @param HBIt Array con los 64 bits del Mapa de Colisiones ( 8 Bytes )
+* Los dispositivos envian el CRC16 invertido, por eso el CRC16 de los datos seguidos del CRC recibido
+* es ONEWIRE_CRC16_RESIDUO cuando son correctos
+*
+* @param nCRC CRC de partida, 0 para empezar un calculo nuevo
+* @param nDato Nuevo byte
+* @return CRC actualizado
 *
 * Ejemplo:
 *
-*		int8 aMapaColisiones[8];
+*	int16 nCRC = 0;
 *
-*		_OneWire_SetBitColision (45, aMapaColisiones);
-*	.
+*	nCRC = OneWire_CRC16 ( nCRC, 0xF0 );
+*	nCRC = OneWire_CRC16 ( nCRC, 0x00 );
+*	nCRC = OneWire_CRC16 ( nCRC, 0x00 );
 *
 * Resultado:
 *
-*	Pone a 1 el bit 45 dentro del mapa de colisines ( 64 Bit )
+*	~nCRC es el CRC16 que envia un DS2431 tras el comando Read Memory de la direccion 0
 *
+* @see OneWire_CRC(), OneWire_ReadBlock()
+*/
+int16 OneWire_CRC16 ( int16 nCRC, int8 nDato )
+{
+#ifdef ONEWIRE_CRC_NIBBLE
+	nCRC ^= nDato;
+	nCRC = (nCRC >> 4) ^ OneWire_TablaCRC16Nibble[nCRC & 0x0F];
+	nCRC = (nCRC >> 4) ^ OneWire_TablaCRC16Nibble[nCRC & 0x0F];
+	return nCRC;
+#else
+	return (nCRC >> 8) ^ OneWire_TablaCRC16[(int8)(nCRC ^ nDato)];
+#endif
+}
+#ifdef ONEWIRE_ESTADISTICAS
+/**
+******************************************************
+* @brief Pone a 0 todos los contadores de OneWire_Est
 *
-* @see _OneWire_LeeBitColision(), _OneWire_LimpiaMapaColisiones(), _OneWire_IniciaMapaColisiones()
+* @see OneWire_EstadisticasCaptura()
 */
-void _OneWire_SetBitColision ( int nPosBit, int* HBit )
+void OneWire_EstadisticasBorra (void)
 {
-	//-------------------------------------------------------------	
-	//Definicion de variables
-	//-------------------------------------------------------------	
-	int8 nBit, nByte;
-	//-------------------------------------------------------------	
-
-	nByte = nPosBit/8;
-	nBit = nPosbit-(nByte*8);
-	bit_set (HBit[nByte], nBit);
-	return;
+	memset (&OneWire_Est, 0, sizeof (OneWire_Est));
+}
+/**
+******************************************************
+* @brief Copia los contadores en una estructura del llamador
+*
+* Permite comparar dos instantes, o dos versiones del programa, restando las copias campo a campo
+*
+* @param pCopia Estructura donde se copian los contadores
+*
+* Ejemplo:
+*
+*	OneWire_Estadisticas stAntes, stDespues;
+*
+*	OneWire_EstadisticasCaptura (&stAntes);
+*	OneWire_CuentaDispositivos ();
+*	OneWire_EstadisticasCaptura (&stDespues);
+*
+* Resultado:
+*
+*	stDespues.nPasadas - stAntes.nPasadas = pasadas que ha necesitado la busqueda
+*
+* @see OneWire_EstadisticasBorra()
+*/
+void OneWire_EstadisticasCaptura (OneWire_Estadisticas* pCopia)
+{
+	memcpy (pCopia, &OneWire_Est, sizeof (OneWire_Est));
 }
+#endif
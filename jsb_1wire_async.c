@@ -0,0 +1,329 @@
+/**
+******************************************************
+* @file jsb_1wire_async.c
+* @brief Motor no bloqueante del bus 1Wire gobernado por la interrupcion de un temporizador
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+OneWire_AsyncEstado OneWire_Async;
+
+/**
+******************************************************
+* @brief Da por terminada la operacion en curso
+*
+* Funcion interna. Libera el motor y llama a ONEWIRE_ASYNC_CALLBACK si esta definida
+*/
+void _OneWire_AsyncFin (void)
+{
+	OneWire_Async.nFase = ONEWIRE_ASYNC_LIBRE;
+	OneWire_Async.lBloque = 0;
+	OneWire_Async.lOcupado = 0;
+#ifdef ONEWIRE_ASYNC_CALLBACK
+	ONEWIRE_ASYNC_CALLBACK ();
+#endif
+}
+/**
+******************************************************
+* @brief Inicia un slot de bit de la operacion en curso
+*
+* Funcion interna. Hace la parte del slot que no admite retrasos y devuelve el tiempo que falta hasta
+* el final del slot, que se espera con el temporizador
+*
+* @return Tiempo en us hasta la siguiente fase
+*/
+int16 _OneWire_AsyncSlot (void)
+{
+	if (OneWire_Async.lLectura)
+	{
+		_OneWire_PinLow ();												//Igual que OneWire_LeeBit(), pulso corto y lectura en el instante de muestreo
+		_OneWire_DelayUs (OneWire_Perfil.nLecturaBajo);
+		_OneWire_PinFloat ();
+		_OneWire_DelayUs (OneWire_Perfil.nLecturaMuestreo);
+		OneWire_Async.lBit = _OneWire_PinRead ();
+		shift_right (OneWire_Async.pDatos, 1, OneWire_Async.lBit);
+		OneWire_Async.nFase = ONEWIRE_ASYNC_LECTURA_FIN;
+		return OneWire_Async.lBloque ? OneWire_Perfil.nBloqueLecturaRecupera : OneWire_Perfil.nLecturaRecupera;
+	}
+	_OneWire_PinLow ();													//Igual que OneWire_Write(), pulso corto a 0 y resto del slot con el bit
+	_OneWire_DelayUs (OneWire_Perfil.nEscrituraBajo);
+	if (bit_test (*OneWire_Async.pDatos, OneWire_Async.nBit))
+	{
+		_OneWire_PinHigh ();
+	}
+	OneWire_Async.nFase = ONEWIRE_ASYNC_ESCRITURA_FIN;
+	return OneWire_Async.lBloque ? OneWire_Perfil.nBloqueEscrituraBit : OneWire_Perfil.nEscrituraBit;
+}
+/**
+******************************************************
+* @brief Pasa al siguiente bit de la operacion en curso
+*
+* Funcion interna.
+*
+* @return Tiempo en us hasta la siguiente fase, 0 si la operacion ha terminado
+*/
+int16 _OneWire_AsyncSiguienteBit (void)
+{
+	if (++OneWire_Async.nBit == OneWire_Async.nBitsByte)
+	{
+		if (OneWire_Async.lLectura && OneWire_Async.nBitsByte < 8)			//En lectura de un bit el bit leido queda en la parte alta
+		{
+			*OneWire_Async.pDatos >>= 8 - OneWire_Async.nBitsByte;
+		}
+		OneWire_Async.nBit = 0;
+		OneWire_Async.pDatos++;
+		if (--OneWire_Async.nBytes == 0)
+		{
+			_OneWire_AsyncFin ();
+			return 0;
+		}
+	}
+	return _OneWire_AsyncSlot ();
+}
+/**
+******************************************************
+* @brief Ejecuta la siguiente fase de la operacion en curso
+*
+* Funcion interna. Se llama al lanzar la operacion y en cada interrupcion del temporizador
+*
+* @return Tiempo en us hasta la siguiente fase, 0 si la operacion ha terminado
+*/
+int16 _OneWire_AsyncPaso (void)
+{
+	switch (OneWire_Async.nFase)
+	{
+		case ONEWIRE_ASYNC_RESET_LIBERA:
+			_OneWire_PinFloat ();										//Fin del pulso de reset
+			OneWire_Async.nFase = ONEWIRE_ASYNC_RESET_MUESTREO;
+			return OneWire_Perfil.nResetMuestreo;
+		case ONEWIRE_ASYNC_RESET_MUESTREO:
+			OneWire_Async.lPresencia = !_OneWire_PinRead ();			//A los 60 us, leemos el bus
+			OneWire_Async.nFase = ONEWIRE_ASYNC_FIN;
+			return OneWire_Perfil.nResetFin;
+		case ONEWIRE_ASYNC_SLOT:
+			return _OneWire_AsyncSlot ();
+		case ONEWIRE_ASYNC_ESCRITURA_FIN:
+			_OneWire_PinFloat ();										//Dejamos el bus en alta impedancia
+			_OneWire_DelayUs (OneWire_Async.lBloque ? OneWire_Perfil.nBloqueRecupera : OneWire_Perfil.nEscrituraRecupera);
+			return _OneWire_AsyncSiguienteBit ();
+		case ONEWIRE_ASYNC_LECTURA_FIN:
+			return _OneWire_AsyncSiguienteBit ();
+		case ONEWIRE_ASYNC_FIN:
+			_OneWire_AsyncFin ();
+			return 0;
+	}
+	return 0;
+}
+/**
+******************************************************
+* @brief Rutina de interrupcion del temporizador
+*
+* Funcion interna. Ejecuta la fase pendiente y vuelve a programar el temporizador
+*/
+#ifndef ONEWIRE_SIM
+#INT_TIMER1
+#endif
+void _OneWire_AsyncISR (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int16 nEspera;
+	//-------------------------------------------------------------
+
+	_OneWire_TimerPara ();
+	nEspera = _OneWire_AsyncPaso ();
+	if (nEspera)
+	{
+		_OneWire_TimerArma (nEspera);
+	}
+}
+/**
+******************************************************
+* @brief Lanza la operacion preparada en OneWire_Async
+*
+* Funcion interna. La primera fase se ejecuta en el momento, las siguientes en la interrupcion
+*/
+void _OneWire_AsyncArranca (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int16 nEspera;
+	//-------------------------------------------------------------
+
+	OneWire_Async.lOcupado = 1;
+	nEspera = _OneWire_AsyncPaso ();
+	if (nEspera)
+	{
+		_OneWire_TimerArma (nEspera);
+	}
+}
+/**
+******************************************************
+* @brief Prepara una operacion de lectura o escritura de bits
+*
+* Funcion interna.
+*/
+void _OneWire_AsyncBits (int1 lLectura, int8* aDatos, int8 nBytes, int8 nBitsByte)
+{
+	OneWire_Async.lLectura = lLectura;
+	OneWire_Async.pDatos = aDatos;
+	OneWire_Async.nBytes = nBytes;
+	OneWire_Async.nBitsByte = nBitsByte;
+	OneWire_Async.nBit = 0;
+	OneWire_Async.nFase = ONEWIRE_ASYNC_SLOT;
+	_OneWire_AsyncArranca ();
+}
+/**
+******************************************************
+* @brief Lanza un reset del bus sin esperar a que termine
+*
+* Al terminar, OneWire_Async.lPresencia indica si algun esclavo ha respondido
+*
+* Ejemplo:
+*
+*	OneWire_AsyncReset();
+*	while (OneWire_AsyncOcupado())
+*	{
+*		//Otras tareas
+*	}
+*
+* Resultado:
+*
+*	OneWire_Async.lPresencia = 1 si hay dispositivos en el bus
+*
+* @see OneWire_Reset(), OneWire_AsyncOcupado()
+*/
+void OneWire_AsyncReset (void)
+{
+	_OneWire_PinLow ();													//Ponemos la salida a 0 durante el pulso de reset
+	OneWire_Async.nFase = ONEWIRE_ASYNC_RESET_LIBERA;
+	OneWire_Async.lOcupado = 1;
+	_OneWire_TimerArma (OneWire_Perfil.nResetBajo);
+}
+/**
+******************************************************
+* @brief Lanza la escritura de un bit sin esperar a que termine
+*
+* @param lBit Bit a transmitir
+*
+* @see OneWire_Write()
+*/
+void OneWire_AsyncWrite (int1 lBit)
+{
+	OneWire_Async.cDato = lBit;
+	_OneWire_AsyncBits (0, &OneWire_Async.cDato, 1, 1);
+}
+/**
+******************************************************
+* @brief Lanza la lectura de un bit sin esperar a que termine
+*
+* Al terminar el bit leido queda en OneWire_Async.lBit
+*
+* @see OneWire_LeeBit()
+*/
+void OneWire_AsyncLeeBit (void)
+{
+	OneWire_Async.cDato = 0;
+	_OneWire_AsyncBits (1, &OneWire_Async.cDato, 1, 1);
+}
+/**
+******************************************************
+* @brief Lanza el envio de un byte sin esperar a que termine
+*
+* @param cDato Byte a transmitir
+*
+* @see OneWire_SendByte()
+*/
+void OneWire_AsyncSendByte (byte cDato)
+{
+	OneWire_Async.cDato = cDato;
+	_OneWire_AsyncBits (0, &OneWire_Async.cDato, 1, 8);
+}
+/**
+******************************************************
+* @brief Lanza la recepcion de un byte sin esperar a que termine
+*
+* Al terminar el byte recibido queda en OneWire_Async.cDato
+*
+* @see OneWire_ReceiveByte()
+*/
+void OneWire_AsyncReceiveByte (void)
+{
+	OneWire_Async.cDato = 0;
+	_OneWire_AsyncBits (1, &OneWire_Async.cDato, 1, 8);
+}
+/**
+******************************************************
+* @brief Lanza el envio de un bloque de bytes sin esperar a que termine
+*
+* El array no debe modificarse hasta que termine la operacion. Los slots usan los tiempos minimos del perfil
+*
+* @param aDatos Bytes a transmitir
+* @param nBytes Numero de bytes
+*
+* Ejemplo:
+*
+*	int8 aComando[3] = {0x4E, 0x4B, 0x46};
+*
+*	OneWire_SkipROM();
+*	OneWire_AsyncWriteBlock (aComando, 3);
+*
+* Resultado:
+*
+*	Envia los 3 bytes mientras el programa principal continua
+*
+* @see OneWire_AsyncReadBlock()
+*/
+void OneWire_AsyncWriteBlock (int8* aDatos, int8 nBytes)
+{
+	if (nBytes)
+	{
+		OneWire_Async.lBloque = 1;
+		_OneWire_AsyncBits (0, aDatos, nBytes, 8);
+	}
+}
+/**
+******************************************************
+* @brief Lanza la lectura de un bloque de bytes sin esperar a que termine
+*
+* @param aDatos Array donde se dejan los bytes recibidos
+* @param nBytes Numero de bytes
+*
+* @see OneWire_AsyncWriteBlock()
+*/
+void OneWire_AsyncReadBlock (int8* aDatos, int8 nBytes)
+{
+	if (nBytes)
+	{
+		OneWire_Async.lBloque = 1;
+		_OneWire_AsyncBits (1, aDatos, nBytes, 8);
+	}
+}
+/**
+******************************************************
+* @brief Indica si la operacion lanzada no ha terminado
+*
+* @return 1 mientras la operacion esta en curso
+*/
+int1 OneWire_AsyncOcupado (void)
+{
+	return OneWire_Async.lOcupado;
+}
+/**
+******************************************************
+* @brief Espera a que termine la operacion en curso
+*
+* Es la espera que usan las funciones bloqueantes cuando se define ONEWIRE_ASYNC
+*/
+void OneWire_AsyncEspera (void)
+{
+	while (OneWire_Async.lOcupado)
+	{
+		_OneWire_AsyncIdle ();
+	}
+}
@@ -0,0 +1,229 @@
+/**
+******************************************************
+* @file jsb_1wire_calibracion.c
+* @brief Calibracion de los tiempos de velocidad estandar a partir del pulso de presencia
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+/**
+******************************************************
+* @brief Mide el bus y activa los tiempos calibrados
+*
+* Deja el bus en velocidad estandar. Si la medida falla se mantienen los tiempos anteriores
+*
+* @param pCalibracion Estructura donde se dejan las medidas ( para consultarlas o guardarlas )
+* @return 1 si se han calibrado los tiempos, 0 si no hay dispositivos o el bus es demasiado lento
+*
+* Ejemplo:
+*
+*	OneWire_Calibracion stCalibracion;
+*
+*	if (OneWire_Calibra (&stCalibracion))
+*	{
+*		//Los slots usan los tiempos minimos para este bus
+*	}
+*
+* Resultado:
+*
+*	En un bus corto el slot de escritura pasa de 82 us a 63 us y el de lectura de 67 us a 63 us. El reset pasa de 780 us a
+*	960 us: los 300 us en alto de ONEWIRE_STD_RESET_MUESTREO + ONEWIRE_STD_RESET_FIN no llegan a tRSTH
+*
+* @see OneWire_CalibraMide(), OneWire_CalibraAplica(), OneWire_CalibraBorra()
+*/
+int1 OneWire_Calibra (OneWire_Calibracion* pCalibracion)
+{
+	if (!OneWire_CalibraMide (pCalibracion))
+	{
+		return 0;
+	}
+	return OneWire_CalibraAplica (pCalibracion);
+}
+/**
+******************************************************
+* @brief Mide la subida del bus y el pulso de presencia en ONEWIRE_CALIBRA_REPETICIONES resets
+*
+* @param pCalibracion Estructura donde se dejan los peores casos medidos
+* @return 1 si todos los resets han tenido pulso de presencia
+*
+* @see OneWire_Calibra()
+*/
+int1 OneWire_CalibraMide (OneWire_Calibracion* pCalibracion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_Calibracion stMedida;
+	int8 nRepeticion;
+	//-------------------------------------------------------------
+
+	OneWire_Velocidad (0);
+	for (nRepeticion = 0; nRepeticion < ONEWIRE_CALIBRA_REPETICIONES; nRepeticion++)
+	{
+		if (!_OneWire_CalibraReset (&stMedida))
+		{
+			return 0;
+		}
+		if (nRepeticion == 0)
+		{
+			*pCalibracion = stMedida;
+			continue;
+		}
+		if (stMedida.nSubida > pCalibracion->nSubida)
+		{
+			pCalibracion->nSubida = stMedida.nSubida;
+		}
+		if (stMedida.nPresenciaInicio > pCalibracion->nPresenciaInicio)
+		{
+			pCalibracion->nPresenciaInicio = stMedida.nPresenciaInicio;
+		}
+		if (stMedida.nPresenciaFin > pCalibracion->nPresenciaFin)
+		{
+			pCalibracion->nPresenciaFin = stMedida.nPresenciaFin;
+		}
+		if (stMedida.nPresenciaFin < pCalibracion->nPresenciaFinMin)
+		{
+			pCalibracion->nPresenciaFinMin = stMedida.nPresenciaFin;
+		}
+	}
+	return 1;
+}
+/**
+******************************************************
+* @brief Calcula los tiempos minimos para las medidas y los activa
+*
+* Con R = subida + margen:
+*	- Presencia: se lee R us despues de su inicio y el reset termina R us despues de su fin, pero nunca antes de
+*	  ONEWIRE_CALIBRA_RESET_ALTO us desde que se suelta el bus
+*	- Lectura: se lee R us despues de soltar el bus, el slot dura 60 us mas R de recuperacion
+*	- Escritura: el 1 se suelta a tiempo de subir antes de 15 us, el 0 dura 60 us y se recupera durante R
+*
+* Tambien se puede llamar con unas medidas guardadas para no repetir la calibracion en cada arranque
+*
+* @param pCalibracion Medidas del bus
+* @return 1 si se han activado los tiempos, 0 si con esas medidas no se cumple la especificacion
+*
+* @see OneWire_Calibra(), OneWire_CalibraBorra()
+*/
+int1 OneWire_CalibraAplica (OneWire_Calibracion* pCalibracion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int16 nRecupera, nMuestreo;
+	int8 nEscrituraBajo;
+	//-------------------------------------------------------------
+
+	nRecupera = pCalibracion->nSubida + ONEWIRE_CALIBRA_MARGEN;
+	nMuestreo = pCalibracion->nPresenciaInicio + ONEWIRE_CALIBRA_MARGEN;
+	if (nMuestreo + ONEWIRE_CALIBRA_MARGEN > pCalibracion->nPresenciaFinMin)
+	{
+		return 0;														//Pulso de presencia demasiado corto para leerlo con margen
+	}
+	if (ONEWIRE_STD_LECTURA_BAJO + nRecupera > ONEWIRE_CALIBRA_MUESTREO_ESCLAVO)
+	{
+		return 0;														//El bus sube tan despacio que el bit no se puede leer a tiempo
+	}
+	nEscrituraBajo = ONEWIRE_STD_ESCRITURA_BAJO;
+	if (nEscrituraBajo + nRecupera > ONEWIRE_CALIBRA_MUESTREO_ESCLAVO)
+	{
+		nEscrituraBajo = ONEWIRE_CALIBRA_MUESTREO_ESCLAVO - nRecupera;	//Un 1 debe estar en el bus cuando el esclavo lo lee
+	}
+	OneWire_PerfilEstandar.nResetBajo = ONEWIRE_STD_RESET_BAJO;
+	OneWire_PerfilEstandar.nResetMuestreo = nMuestreo;
+	OneWire_PerfilEstandar.nResetFin = pCalibracion->nPresenciaFin + nRecupera - nMuestreo;
+	if (nMuestreo + OneWire_PerfilEstandar.nResetFin < ONEWIRE_CALIBRA_RESET_ALTO)
+	{
+		OneWire_PerfilEstandar.nResetFin = ONEWIRE_CALIBRA_RESET_ALTO - nMuestreo;	//tRSTH, aunque la presencia haya terminado
+	}
+	OneWire_PerfilEstandar.nEscrituraBajo = nEscrituraBajo;
+	OneWire_PerfilEstandar.nEscrituraBit = ONEWIRE_CALIBRA_SLOT - nEscrituraBajo;
+	OneWire_PerfilEstandar.nEscrituraRecupera = nRecupera;
+	OneWire_PerfilEstandar.nLecturaBajo = ONEWIRE_STD_LECTURA_BAJO;
+	OneWire_PerfilEstandar.nLecturaMuestreo = nRecupera;
+	OneWire_PerfilEstandar.nLecturaRecupera = ONEWIRE_CALIBRA_SLOT - ONEWIRE_STD_LECTURA_BAJO;	//Resto del slot y R de recuperacion
+	OneWire_PerfilEstandar.nBloqueEscrituraBit = ONEWIRE_CALIBRA_SLOT - nEscrituraBajo;
+	OneWire_PerfilEstandar.nBloqueLecturaRecupera = ONEWIRE_CALIBRA_SLOT - ONEWIRE_STD_LECTURA_BAJO;
+	OneWire_PerfilEstandar.nBloqueRecupera = nRecupera;
+	OneWire_PerfilEstandar.lOverdrive = 0;
+	OneWire_Velocidad (0);
+	return 1;
+}
+/**
+******************************************************
+* @brief Vuelve a los tiempos ONEWIRE_STD_xxx
+*
+* @see OneWire_Calibra()
+*/
+void OneWire_CalibraBorra (void)
+{
+	OneWire_PerfilEstandar.nResetBajo = ONEWIRE_STD_RESET_BAJO;
+	OneWire_PerfilEstandar.nResetMuestreo = ONEWIRE_STD_RESET_MUESTREO;
+	OneWire_PerfilEstandar.nResetFin = ONEWIRE_STD_RESET_FIN;
+	OneWire_PerfilEstandar.nEscrituraBajo = ONEWIRE_STD_ESCRITURA_BAJO;
+	OneWire_PerfilEstandar.nEscrituraBit = ONEWIRE_STD_ESCRITURA_BIT;
+	OneWire_PerfilEstandar.nEscrituraRecupera = ONEWIRE_STD_ESCRITURA_RECUPERA;
+	OneWire_PerfilEstandar.nLecturaBajo = ONEWIRE_STD_LECTURA_BAJO;
+	OneWire_PerfilEstandar.nLecturaMuestreo = ONEWIRE_STD_LECTURA_MUESTREO;
+	OneWire_PerfilEstandar.nLecturaRecupera = ONEWIRE_STD_LECTURA_RECUPERA;
+	OneWire_PerfilEstandar.nBloqueEscrituraBit = ONEWIRE_STD_BLOQUE_ESCRITURA_BIT;
+	OneWire_PerfilEstandar.nBloqueLecturaRecupera = ONEWIRE_STD_BLOQUE_LECTURA_RECUPERA;
+	OneWire_PerfilEstandar.nBloqueRecupera = ONEWIRE_STD_BLOQUE_RECUPERA;
+	OneWire_PerfilEstandar.lOverdrive = 0;
+	if (!OneWire_Perfil.lOverdrive)
+	{
+		OneWire_Velocidad (0);
+	}
+}
+/**
+******************************************************
+* @brief Da un reset de duracion estandar y sigue el bus hasta el fin del pulso de presencia
+*
+* Funcion interna.
+*
+* @param pMedida Estructura donde se dejan los tiempos medidos
+* @return 1 si se ha visto el pulso de presencia completo
+*/
+int1 _OneWire_CalibraReset (OneWire_Calibracion* pMedida)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int16 nTiempo;
+	int8 nFase;
+	int1 lNivel;
+	//-------------------------------------------------------------
+
+	_OneWire_PinLow ();
+	_OneWire_DelayUs (ONEWIRE_STD_RESET_BAJO);
+	_OneWire_PinFloat ();
+	nFase = 0;															//0 subiendo, 1 esperando la presencia, 2 en la presencia
+	for (nTiempo = 0; nTiempo < ONEWIRE_CALIBRA_ESPERA_MAX && nFase < 3; nTiempo += ONEWIRE_CALIBRA_PASO)
+	{
+		lNivel = _OneWire_PinRead ();
+		if (nFase == 0 && lNivel)
+		{
+			pMedida->nSubida = nTiempo;
+			nFase = 1;
+		}else if (nFase == 1 && !lNivel){
+			pMedida->nPresenciaInicio = nTiempo;
+			nFase = 2;
+		}else if (nFase == 2 && lNivel){
+			pMedida->nPresenciaFin = nTiempo;
+			pMedida->nPresenciaFinMin = nTiempo;
+			nFase = 3;
+			break;
+		}
+		_OneWire_DelayUs (ONEWIRE_CALIBRA_PASO);
+	}
+	OneWire_Resume.lValido = 0;
+	if (nFase != 3)
+	{
+		_OneWire_DelayUs (ONEWIRE_CALIBRA_ESPERA_MAX);					//Nadie ha respondido o el bus no sube
+		return 0;
+	}
+	return 1;
+}
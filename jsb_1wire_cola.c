@@ -0,0 +1,692 @@
+/**
+******************************************************
+* @file jsb_1wire_cola.c
+* @brief Cola de transacciones compartida por los modulos del programa, con agrupacion de peticiones
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+/**
+******************************************************
+* @brief Vacia la cola
+*
+* Debe llamarse al arrancar, antes de anadir peticiones
+*
+* @see OneWire_ColaProcesa()
+*/
+void OneWire_ColaInicia (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nPeticion;
+	//-------------------------------------------------------------
+
+	for (nPeticion = 0; nPeticion < ONEWIRE_COLA_MAX; nPeticion++)
+	{
+		OneWire_Cola.aPeticiones[nPeticion].nEstado = ONEWIRE_COLA_LIBRE;
+	}
+	OneWire_Cola.nFase = ONEWIRE_COLA_FASE_LIBRE;
+	OneWire_Cola.nEspera = 0;
+	OneWire_Cola.nOrden = 0;
+	OneWire_Cola.nAgrupadas = 0;
+}
+/**
+******************************************************
+* @brief Pide una conversion de temperatura
+*
+* Todas las conversiones de un ciclo se lanzan juntas, antes de las lecturas del mismo ciclo
+*
+* @param aRom Id del sensor ( 8 bytes )
+* @return Numero de la peticion, ONEWIRE_COLA_NINGUNA si la cola esta llena o el Id no es valido
+*
+* Ejemplo:
+*
+*	nConversion = OneWire_ColaConvierte (aSensor);
+*	nLectura = OneWire_ColaLeeScratchpad (aSensor);
+*
+* Resultado:
+*
+*	En el siguiente ciclo el sensor convierte y despues se lee su scratchpad con la temperatura nueva
+*
+* @see OneWire_ColaLeeScratchpad(), OneWire_ColaResultado()
+*/
+int8 OneWire_ColaConvierte (int8* aRom)
+{
+	return _OneWire_ColaAnade (aRom, ONEWIRE_COLA_CONVIERTE, 0, 0, 0);
+}
+/**
+******************************************************
+* @brief Pide la lectura del scratchpad de un DS18B20
+*
+* El resultado son los 9 bytes del scratchpad, con el CRC comprobado
+*
+* @param aRom Id del sensor ( 8 bytes )
+* @return Numero de la peticion, ONEWIRE_COLA_NINGUNA si no se acepta
+*
+* @see OneWire_ColaConvierte(), OneWire_ColaResultado()
+*/
+int8 OneWire_ColaLeeScratchpad (int8* aRom)
+{
+	return _OneWire_ColaAnade (aRom, ONEWIRE_COLA_LEE_SCRATCHPAD, 0, 0, 9);
+}
+/**
+******************************************************
+* @brief Pide la escritura de TH, TL y configuracion de un DS18B20
+*
+* Las escrituras de un ciclo se hacen antes que sus conversiones, asi un cambio de resolucion pedido junto con
+* la conversion ya se aplica en ella
+*
+* @param aRom Id del sensor ( 8 bytes )
+* @param aDatos TH, TL y registro de configuracion
+* @return Numero de la peticion, ONEWIRE_COLA_NINGUNA si no se acepta
+*
+* @see OneWire_ColaResultado()
+*/
+int8 OneWire_ColaEscribeScratchpad (int8* aRom, int8* aDatos)
+{
+	return _OneWire_ColaAnade (aRom, ONEWIRE_COLA_ESCRIBE_SCRATCHPAD, 0, aDatos, 3);
+}
+/**
+******************************************************
+* @brief Pide la lectura de un rango de memoria de un DS2431
+*
+* @param aRom Id del dispositivo ( 8 bytes )
+* @param nDireccion Primera direccion
+* @param nBytes Bytes a leer, como mucho ONEWIRE_COLA_DATOS
+* @return Numero de la peticion, ONEWIRE_COLA_NINGUNA si no se acepta
+*
+* Ejemplo:
+*
+*	nModulo1 = OneWire_ColaLeeMemoria (aEeprom, 0x0000, 8);
+*	nModulo2 = OneWire_ColaLeeMemoria (aEeprom, 0x0010, 8);
+*
+* Resultado:
+*
+*	Un solo Read Memory desde 0x0000 hasta 0x0017 sirve las dos peticiones
+*
+* @see OneWire_ColaResultado(), OneWire_MemoriaLeeBloque()
+*/
+int8 OneWire_ColaLeeMemoria (int8* aRom, int16 nDireccion, int8 nBytes)
+{
+	return _OneWire_ColaAnade (aRom, ONEWIRE_COLA_LEE_MEMORIA, nDireccion, 0, nBytes);
+}
+/**
+******************************************************
+* @brief Avanza el ciclo de la cola
+*
+* Si no hay conversion en curso toma las peticiones pendientes, hace las escrituras y lanza las conversiones;
+* sin conversiones sigue con las lecturas. Con una conversion en curso cada llamada da un slot de lectura y
+* espera 1 ms si los sensores no han terminado; cuando terminan hace las lecturas del ciclo. Las peticiones
+* que llegan durante un ciclo esperan al siguiente
+*
+* @return 1 si queda trabajo ( conversion en curso o peticiones pendientes )
+*
+* Ejemplo:
+*
+*	while (OneWire_ColaProcesa ())
+*	{
+*		//Otras tareas
+*	}
+*
+* Resultado:
+*
+*	Todas las peticiones anadidas hasta ese momento terminadas
+*
+* @see OneWire_ColaResultado()
+*/
+int1 OneWire_ColaProcesa (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nPeticion;
+	//-------------------------------------------------------------
+
+	if (OneWire_Cola.nFase == ONEWIRE_COLA_FASE_CONVERSION)
+	{
+		if (!OneWire_LeeBit ())
+		{
+			_OneWire_DelayMs (1);											//El limite es de tiempo, no de llamadas
+			if (++OneWire_Cola.nEspera < ONEWIRE_TEMP_ESPERA_MAX)
+			{
+				return 1;													//Los sensores siguen convirtiendo
+			}
+			_OneWire_ColaFinConversion (0);
+		}else{
+			_OneWire_ColaFinConversion (1);
+		}
+		OneWire_Cola.nFase = ONEWIRE_COLA_FASE_LIBRE;
+	}else{
+		if (!_OneWire_ColaToma ())
+		{
+			return 0;
+		}
+		_OneWire_ColaEscrituras ();
+		if (_OneWire_ColaConversiones ())
+		{
+			return 1;
+		}
+	}
+	_OneWire_ColaLecturas ();
+	for (nPeticion = 0; nPeticion < ONEWIRE_COLA_MAX; nPeticion++)
+	{
+		if (OneWire_Cola.aPeticiones[nPeticion].nEstado == ONEWIRE_COLA_PENDIENTE)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+/**
+******************************************************
+* @brief Consulta una peticion y la recoge si ha terminado
+*
+* Cuando la peticion ha terminado se copian sus datos y queda libre para otra
+*
+* @param nPeticion Numero devuelto al anadirla
+* @param aDatos Array donde se dejan los bytes leidos ( puede ser NULL )
+* @return ONEWIRE_COLA_PENDIENTE, ONEWIRE_COLA_CICLO, ONEWIRE_COLA_HECHA o ONEWIRE_COLA_ERROR. Una peticion no
+* aceptada ( ONEWIRE_COLA_NINGUNA ) da ONEWIRE_COLA_ERROR
+*
+* Ejemplo:
+*
+*	int8 aScratchpad[9];
+*
+*	if (OneWire_ColaResultado (nLectura, aScratchpad) == ONEWIRE_COLA_HECHA)
+*	{
+*		nTemperatura = make16 (aScratchpad[1], aScratchpad[0]);
+*	}
+*
+* @see OneWire_ColaProcesa()
+*/
+int8 OneWire_ColaResultado (int8 nPeticion, int8* aDatos)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_ColaPeticion* pPeticion;
+	int8 nEstado, nByte;
+	//-------------------------------------------------------------
+
+	if (nPeticion >= ONEWIRE_COLA_MAX)
+	{
+		return ONEWIRE_COLA_ERROR;
+	}
+	pPeticion = &OneWire_Cola.aPeticiones[nPeticion];
+	nEstado = pPeticion->nEstado;
+	if (nEstado == ONEWIRE_COLA_HECHA || nEstado == ONEWIRE_COLA_ERROR)
+	{
+		if (aDatos && nEstado == ONEWIRE_COLA_HECHA)
+		{
+			for (nByte = 0; nByte < pPeticion->nBytes; nByte++)
+			{
+				aDatos[nByte] = pPeticion->aDatos[nByte];
+			}
+		}
+		pPeticion->nEstado = ONEWIRE_COLA_LIBRE;
+	}
+	return nEstado;
+}
+/**
+******************************************************
+* @brief Anade una peticion en un hueco libre
+*
+* Funcion interna. El numero de orden es un int8 que da la vuelta: entre dos ciclos no se pueden anadir mas de
+* ONEWIRE_COLA_MAX peticiones, asi que la diferencia entre dos del mismo ciclo siempre es menor de 128
+*
+* @return Numero de la peticion o ONEWIRE_COLA_NINGUNA
+*/
+int8 _OneWire_ColaAnade (int8* aRom, int8 nTipo, int16 nDireccion, int8* aDatos, int8 nBytes)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_ColaPeticion* pPeticion;
+	int8 nPeticion, nByte;
+	//-------------------------------------------------------------
+
+	if (nBytes > ONEWIRE_COLA_DATOS)
+	{
+		return ONEWIRE_COLA_NINGUNA;
+	}
+	for (nPeticion = 0; nPeticion < ONEWIRE_COLA_MAX; nPeticion++)
+	{
+		if (OneWire_Cola.aPeticiones[nPeticion].nEstado == ONEWIRE_COLA_LIBRE)
+		{
+			break;
+		}
+	}
+	if (nPeticion == ONEWIRE_COLA_MAX)
+	{
+		return ONEWIRE_COLA_NINGUNA;
+	}
+	pPeticion = &OneWire_Cola.aPeticiones[nPeticion];
+	if (!OneWire_RomCrea (&pPeticion->stRom, aRom))
+	{
+		return ONEWIRE_COLA_NINGUNA;
+	}
+	pPeticion->nTipo = nTipo;
+	pPeticion->nDireccion = nDireccion;
+	pPeticion->nBytes = nBytes;
+	if (aDatos)
+	{
+		for (nByte = 0; nByte < nBytes; nByte++)
+		{
+			pPeticion->aDatos[nByte] = aDatos[nByte];
+		}
+	}
+	pPeticion->nOrden = ++OneWire_Cola.nOrden;
+	pPeticion->nEstado = ONEWIRE_COLA_PENDIENTE;						//La ultima, la peticion no cuenta hasta estar completa
+	return nPeticion;
+}
+/**
+******************************************************
+* @brief Pasa las peticiones pendientes al ciclo que empieza
+*
+* Funcion interna.
+*
+* @return 1 si habia alguna
+*/
+int1 _OneWire_ColaToma (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nPeticion;
+	int1 lAlguna;
+	//-------------------------------------------------------------
+
+	lAlguna = 0;
+	for (nPeticion = 0; nPeticion < ONEWIRE_COLA_MAX; nPeticion++)
+	{
+		if (OneWire_Cola.aPeticiones[nPeticion].nEstado == ONEWIRE_COLA_PENDIENTE)
+		{
+			OneWire_Cola.aPeticiones[nPeticion].nEstado = ONEWIRE_COLA_CICLO;
+			lAlguna = 1;
+		}
+	}
+	return lAlguna;
+}
+/**
+******************************************************
+* @brief Siguiente peticion del ciclo en el orden de la busqueda
+*
+* Funcion interna. Entre peticiones del mismo Id va primero la mas antigua
+*
+* @param lLecturas 1 para las lecturas ( scratchpad y memoria ), 0 para las escrituras
+* @return Numero de la peticion, ONEWIRE_COLA_NINGUNA si no quedan
+*/
+int8 _OneWire_ColaSiguiente (int1 lLecturas)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_ColaPeticion* pPeticion;
+	OneWire_ColaPeticion* pElegida;
+	int8 nPeticion, nElegida;
+	//-------------------------------------------------------------
+
+	nElegida = ONEWIRE_COLA_NINGUNA;
+	for (nPeticion = 0; nPeticion < ONEWIRE_COLA_MAX; nPeticion++)
+	{
+		pPeticion = &OneWire_Cola.aPeticiones[nPeticion];
+		if (pPeticion->nEstado != ONEWIRE_COLA_CICLO || pPeticion->nTipo == ONEWIRE_COLA_CONVIERTE)
+		{
+			continue;
+		}
+		if ((pPeticion->nTipo == ONEWIRE_COLA_ESCRIBE_SCRATCHPAD) == lLecturas)
+		{
+			continue;
+		}
+		if (nElegida != ONEWIRE_COLA_NINGUNA)
+		{
+			pElegida = &OneWire_Cola.aPeticiones[nElegida];
+			if (OneWire_RomMenor (&pElegida->stRom, &pPeticion->stRom))
+			{
+				continue;
+			}
+			if (OneWire_RomIgual (&pElegida->stRom, &pPeticion->stRom) && (int8)(pPeticion->nOrden - pElegida->nOrden) < 0x80)
+			{
+				continue;													//Mismo Id, la elegida es anterior
+			}
+		}
+		nElegida = nPeticion;
+	}
+	return nElegida;
+}
+/**
+******************************************************
+* @brief Escribe los scratchpad pedidos en el ciclo
+*
+* Funcion interna. Si hay varias escrituras al mismo Id solo se envia la ultima, las anteriores se dan por hechas
+*/
+void _OneWire_ColaEscrituras (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_ColaPeticion* pPeticion;
+	int8 nPeticion, nOtra;
+	int1 lSustituida, lPresente;
+	//-------------------------------------------------------------
+
+	while ((nPeticion = _OneWire_ColaSiguiente (0)) != ONEWIRE_COLA_NINGUNA)
+	{
+		pPeticion = &OneWire_Cola.aPeticiones[nPeticion];
+		lSustituida = 0;
+		for (nOtra = 0; nOtra < ONEWIRE_COLA_MAX; nOtra++)
+		{
+			if (_OneWire_ColaMismoId (nPeticion, nOtra, ONEWIRE_COLA_ESCRIBE_SCRATCHPAD))
+			{
+				lSustituida = 1;											//La elegida es la mas antigua, la otra es posterior
+			}
+		}
+		if (lSustituida)
+		{
+			OneWire_Cola.nAgrupadas++;
+			_OneWire_ColaTermina (nPeticion, 1);
+			continue;
+		}
+		OneWire_MatchROM (pPeticion->stRom.aBytes);
+		lPresente = OneWire_Resume.lValido;								//OneWire_MatchROM() solo lo activa si ha habido presencia
+		if (lPresente)
+		{
+			OneWire_SendByte (ONEWIRE_TEMP_WRITE_SCRATCHPAD);
+			OneWire_WriteBlock (pPeticion->aDatos, pPeticion->nBytes, ONEWIRE_CRC_NINGUNO, 0);
+		}
+		_OneWire_ColaTermina (nPeticion, lPresente);
+	}
+}
+/**
+******************************************************
+* @brief Lanza las conversiones del ciclo
+*
+* Funcion interna. Con ONEWIRE_COLA_SKIP_MIN sensores distintos o mas se usa Skip ROM, que hace convertir a todos
+* los sensores del bus
+*
+* @return 1 si hay una conversion en curso
+*/
+int1 _OneWire_ColaConversiones (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nPeticion, nOtra, nPeticiones, nSensores, nUltima;
+	int1 lRepetida, lPresente;
+	//-------------------------------------------------------------
+
+	nPeticiones = 0;
+	nSensores = 0;
+	nUltima = 0;
+	for (nPeticion = 0; nPeticion < ONEWIRE_COLA_MAX; nPeticion++)
+	{
+		if (OneWire_Cola.aPeticiones[nPeticion].nEstado != ONEWIRE_COLA_CICLO || OneWire_Cola.aPeticiones[nPeticion].nTipo != ONEWIRE_COLA_CONVIERTE)
+		{
+			continue;
+		}
+		nPeticiones++;
+		lRepetida = 0;
+		for (nOtra = 0; nOtra < nPeticion; nOtra++)
+		{
+			if (_OneWire_ColaMismoId (nPeticion, nOtra, ONEWIRE_COLA_CONVIERTE))
+			{
+				lRepetida = 1;
+			}
+		}
+		if (!lRepetida)
+		{
+			nSensores++;
+			nUltima = nPeticion;
+		}
+	}
+	if (nPeticiones == 0)
+	{
+		return 0;
+	}
+	OneWire_Cola.nAgrupadas += nPeticiones - 1;
+	if (nSensores >= ONEWIRE_COLA_SKIP_MIN)
+	{
+		lPresente = !OneWire_Reset ();
+		if (lPresente)
+		{
+			OneWire_SendByte (0xCC);
+		}
+	}else{
+		OneWire_MatchROM (OneWire_Cola.aPeticiones[nUltima].stRom.aBytes);
+		lPresente = OneWire_Resume.lValido;
+	}
+	if (!lPresente)
+	{
+		_OneWire_ColaFinConversion (0);
+		return 0;
+	}
+	OneWire_SendByte (ONEWIRE_TEMP_CONVERT);
+	OneWire_Cola.nEspera = 0;
+	OneWire_Cola.nFase = ONEWIRE_COLA_FASE_CONVERSION;
+	return 1;
+}
+/**
+******************************************************
+* @brief Termina las peticiones de conversion del ciclo
+*
+* Funcion interna. Si la conversion ha fallado tambien fallan las lecturas del scratchpad de los mismos sensores
+* en el ciclo, que darian la temperatura anterior ( o leerian a un sensor que todavia convierte )
+*
+* @param lCorrecta 1 si los sensores han terminado la conversion
+*/
+void _OneWire_ColaFinConversion (int1 lCorrecta)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nPeticion, nConversion;
+	//-------------------------------------------------------------
+
+	for (nPeticion = 0; nPeticion < ONEWIRE_COLA_MAX && !lCorrecta; nPeticion++)
+	{
+		if (OneWire_Cola.aPeticiones[nPeticion].nEstado != ONEWIRE_COLA_CICLO || OneWire_Cola.aPeticiones[nPeticion].nTipo != ONEWIRE_COLA_LEE_SCRATCHPAD)
+		{
+			continue;
+		}
+		for (nConversion = 0; nConversion < ONEWIRE_COLA_MAX; nConversion++)
+		{
+			if (_OneWire_ColaMismoId (nPeticion, nConversion, ONEWIRE_COLA_CONVIERTE))
+			{
+				_OneWire_ColaTermina (nPeticion, 0);
+				break;
+			}
+		}
+	}
+	for (nPeticion = 0; nPeticion < ONEWIRE_COLA_MAX; nPeticion++)
+	{
+		if (OneWire_Cola.aPeticiones[nPeticion].nEstado == ONEWIRE_COLA_CICLO && OneWire_Cola.aPeticiones[nPeticion].nTipo == ONEWIRE_COLA_CONVIERTE)
+		{
+			_OneWire_ColaTermina (nPeticion, lCorrecta);
+		}
+	}
+}
+/**
+******************************************************
+* @brief Hace las lecturas del ciclo
+*
+* Funcion interna. Los Id's se recorren en el orden de la busqueda y todas las lecturas de un Id van seguidas
+*/
+void _OneWire_ColaLecturas (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nPeticion;
+	//-------------------------------------------------------------
+
+	while ((nPeticion = _OneWire_ColaSiguiente (1)) != ONEWIRE_COLA_NINGUNA)
+	{
+		if (OneWire_Cola.aPeticiones[nPeticion].nTipo == ONEWIRE_COLA_LEE_SCRATCHPAD)
+		{
+			_OneWire_ColaScratchpad (nPeticion);
+		}else{
+			_OneWire_ColaMemoria (nPeticion);
+		}
+	}
+}
+/**
+******************************************************
+* @brief Lee el scratchpad de un sensor y sirve todas sus peticiones del ciclo
+*
+* Funcion interna.
+*
+* @param nPeticion Peticion a servir
+*/
+void _OneWire_ColaScratchpad (int8 nPeticion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_ColaPeticion* pPeticion;
+	int8 nOtra, nByte;
+	int16 nCRC;
+	int1 lCorrecta;
+	//-------------------------------------------------------------
+
+	pPeticion = &OneWire_Cola.aPeticiones[nPeticion];
+	OneWire_MatchROM (pPeticion->stRom.aBytes);
+	lCorrecta = OneWire_Resume.lValido;
+	if (lCorrecta)
+	{
+		OneWire_SendByte (ONEWIRE_TEMP_READ_SCRATCHPAD);
+		nCRC = 0;
+		lCorrecta = OneWire_ReadBlock (pPeticion->aDatos, 9, ONEWIRE_CRC_8, &nCRC);
+	}
+	_OneWire_ColaTermina (nPeticion, lCorrecta);
+	for (nOtra = 0; nOtra < ONEWIRE_COLA_MAX; nOtra++)
+	{
+		if (_OneWire_ColaMismoId (nPeticion, nOtra, ONEWIRE_COLA_LEE_SCRATCHPAD))
+		{
+			for (nByte = 0; nByte < 9; nByte++)
+			{
+				OneWire_Cola.aPeticiones[nOtra].aDatos[nByte] = pPeticion->aDatos[nByte];
+			}
+			OneWire_Cola.nAgrupadas++;
+			_OneWire_ColaTermina (nOtra, lCorrecta);
+		}
+	}
+}
+/**
+******************************************************
+* @brief Lee con un solo Read Memory un tramo de memoria que cubre varias peticiones del mismo Id
+*
+* Funcion interna. El tramo empieza en la peticion de direccion mas baja y se alarga mientras la siguiente empieza a
+* menos de ONEWIRE_COLA_HUECO bytes de su final. Las peticiones que quedan fuera se sirven en otra llamada
+*
+* @param nPeticion Cualquier peticion de memoria del Id
+*/
+void _OneWire_ColaMemoria (int8 nPeticion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_ColaPeticion* pOtra;
+	int8 nOtra, cDato, nServidas;
+	int16 nDesde, nHasta, nDireccion;
+	int1 lAmpliado, lPresente;
+	//-------------------------------------------------------------
+
+	nDesde = OneWire_Cola.aPeticiones[nPeticion].nDireccion;
+	for (nOtra = 0; nOtra < ONEWIRE_COLA_MAX; nOtra++)
+	{
+		if (_OneWire_ColaMismoId (nPeticion, nOtra, ONEWIRE_COLA_LEE_MEMORIA) && OneWire_Cola.aPeticiones[nOtra].nDireccion < nDesde)
+		{
+			nDesde = OneWire_Cola.aPeticiones[nOtra].nDireccion;
+		}
+	}
+	nHasta = nDesde;
+	do
+	{
+		lAmpliado = 0;
+		for (nOtra = 0; nOtra < ONEWIRE_COLA_MAX; nOtra++)
+		{
+			pOtra = &OneWire_Cola.aPeticiones[nOtra];
+			if ((nOtra == nPeticion || _OneWire_ColaMismoId (nPeticion, nOtra, ONEWIRE_COLA_LEE_MEMORIA))
+				&& pOtra->nDireccion <= nHasta + ONEWIRE_COLA_HUECO && pOtra->nDireccion + pOtra->nBytes > nHasta)
+			{
+				nHasta = pOtra->nDireccion + pOtra->nBytes;
+				lAmpliado = 1;
+			}
+		}
+	} while (lAmpliado);
+	OneWire_MatchROM (OneWire_Cola.aPeticiones[nPeticion].stRom.aBytes);
+	lPresente = OneWire_Resume.lValido;
+	if (lPresente)
+	{
+		OneWire_SendByte (ONEWIRE_MEMORIA_READ);
+		OneWire_SendByte (make8 (nDesde, 0));
+		OneWire_SendByte (make8 (nDesde, 1));
+		for (nDireccion = nDesde; nDireccion < nHasta; nDireccion++)
+		{
+			cDato = OneWire_ReceiveByte ();
+			for (nOtra = 0; nOtra < ONEWIRE_COLA_MAX; nOtra++)
+			{
+				pOtra = &OneWire_Cola.aPeticiones[nOtra];
+				if ((nOtra == nPeticion || _OneWire_ColaMismoId (nPeticion, nOtra, ONEWIRE_COLA_LEE_MEMORIA))
+					&& nDireccion >= pOtra->nDireccion && nDireccion < pOtra->nDireccion + pOtra->nBytes)
+				{
+					pOtra->aDatos[nDireccion - pOtra->nDireccion] = cDato;
+				}
+			}
+		}
+	}
+	nServidas = 0;
+	for (nOtra = 0; nOtra < ONEWIRE_COLA_MAX; nOtra++)
+	{
+		pOtra = &OneWire_Cola.aPeticiones[nOtra];
+		if ((nOtra == nPeticion || _OneWire_ColaMismoId (nPeticion, nOtra, ONEWIRE_COLA_LEE_MEMORIA))
+			&& pOtra->nEstado == ONEWIRE_COLA_CICLO && pOtra->nDireccion >= nDesde && pOtra->nDireccion + pOtra->nBytes <= nHasta)
+		{
+			if (nServidas++ != 0)
+			{
+				OneWire_Cola.nAgrupadas++;
+			}
+			_OneWire_ColaTermina (nOtra, lPresente);
+		}
+	}
+}
+/**
+******************************************************
+* @brief Da por terminada una peticion
+*
+* Funcion interna. Llama a ONEWIRE_COLA_AVISO si esta definida
+*
+* @param nPeticion Peticion terminada
+* @param lCorrecta 0 si ha fallado
+*/
+void _OneWire_ColaTermina (int8 nPeticion, int1 lCorrecta)
+{
+	OneWire_Cola.aPeticiones[nPeticion].nEstado = lCorrecta ? ONEWIRE_COLA_HECHA : ONEWIRE_COLA_ERROR;
+#ifdef ONEWIRE_COLA_AVISO
+	ONEWIRE_COLA_AVISO (nPeticion);
+#endif
+}
+/**
+******************************************************
+* @brief Comprueba si otra peticion del ciclo es del mismo tipo y para el mismo Id
+*
+* Funcion interna.
+*
+* @return 1 si nOtra es distinta de nPeticion, esta en el ciclo, es de tipo nTipo y tiene el mismo Id
+*/
+int1 _OneWire_ColaMismoId (int8 nPeticion, int8 nOtra, int8 nTipo)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_ColaPeticion* pOtra;
+	//-------------------------------------------------------------
+
+	pOtra = &OneWire_Cola.aPeticiones[nOtra];
+	return nOtra != nPeticion && pOtra->nEstado == ONEWIRE_COLA_CICLO && pOtra->nTipo == nTipo
+		&& OneWire_RomIgual (&pOtra->stRom, &OneWire_Cola.aPeticiones[nPeticion].stRom);
+}
@@ -0,0 +1,197 @@
+/**
+******************************************************
+* @file jsb_1wire_ds2482.c
+* @brief Bus 1Wire a traves de un puente I2C DS2482
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+/**
+******************************************************
+* @brief Resetea el DS2482 y carga la configuracion
+*
+* Debe llamarse una vez antes de usar el bus
+*
+* @return 1 si el DS2482 ha respondido, 0 en caso contrario
+*
+* Ejemplo:
+*
+*	if (!OneWire_DS2482Inicia ())
+*	{
+*		//No hay puente en el bus I2C
+*	}
+*
+* @see OneWire_DS2482Configura()
+*/
+int1 OneWire_DS2482Inicia (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 cEstado;
+	//-------------------------------------------------------------
+
+	_OneWire_DS2482Envia (ONEWIRE_DS2482_RESET_PUENTE, 0, 0);
+	cEstado = _OneWire_DS2482Espera ();
+	_OneWireI2C_Parada ();
+	if (!(cEstado & ONEWIRE_DS2482_RST))
+	{
+		return 0;
+	}
+	return OneWire_DS2482Configura (OneWire_DS2482Config);
+}
+/**
+******************************************************
+* @brief Escribe el registro de configuracion
+*
+* El DS2482 exige el nibble alto complementado, la libreria lo anade
+*
+* @param cConfig Bits ONEWIRE_DS2482_APU, ONEWIRE_DS2482_SPU y ONEWIRE_DS2482_1WS
+* @return 1 si el DS2482 ha aceptado la configuracion
+*
+* @see OneWire_Velocidad()
+*/
+int1 OneWire_DS2482Configura (int8 cConfig)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 cLeida;
+	//-------------------------------------------------------------
+
+	_OneWire_DS2482Envia (ONEWIRE_DS2482_CONFIGURACION, (cConfig & 0x0F) | ((~cConfig) << 4), 1);
+	_OneWireI2C_Inicio ();													//El puntero queda en el registro de configuracion
+	_OneWireI2C_Escribe (ONEWIRE_DS2482_DIRECCION | 1);
+	cLeida = _OneWireI2C_Lee (0);
+	_OneWireI2C_Parada ();
+	OneWire_DS2482Config = cConfig & 0x0F;
+	return cLeida == OneWire_DS2482Config;
+}
+/**
+******************************************************
+* @brief Ejecuta un comando del DS2482 y espera a que termine
+*
+* @param cComando Comando ( ONEWIRE_DS2482_xxx )
+* @param cParametro Byte de parametro
+* @param lParametro 1 si el comando lleva parametro
+* @return Registro de estado al terminar el comando
+*
+* Ejemplo:
+*
+*	cEstado = OneWire_DS2482Comando (ONEWIRE_DS2482_RESET, 0, 0);
+*
+* Resultado:
+*
+*	cEstado & ONEWIRE_DS2482_PPD distinto de 0 si hay dispositivos en el bus
+*/
+int8 OneWire_DS2482Comando (int8 cComando, int8 cParametro, int1 lParametro)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 cEstado;
+	//-------------------------------------------------------------
+
+	_OneWire_DS2482Envia (cComando, cParametro, lParametro);
+	cEstado = _OneWire_DS2482Espera ();
+	_OneWireI2C_Parada ();
+	return cEstado;
+}
+/**
+******************************************************
+* @brief Envia o recibe un bloque de bytes con los comandos encadenados
+*
+* Entre un byte y el siguiente no hay condicion de stop, solo start repetido
+*
+* @param aDatos Bytes a enviar, o array donde se dejan los recibidos
+* @param nBytes Numero de bytes
+* @param lLectura 1 para recibir, 0 para enviar
+*
+* @see OneWire_WriteBlock(), OneWire_ReadBlock()
+*/
+void OneWire_DS2482Bloque (int8* aDatos, int8 nBytes, int1 lLectura)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nByte;
+	//-------------------------------------------------------------
+
+	if (nBytes == 0)
+	{
+		return;
+	}
+	for (nByte = 0; nByte < nBytes; nByte++)
+	{
+		if (lLectura)
+		{
+			_OneWire_DS2482Envia (ONEWIRE_DS2482_LEE_BYTE, 0, 0);
+			_OneWire_DS2482Espera ();
+			aDatos[nByte] = _OneWire_DS2482LeeDato ();
+		}else{
+			_OneWire_DS2482Envia (ONEWIRE_DS2482_ESCRIBE_BYTE, aDatos[nByte], 1);
+			_OneWire_DS2482Espera ();
+		}
+	}
+	_OneWireI2C_Parada ();
+}
+/**
+******************************************************
+* @brief Inicia una transaccion I2C de escritura con un comando
+*
+* Funcion interna. No envia stop, la transaccion sigue con _OneWire_DS2482Espera() o _OneWire_DS2482LeeDato()
+*/
+void _OneWire_DS2482Envia (int8 cComando, int8 cParametro, int1 lParametro)
+{
+	_OneWireI2C_Inicio ();
+	_OneWireI2C_Escribe (ONEWIRE_DS2482_DIRECCION);
+	_OneWireI2C_Escribe (cComando);
+	if (lParametro)
+	{
+		_OneWireI2C_Escribe (cParametro);
+	}
+}
+/**
+******************************************************
+* @brief Lee el registro de estado hasta que el bus 1 Wire queda libre
+*
+* Funcion interna. Con start repetido pasa a lectura y lee el estado sin cambiar el puntero; la ultima
+* lectura se hace sin ACK para cerrar la lectura. No envia stop
+*
+* @return Registro de estado
+*/
+int8 _OneWire_DS2482Espera (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 cEstado;
+	int16 nSondeo;
+	//-------------------------------------------------------------
+
+	_OneWireI2C_Inicio ();
+	_OneWireI2C_Escribe (ONEWIRE_DS2482_DIRECCION | 1);
+	nSondeo = 0;
+	do
+	{
+		cEstado = _OneWireI2C_Lee (1);
+	} while ((cEstado & ONEWIRE_DS2482_1WB) && ++nSondeo < ONEWIRE_DS2482_SONDEOS);
+	_OneWireI2C_Lee (0);
+	return cEstado;
+}
+/**
+******************************************************
+* @brief Lee el registro de datos con el byte recibido por el ultimo Read Byte
+*
+* Funcion interna. No envia stop
+*/
+int8 _OneWire_DS2482LeeDato (void)
+{
+	_OneWire_DS2482Envia (ONEWIRE_DS2482_PUNTERO, ONEWIRE_DS2482_REG_DATO, 1);
+	_OneWireI2C_Inicio ();
+	_OneWireI2C_Escribe (ONEWIRE_DS2482_DIRECCION | 1);
+	return _OneWireI2C_Lee (0);
+}
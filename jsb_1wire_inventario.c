@@ -0,0 +1,268 @@
+/**
+******************************************************
+* @file jsb_1wire_inventario.c
+* @brief Inventario de los dispositivos del bus 1Wire con deteccion de altas y bajas
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+/**
+******************************************************
+* @brief Deja el inventario vacio
+*
+* La primera llamada a OneWire_InventarioActualiza() recorre el arbol y da de alta todos los dispositivos
+*
+* @param pInventario Inventario a iniciar
+*
+* @see OneWire_InventarioActualiza()
+*/
+void OneWire_InventarioInicia (OneWire_Inventario* pInventario)
+{
+	pInventario->nDispositivos = 0;
+	pInventario->nAltas = 0;
+	pInventario->nBajas = 0;
+	pInventario->lBusqueda = 0;
+	pInventario->lDesbordado = 0;
+}
+/**
+******************************************************
+* @brief Comprueba el bus y actualiza el inventario
+*
+* Se eliminan las bajas de la actualizacion anterior y se confirma cada dispositivo con una pasada dirigida
+* ( _OneWire_SearchDirigida() ). Si todos responden y las discrepancias encontradas son exactamente las que
+* producen los Id's conocidos, el bus no ha cambiado. En caso contrario se recorre el arbol completo y se
+* marcan las altas y las bajas.
+*
+* Coste: con el bus estable, un reset y una pasada de 64 bits por dispositivo, exactamente lo mismo que enumerar
+* el bus con OneWire_SearchFirst() y OneWire_SearchNext() ( 16 sensores: 16 resets, 3200 slots ). Solo se ahorra
+* frente a OneWire_CuentaDispositivos() mas OneWire_SearchROM(), que recorren el arbol dos veces. Si el bus ha
+* cambiado se suman las pasadas hasta la primera que falla y la busqueda completa
+*
+* Las bajas se mantienen en la tabla, con ONEWIRE_INVENTARIO_BAJA, hasta la siguiente actualizacion
+*
+* @param pInventario Inventario a actualizar
+* @return Numero de cambios ( altas mas bajas ), 0 si el bus no ha cambiado
+*
+* Ejemplo:
+*
+*	OneWire_Inventario stInventario;
+*	int8 nDispositivo;
+*
+*	OneWire_InventarioInicia (&stInventario);
+*	while (1)
+*	{
+*		if (OneWire_InventarioActualiza (&stInventario))
+*		{
+*			for (nDispositivo = 0; nDispositivo < stInventario.nDispositivos; nDispositivo++)
+*			{
+*				if (stInventario.aEstado[nDispositivo] & ONEWIRE_INVENTARIO_ALTA)
+*				{
+*					//stInventario.aRom[nDispositivo] es un dispositivo nuevo
+*				}
+*				if (stInventario.aEstado[nDispositivo] & ONEWIRE_INVENTARIO_BAJA)
+*				{
+*					//stInventario.aRom[nDispositivo] se ha desconectado
+*				}
+*			}
+*		}
+*		delay_ms (1000);
+*	}
+*
+* Resultado:
+*
+*	Se informa de los dispositivos conectados y desconectados sin recorrer el arbol en cada ciclo
+*
+* @see OneWire_InventarioInicia(), OneWire_InventarioBusca()
+*/
+int8 OneWire_InventarioActualiza (OneWire_Inventario* pInventario)
+{
+	_OneWire_InventarioPurga (pInventario);
+	pInventario->lBusqueda = 0;
+	if (_OneWire_InventarioConfirma (pInventario))
+	{
+		return 0;
+	}
+	pInventario->lBusqueda = 1;
+	_OneWire_InventarioRecorre (pInventario);
+	return pInventario->nAltas + pInventario->nBajas;
+}
+/**
+******************************************************
+* @brief Busca un Id en el inventario
+*
+* La tabla esta en el orden de la busqueda, igual que OneWire_Lista, asi que localizar un Id cuesta log2(n)
+* comparaciones
+*
+* @param pInventario Inventario
+* @param aRom Id de 8 bytes
+* @return Posicion del Id en la tabla, ONEWIRE_INVENTARIO_NINGUNO si no esta
+*
+* Ejemplo:
+*
+*	int8 aRom[8] = {0x28, 0x13, 0x8A, 0x2B, 0x03, 0x00, 0x00, 0x5D};
+*
+*	if (OneWire_InventarioBusca (&stInventario, aRom) != ONEWIRE_INVENTARIO_NINGUNO)
+*	{
+*		//El sensor esta en el bus
+*	}
+*
+* @see OneWire_InventarioActualiza()
+*/
+int8 OneWire_InventarioBusca (OneWire_Inventario* pInventario, int8* aRom)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nDispositivo;
+	//-------------------------------------------------------------
+
+	nDispositivo = _OneWire_InventarioPosicion (pInventario, aRom);
+	if (nDispositivo < pInventario->nDispositivos && _OneWire_RomDiferencia (pInventario->aRom[nDispositivo], aRom) == 0)
+	{
+		return nDispositivo;
+	}
+	return ONEWIRE_INVENTARIO_NINGUNO;
+}
+/**
+******************************************************
+* @brief Busqueda binaria de la posicion de un Id
+*
+* Funcion interna. Un Id va antes que otro si en la primera posicion en la que se separan tiene un 0, la rama que
+* la busqueda recorre primero
+*
+* @return Posicion del primer Id de la tabla que no va antes que aRom ( nDispositivos si van todos antes )
+*/
+int8 _OneWire_InventarioPosicion (OneWire_Inventario* pInventario, int8* aRom)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nDesde, nHasta, nMitad, nPosicion;
+	//-------------------------------------------------------------
+
+	nDesde = 0;
+	nHasta = pInventario->nDispositivos;
+	while (nDesde < nHasta)
+	{
+		nMitad = nDesde + ((nHasta - nDesde) >> 1);
+		nPosicion = _OneWire_RomDiferencia (pInventario->aRom[nMitad], aRom);
+		if (nPosicion != 0 && !bit_test (pInventario->aRom[nMitad][(nPosicion - 1) >> 3], (nPosicion - 1) & 7))
+		{
+			nDesde = nMitad + 1;
+		}else{
+			nHasta = nMitad;
+		}
+	}
+	return nDesde;
+}
+/**
+******************************************************
+* @brief Elimina las bajas y borra las marcas de la actualizacion anterior
+*
+* Funcion interna.
+*/
+void _OneWire_InventarioPurga (OneWire_Inventario* pInventario)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nOrigen, nDestino, nByte;
+	//-------------------------------------------------------------
+
+	nDestino = 0;
+	for (nOrigen = 0; nOrigen < pInventario->nDispositivos; nOrigen++)
+	{
+		if (pInventario->aEstado[nOrigen] & ONEWIRE_INVENTARIO_BAJA)
+		{
+			continue;
+		}
+		if (nDestino != nOrigen)
+		{
+			for (nByte = 0; nByte < 8; nByte++)
+			{
+				pInventario->aRom[nDestino][nByte] = pInventario->aRom[nOrigen][nByte];
+			}
+		}
+		pInventario->aEstado[nDestino] = 0;
+		nDestino++;
+	}
+	pInventario->nDispositivos = nDestino;
+	pInventario->nAltas = 0;
+	pInventario->nBajas = 0;
+}
+/**
+******************************************************
+* @brief Confirma todos los dispositivos del inventario con pasadas dirigidas
+*
+* Funcion interna. Si hay dispositivos que no caben en la tabla no se puede confirmar y se recorre el arbol
+*
+* @return 1 si el bus coincide con el inventario, 0 si hay que recorrer el arbol
+*
+* @see _OneWire_ConfirmaRoms()
+*/
+int1 _OneWire_InventarioConfirma (OneWire_Inventario* pInventario)
+{
+	if (pInventario->lDesbordado)
+	{
+		return 0;
+	}
+	return _OneWire_ConfirmaRoms (pInventario->aRom[0], pInventario->nDispositivos);
+}
+/**
+******************************************************
+* @brief Recorre el arbol completo y marca las altas y las bajas
+*
+* Funcion interna.
+*/
+void _OneWire_InventarioRecorre (OneWire_Inventario* pInventario)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_Busqueda stBusqueda;
+	int8 aRom[8];
+	int8 nDispositivo, nPosicion, nByte;
+	int1 lEncontrado;
+	//-------------------------------------------------------------
+
+	pInventario->lDesbordado = 0;
+	for (lEncontrado = OneWire_SearchFirst (&stBusqueda, aRom); lEncontrado; lEncontrado = OneWire_SearchNext (&stBusqueda, aRom))
+	{
+		nPosicion = _OneWire_InventarioPosicion (pInventario, aRom);
+		if (nPosicion < pInventario->nDispositivos && _OneWire_RomDiferencia (pInventario->aRom[nPosicion], aRom) == 0)
+		{
+			pInventario->aEstado[nPosicion] |= ONEWIRE_INVENTARIO_VISTO;
+		}else if (pInventario->nDispositivos < ONEWIRE_INVENTARIO_MAX){
+			for (nDispositivo = pInventario->nDispositivos; nDispositivo > nPosicion; nDispositivo--)	//El alta ocupa su lugar en el orden
+			{
+				for (nByte = 0; nByte < 8; nByte++)
+				{
+					pInventario->aRom[nDispositivo][nByte] = pInventario->aRom[nDispositivo - 1][nByte];
+				}
+				pInventario->aEstado[nDispositivo] = pInventario->aEstado[nDispositivo - 1];
+			}
+			for (nByte = 0; nByte < 8; nByte++)
+			{
+				pInventario->aRom[nPosicion][nByte] = aRom[nByte];
+			}
+			pInventario->aEstado[nPosicion] = ONEWIRE_INVENTARIO_ALTA | ONEWIRE_INVENTARIO_VISTO;
+			pInventario->nDispositivos++;
+			pInventario->nAltas++;
+		}else{
+			pInventario->lDesbordado = 1;									//No cabe, se volvera a recorrer el arbol en cada actualizacion
+		}
+	}
+	for (nDispositivo = 0; nDispositivo < pInventario->nDispositivos; nDispositivo++)
+	{
+		if (pInventario->aEstado[nDispositivo] & ONEWIRE_INVENTARIO_VISTO)
+		{
+			pInventario->aEstado[nDispositivo] &= ~ONEWIRE_INVENTARIO_VISTO;
+		}else{
+			pInventario->aEstado[nDispositivo] = ONEWIRE_INVENTARIO_BAJA;
+			pInventario->nBajas++;
+		}
+	}
+}
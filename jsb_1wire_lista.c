@@ -0,0 +1,562 @@
+/**
+******************************************************
+* @file jsb_1wire_lista.c
+* @brief Id's empaquetados y lista ordenada de dispositivos con busqueda binaria
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+/**
+******************************************************
+* @brief Crea un Id a partir de sus 8 bytes comprobando el CRC
+*
+* @param pRom Id a crear
+* @param aBytes Bytes del Id ( familia, numero de serie y CRC )
+* @return 1 si el CRC es correcto, 0 en caso contrario ( pRom queda con los bytes igualmente )
+*
+* Ejemplo:
+*
+*	OneWire_Rom stRom;
+*	int8 aBytes[8] = {0x28, 0x56, 0x34, 0x12, 0x00, 0x00, 0x00, 0x26};
+*
+*	if (OneWire_RomCrea (&stRom, aBytes))
+*	{
+*		OneWire_ListaInserta (&stLista, &stRom, 0);
+*	}
+*
+* @see OneWire_ListaInserta()
+*/
+int1 OneWire_RomCrea (OneWire_Rom* pRom, int8* aBytes)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nByte;
+	//-------------------------------------------------------------
+
+	for (nByte = 0; nByte < 8; nByte++)
+	{
+		pRom->aBytes[nByte] = aBytes[nByte];
+	}
+	return OneWire_CRCBloque (0, pRom->aBytes, 8) == 0;
+}
+/**
+******************************************************
+* @brief Compara dos Id's
+*
+* @return 1 si son iguales
+*/
+int1 OneWire_RomIgual (OneWire_Rom* pRom1, OneWire_Rom* pRom2)
+{
+	return pRom1->aPalabras[0] == pRom2->aPalabras[0] && pRom1->aPalabras[1] == pRom2->aPalabras[1];
+}
+/**
+******************************************************
+* @brief Orden de la busqueda entre dos Id's
+*
+* Un Id va antes que otro si en el primer bit en el que se separan ( empezando por el bit 0 del byte 0 ) tiene
+* un 0, que es la rama que toma primero la busqueda
+*
+* @return 1 si pRom1 va antes que pRom2
+*
+* @see OneWire_ListaInserta()
+*/
+int1 OneWire_RomMenor (OneWire_Rom* pRom1, OneWire_Rom* pRom2)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nByte, nDiferencia;
+	//-------------------------------------------------------------
+
+	nByte = 0;
+	if (pRom1->aPalabras[0] == pRom2->aPalabras[0])						//La primera mitad es igual, la saltamos
+	{
+		nByte = 4;
+	}
+	for (; nByte < 8; nByte++)
+	{
+		nDiferencia = pRom1->aBytes[nByte] ^ pRom2->aBytes[nByte];
+		if (nDiferencia)
+		{
+			nDiferencia &= ~nDiferencia + 1;								//Bit de menor peso que cambia
+			return (pRom1->aBytes[nByte] & nDiferencia) == 0;
+		}
+	}
+	return 0;
+}
+/**
+******************************************************
+* @brief Deja la lista vacia
+*
+* @param pLista Lista a iniciar
+*
+* @see OneWire_ListaLlena()
+*/
+void OneWire_ListaInicia (OneWire_Lista* pLista)
+{
+	pLista->nDispositivos = 0;
+	pLista->lDesbordada = 0;
+}
+/**
+******************************************************
+* @brief Llena la lista con los dispositivos del bus
+*
+* Una sola busqueda: el numero de dispositivos se obtiene a la vez que los Id's, sin el recorrido adicional de
+* OneWire_CuentaDispositivos(). Los Id's llegan ya ordenados, cada alta se anade al final. El dato de cada Id
+* queda a 0. Si no caben todos se para la busqueda y la lista queda desbordada
+*
+* @param pLista Lista a llenar, se vacia antes
+* @return Numero de dispositivos guardados ( como maximo ONEWIRE_LISTA_MAX )
+*
+* Ejemplo:
+*
+*	OneWire_Lista stLista;
+*	int8 nDispositivo, nPrimero, nSensores;
+*
+*	OneWire_ListaLlena (&stLista);
+*	nSensores = OneWire_ListaFamilia (&stLista, 0x28, &nPrimero);
+*	for (nDispositivo = nPrimero; nDispositivo < nPrimero + nSensores; nDispositivo++)
+*	{
+*		//stLista.aRom[nDispositivo] es un DS18B20
+*	}
+*
+* @see OneWire_ListaBusca(), OneWire_ListaFamilia()
+*/
+int8 OneWire_ListaLlena (OneWire_Lista* pLista)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_Busqueda stBusqueda;
+	OneWire_Rom stRom;
+	int1 lEncontrado;
+	//-------------------------------------------------------------
+
+	OneWire_ListaInicia (pLista);
+	for (lEncontrado = OneWire_SearchFirst (&stBusqueda, stRom.aBytes); lEncontrado; lEncontrado = OneWire_SearchNext (&stBusqueda, stRom.aBytes))
+	{
+		if (OneWire_ListaInserta (pLista, &stRom, 0) == ONEWIRE_LISTA_NINGUNO)
+		{
+			pLista->lDesbordada = 1;										//Lista llena, el resto del bus no se recorre
+			break;
+		}
+	}
+	return pLista->nDispositivos;
+}
+/**
+******************************************************
+* @brief Busca un Id en la lista
+*
+* @param pLista Lista
+* @param pRom Id a buscar
+* @return Posicion del Id o ONEWIRE_LISTA_NINGUNO si no esta
+*
+* Ejemplo:
+*
+*	nDispositivo = OneWire_ListaBusca (&stLista, &stRom);
+*	if (nDispositivo != ONEWIRE_LISTA_NINGUNO)
+*	{
+*		aMedidas[stLista.aDato[nDispositivo]] = nTemperatura;
+*	}
+*
+* Resultado:
+*
+*	Con 128 Id's, 7 comparaciones en lugar de hasta 128
+*
+* @see OneWire_ListaInserta()
+*/
+int8 OneWire_ListaBusca (OneWire_Lista* pLista, OneWire_Rom* pRom)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nPosicion;
+	//-------------------------------------------------------------
+
+	nPosicion = _OneWire_ListaPosicion (pLista, pRom);
+	if (nPosicion < pLista->nDispositivos && OneWire_RomIgual (&pLista->aRom[nPosicion], pRom))
+	{
+		return nPosicion;
+	}
+	return ONEWIRE_LISTA_NINGUNO;
+}
+/**
+******************************************************
+* @brief Anade un Id a la lista en su posicion
+*
+* Los Id's siguientes se desplazan una posicion con su dato. Si el Id ya esta solo se cambia su dato
+*
+* @param pLista Lista
+* @param pRom Id a anadir
+* @param nDato Dato del llamador asociado al Id
+* @return Posicion del Id o ONEWIRE_LISTA_NINGUNO si la lista esta llena
+*
+* @see OneWire_ListaElimina(), OneWire_RomCrea()
+*/
+int8 OneWire_ListaInserta (OneWire_Lista* pLista, OneWire_Rom* pRom, int8 nDato)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nPosicion, nDispositivo;
+	//-------------------------------------------------------------
+
+	nPosicion = _OneWire_ListaPosicion (pLista, pRom);
+	if (nPosicion < pLista->nDispositivos && OneWire_RomIgual (&pLista->aRom[nPosicion], pRom))
+	{
+		pLista->aDato[nPosicion] = nDato;
+		return nPosicion;
+	}
+	if (pLista->nDispositivos >= ONEWIRE_LISTA_MAX)
+	{
+		return ONEWIRE_LISTA_NINGUNO;
+	}
+	for (nDispositivo = pLista->nDispositivos; nDispositivo > nPosicion; nDispositivo--)
+	{
+		pLista->aRom[nDispositivo] = pLista->aRom[nDispositivo - 1];
+		pLista->aDato[nDispositivo] = pLista->aDato[nDispositivo - 1];
+	}
+	pLista->aRom[nPosicion] = *pRom;
+	pLista->aDato[nPosicion] = nDato;
+	pLista->nDispositivos++;
+	return nPosicion;
+}
+/**
+******************************************************
+* @brief Quita un Id de la lista
+*
+* @param pLista Lista
+* @param pRom Id a quitar
+* @return 1 si estaba en la lista
+*
+* @see OneWire_ListaInserta()
+*/
+int1 OneWire_ListaElimina (OneWire_Lista* pLista, OneWire_Rom* pRom)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nDispositivo;
+	//-------------------------------------------------------------
+
+	nDispositivo = OneWire_ListaBusca (pLista, pRom);
+	if (nDispositivo == ONEWIRE_LISTA_NINGUNO)
+	{
+		return 0;
+	}
+	pLista->nDispositivos--;
+	for (; nDispositivo < pLista->nDispositivos; nDispositivo++)
+	{
+		pLista->aRom[nDispositivo] = pLista->aRom[nDispositivo + 1];
+		pLista->aDato[nDispositivo] = pLista->aDato[nDispositivo + 1];
+	}
+	return 1;
+}
+/**
+******************************************************
+* @brief Localiza los Id's de una familia
+*
+* Los Id's de una familia comparten los 8 primeros bits de la busqueda y estan seguidos en la lista. El primero
+* es el que iria en el lugar del Id formado por el codigo de familia y ceros
+*
+* @param pLista Lista
+* @param cFamilia Codigo de familia ( 0x28 DS18B20, 0x10 DS1820,... )
+* @param pPrimero Donde se deja la posicion del primer Id de la familia
+* @return Numero de Id's de la familia
+*
+* @see OneWire_ListaLlena(), OneWire_SearchFamilia()
+*/
+int8 OneWire_ListaFamilia (OneWire_Lista* pLista, int8 cFamilia, int8* pPrimero)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_Rom stInicio;
+	int8 nDispositivo;
+	//-------------------------------------------------------------
+
+	stInicio.aPalabras[0] = 0;
+	stInicio.aPalabras[1] = 0;
+	stInicio.aBytes[0] = cFamilia;
+	*pPrimero = _OneWire_ListaPosicion (pLista, &stInicio);
+	for (nDispositivo = *pPrimero; nDispositivo < pLista->nDispositivos; nDispositivo++)
+	{
+		if (pLista->aRom[nDispositivo].aBytes[0] != cFamilia)
+		{
+			break;
+		}
+	}
+	return nDispositivo - *pPrimero;
+}
+/**
+******************************************************
+* @brief Guarda la lista en la EEPROM
+*
+* Solo se escriben los bytes que han cambiado, para no gastar la EEPROM cuando la lista no cambia
+*
+* @param pLista Lista a guardar
+* @param nDireccion Direccion de la EEPROM, se usan 4 + 8 * nDispositivos bytes
+*
+* @see OneWire_ListaArranca(), OneWire_ListaRecupera()
+*/
+void OneWire_ListaGuarda (OneWire_Lista* pLista, int16 nDireccion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int16 nCRC;
+	int8 nDispositivo, nByte, cDato;
+	//-------------------------------------------------------------
+
+	nCRC = 0;
+	for (nByte = 0; nByte < 2; nByte++)									//Marca y numero de Id's
+	{
+		if (nByte == 0)
+		{
+			cDato = pLista->lDesbordada ? ONEWIRE_LISTA_MARCA_DESBORDADA : ONEWIRE_LISTA_MARCA;
+		}else{
+			cDato = pLista->nDispositivos;
+		}
+		_OneWire_ListaEscribe (nDireccion++, cDato);
+		nCRC = OneWire_CRC16 (nCRC, cDato);
+	}
+	for (nDispositivo = 0; nDispositivo < pLista->nDispositivos; nDispositivo++)
+	{
+		for (nByte = 0; nByte < 8; nByte++)								//7 bytes del Id y el dato en el lugar del CRC
+		{
+			cDato = nByte < 7 ? pLista->aRom[nDispositivo].aBytes[nByte] : pLista->aDato[nDispositivo];
+			_OneWire_ListaEscribe (nDireccion++, cDato);
+			nCRC = OneWire_CRC16 (nCRC, cDato);
+		}
+	}
+	_OneWire_ListaEscribe (nDireccion++, make8 (nCRC, 0));
+	_OneWire_ListaEscribe (nDireccion, make8 (nCRC, 1));
+}
+/**
+******************************************************
+* @brief Recupera una lista guardada con OneWire_ListaGuarda()
+*
+* No usa el bus. Para comprobar que los dispositivos siguen conectados se usa OneWire_ListaArranca()
+*
+* @param pLista Lista donde se deja la copia, vacia si no hay una copia valida
+* @param nDireccion Direccion de la EEPROM
+* @return 1 si la marca, el tamano y el CRC16 son correctos. La marca dice tambien si la lista estaba desbordada
+*
+* @see OneWire_ListaGuarda()
+*/
+int1 OneWire_ListaRecupera (OneWire_Lista* pLista, int16 nDireccion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int16 nCRC;
+	int8 nDispositivo, nByte, cDato, cMarca;
+	//-------------------------------------------------------------
+
+	OneWire_ListaInicia (pLista);
+	cMarca = _OneWire_EepromLee (nDireccion);
+	if ((cMarca != ONEWIRE_LISTA_MARCA && cMarca != ONEWIRE_LISTA_MARCA_DESBORDADA) || _OneWire_EepromLee (nDireccion + 1) > ONEWIRE_LISTA_MAX)
+	{
+		return 0;
+	}
+	nCRC = OneWire_CRC16 (0, cMarca);
+	nCRC = OneWire_CRC16 (nCRC, _OneWire_EepromLee (nDireccion + 1));
+	for (nDispositivo = 0; nDispositivo < _OneWire_EepromLee (nDireccion + 1); nDispositivo++)
+	{
+		for (nByte = 0; nByte < 8; nByte++)
+		{
+			cDato = _OneWire_EepromLee (nDireccion + 2 + 8 * (int16)nDispositivo + nByte);
+			nCRC = OneWire_CRC16 (nCRC, cDato);
+			if (nByte < 7)
+			{
+				pLista->aRom[nDispositivo].aBytes[nByte] = cDato;
+			}else{
+				pLista->aDato[nDispositivo] = cDato;
+			}
+		}
+		pLista->aRom[nDispositivo].aBytes[7] = OneWire_CRCBloque (0, pLista->aRom[nDispositivo].aBytes, 7);
+	}
+	nDireccion += 2 + 8 * (int16)nDispositivo;
+	if (make16 (_OneWire_EepromLee (nDireccion + 1), _OneWire_EepromLee (nDireccion)) != nCRC)
+	{
+		return 0;
+	}
+	pLista->nDispositivos = nDispositivo;
+	pLista->lDesbordada = cMarca == ONEWIRE_LISTA_MARCA_DESBORDADA;
+	return 1;
+}
+/**
+******************************************************
+* @brief Recupera la lista al arrancar y la confirma en el bus
+*
+* Si hay una copia valida en la EEPROM cada Id se confirma con una pasada dirigida y las discrepancias de la
+* pasada se comparan con las que producen los demas Id's de la lista, asi se detectan tanto las bajas como
+* los dispositivos nuevos. Solo si algo no coincide, o la lista estaba desbordada, se recorre el arbol completo;
+* en ese caso los Id's que ya estaban conservan su dato y la nueva lista se guarda
+*
+* @param pLista Lista a recuperar
+* @param nDireccion Direccion de la EEPROM
+* @return 1 si el bus coincide con la copia guardada, 0 si se ha tenido que recorrer el arbol
+*
+* Ejemplo:
+*
+*	OneWire_Lista stLista;
+*
+*	OneWire_ListaArranca (&stLista, 0x00);
+*	//Ya se puede leer el primer sensor
+*
+* Resultado:
+*
+*	Con el bus sin cambios, una pasada dirigida por dispositivo: tantas pasadas como una busqueda completa, pero la
+*	lista conserva el dato de cada Id sin reescribir la EEPROM. Si hay cambios se suma la busqueda a las pasadas
+*
+* @see OneWire_ListaGuarda(), OneWire_ListaLlena()
+*/
+int1 OneWire_ListaArranca (OneWire_Lista* pLista, int16 nDireccion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int1 lCopia;
+	//-------------------------------------------------------------
+
+	lCopia = OneWire_ListaRecupera (pLista, nDireccion);
+	if (lCopia && OneWire_ListaConfirma (pLista))
+	{
+		return 1;
+	}
+	OneWire_ListaLlena (pLista);
+	if (lCopia)
+	{
+		_OneWire_ListaDatos (pLista, nDireccion);
+	}
+	OneWire_ListaGuarda (pLista, nDireccion);
+	return 0;
+}
+/**
+******************************************************
+* @brief Confirma todos los Id's de la lista con pasadas dirigidas
+*
+* Cada pasada debe llegar al final y encontrar exactamente las discrepancias en las que los demas Id's se separan
+* del seguido ( _OneWire_ConfirmaRoms() ). Una lista desbordada no se puede confirmar. No modifica la lista
+*
+* @param pLista Lista a comprobar
+* @return 1 si el bus coincide con la lista
+*
+* Ejemplo:
+*
+*	if (OneWire_ListaRecupera (&stLista, 0))
+*	{
+*		//Primera medida con los Id's guardados
+*		if (!OneWire_ListaConfirma (&stLista))
+*		{
+*			OneWire_ListaArranca (&stLista, 0);
+*		}
+*	}
+*
+* Resultado:
+*
+*	La primera medida no espera a las pasadas por el bus; si el bus ha cambiado se recorre el arbol despues
+*
+* @see OneWire_ListaArranca(), OneWire_Verifica()
+*/
+int1 OneWire_ListaConfirma (OneWire_Lista* pLista)
+{
+	if (pLista->lDesbordada)
+	{
+		return 0;
+	}
+	return _OneWire_ConfirmaRoms (pLista->aRom[0].aBytes, pLista->nDispositivos);
+}
+/**
+******************************************************
+* @brief Busqueda binaria de la posicion de un Id
+*
+* Funcion interna.
+*
+* @return Posicion del primer Id de la lista que no va antes que pRom ( nDispositivos si van todos antes )
+*/
+int8 _OneWire_ListaPosicion (OneWire_Lista* pLista, OneWire_Rom* pRom)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nDesde, nHasta, nMitad;
+	//-------------------------------------------------------------
+
+	nDesde = 0;
+	nHasta = pLista->nDispositivos;
+	while (nDesde < nHasta)
+	{
+		nMitad = nDesde + ((nHasta - nDesde) >> 1);
+		if (OneWire_RomMenor (&pLista->aRom[nMitad], pRom))
+		{
+			nDesde = nMitad + 1;
+		}else{
+			nHasta = nMitad;
+		}
+	}
+	return nDesde;
+}
+/**
+******************************************************
+* @brief Copia los datos de una lista guardada a los Id's que siguen en la lista
+*
+* Funcion interna. La copia de la EEPROM ya se ha comprobado con OneWire_ListaRecupera()
+*/
+void _OneWire_ListaDatos (OneWire_Lista* pLista, int16 nDireccion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_Rom stRom;
+	int8 nGuardado, nDispositivo;
+	//-------------------------------------------------------------
+
+	for (nGuardado = 0; nGuardado < _OneWire_EepromLee (nDireccion + 1); nGuardado++)
+	{
+		_OneWire_ListaLeeRom (nDireccion + 2 + 8 * (int16)nGuardado, &stRom);
+		nDispositivo = OneWire_ListaBusca (pLista, &stRom);
+		if (nDispositivo != ONEWIRE_LISTA_NINGUNO)
+		{
+			pLista->aDato[nDispositivo] = _OneWire_EepromLee (nDireccion + 2 + 8 * (int16)nGuardado + 7);
+		}
+	}
+}
+/**
+******************************************************
+* @brief Lee un Id guardado y le anade el CRC
+*
+* Funcion interna.
+*/
+void _OneWire_ListaLeeRom (int16 nDireccion, OneWire_Rom* pRom)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nByte;
+	//-------------------------------------------------------------
+
+	for (nByte = 0; nByte < 7; nByte++)
+	{
+		pRom->aBytes[nByte] = _OneWire_EepromLee (nDireccion + nByte);
+	}
+	pRom->aBytes[7] = OneWire_CRCBloque (0, pRom->aBytes, 7);
+}
+/**
+******************************************************
+* @brief Escribe un byte de la EEPROM si ha cambiado
+*
+* Funcion interna.
+*/
+void _OneWire_ListaEscribe (int16 nDireccion, int8 cDato)
+{
+	if (_OneWire_EepromLee (nDireccion) != cDato)
+	{
+		_OneWire_EepromEscribe (nDireccion, cDato);
+	}
+}
@@ -0,0 +1,433 @@
+/**
+******************************************************
+* @file jsb_1wire_memoria.c
+* @brief Lectura y escritura de memorias EEPROM 1Wire ( DS2431 )
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+/**
+******************************************************
+* @brief Prepara la cache de un dispositivo de memoria
+*
+* @param pMemoria Estructura del dispositivo
+* @param aRom Id del dispositivo ( 8 bytes )
+*
+* Ejemplo:
+*
+*	OneWire_Memoria stEeprom;
+*	int8 aConfig[32];
+*
+*	OneWire_MemoriaInicia (&stEeprom, aRom);
+*	OneWire_MemoriaLee (&stEeprom, 0x0000, aConfig, 32);
+*
+* Resultado:
+*
+*	aConfig con los 32 primeros bytes del DS2431, leidos con un solo Read Memory
+*
+* @see OneWire_MemoriaLee(), OneWire_MemoriaEscribe()
+*/
+void OneWire_MemoriaInicia (OneWire_Memoria* pMemoria, int8* aRom)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nByte;
+	//-------------------------------------------------------------
+
+	for (nByte = 0; nByte < 8; nByte++)
+	{
+		pMemoria->aRom[nByte] = aRom[nByte];
+	}
+	pMemoria->nUso = 0;
+	OneWire_MemoriaDescarta (pMemoria);
+}
+/**
+******************************************************
+* @brief Lee un rango de la memoria
+*
+* Las filas que estan en la cache se toman de ella ( incluidas las escrituras pendientes ). El resto del rango
+* se lee con un solo Read Memory, desde la primera fila que falta hasta la ultima, y las filas leidas completas
+* se guardan en los huecos libres de la cache despues de copiar en aDatos las que ya estaban
+*
+* @param pMemoria Estructura del dispositivo
+* @param nDireccion Direccion del primer byte
+* @param aDatos Array donde se dejan los bytes
+* @param nBytes Numero de bytes
+*
+* @see OneWire_MemoriaLeeBloque(), OneWire_MemoriaEscribe()
+*/
+void OneWire_MemoriaLee (OneWire_Memoria* pMemoria, int16 nDireccion, int8* aDatos, int16 nBytes)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_MemoriaFila* pFila;
+	int16 nFila, nUltima, nDesde, nHasta, nInicio, nFin, nByte;
+	int8 nOffset;
+	//-------------------------------------------------------------
+
+	if (nBytes == 0)
+	{
+		return;
+	}
+	nFila = nDireccion - nDireccion % ONEWIRE_MEMORIA_FILA;
+	nUltima = (nDireccion + nBytes - 1) - (nDireccion + nBytes - 1) % ONEWIRE_MEMORIA_FILA;
+	nDesde = ONEWIRE_MEMORIA_LIBRE;
+	for (; nFila <= nUltima; nFila += ONEWIRE_MEMORIA_FILA)				//Filas que faltan en la cache
+	{
+		if (_OneWire_MemoriaBusca (pMemoria, nFila) == NULL)
+		{
+			if (nDesde == ONEWIRE_MEMORIA_LIBRE)
+			{
+				nDesde = nFila;
+			}
+			nHasta = nFila + ONEWIRE_MEMORIA_FILA;
+		}
+	}
+	if (nDesde != ONEWIRE_MEMORIA_LIBRE)
+	{
+		nInicio = nDesde > nDireccion ? nDesde : nDireccion;
+		nFin = nHasta < nDireccion + nBytes ? nHasta : nDireccion + nBytes;
+		OneWire_MemoriaLeeBloque (pMemoria->aRom, nInicio, &aDatos[nInicio - nDireccion], nFin - nInicio);
+	}
+	for (nByte = 0; nByte < nBytes; nByte++)							//Lo que esta en la cache es lo mas reciente
+	{
+		nFila = (nDireccion + nByte) - (nDireccion + nByte) % ONEWIRE_MEMORIA_FILA;
+		pFila = _OneWire_MemoriaBusca (pMemoria, nFila);
+		if (pFila != NULL)
+		{
+			aDatos[nByte] = pFila->aDatos[(nDireccion + nByte) % ONEWIRE_MEMORIA_FILA];
+			pFila->nUso = pMemoria->nUso;
+		}
+	}
+	if (nDesde != ONEWIRE_MEMORIA_LIBRE)								//Antes se copia la cache, guardar filas nuevas puede sacar filas del rango
+	{
+		for (nFila = nDesde; nFila < nHasta; nFila += ONEWIRE_MEMORIA_FILA)	//Guardamos las filas leidas completas
+		{
+			if (nFila < nInicio || nFila + ONEWIRE_MEMORIA_FILA > nFin || _OneWire_MemoriaBusca (pMemoria, nFila) != NULL)
+			{
+				continue;
+			}
+			pFila = _OneWire_MemoriaHueco (pMemoria);
+			if (pFila->lModificada)
+			{
+				break;														//Para leer no se escribe ninguna fila pendiente
+			}
+			pFila->nDireccion = nFila;
+			pFila->nUso = ++pMemoria->nUso;
+			for (nOffset = 0; nOffset < ONEWIRE_MEMORIA_FILA; nOffset++)
+			{
+				pFila->aDatos[nOffset] = aDatos[nFila - nDireccion + nOffset];
+			}
+		}
+	}
+}
+/**
+******************************************************
+* @brief Escribe un rango de la memoria en la cache
+*
+* Los bytes no se envian al dispositivo hasta OneWire_MemoriaGuarda() o hasta que se necesita el hueco de su
+* fila. Varias escrituras en la misma fila se envian juntas, y si los datos no cambian la fila no se escribe.
+* Para escribir parte de una fila que no esta en la cache se lee antes la fila completa
+*
+* @param pMemoria Estructura del dispositivo
+* @param nDireccion Direccion del primer byte
+* @param aDatos Bytes a escribir
+* @param nBytes Numero de bytes
+* @return 1 si todo ha ido bien, 0 si ha fallado la escritura de una fila sacada de la cache
+*
+* Ejemplo:
+*
+*	OneWire_MemoriaEscribe (&stEeprom, 0x0010, &nConsigna, 1);
+*	OneWire_MemoriaEscribe (&stEeprom, 0x0011, &nHisteresis, 1);
+*	OneWire_MemoriaGuarda (&stEeprom);
+*
+* Resultado:
+*
+*	Una sola escritura de la fila 0x0010 con los dos bytes cambiados
+*
+* @see OneWire_MemoriaGuarda(), OneWire_MemoriaLee()
+*/
+int1 OneWire_MemoriaEscribe (OneWire_Memoria* pMemoria, int16 nDireccion, int8* aDatos, int16 nBytes)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_MemoriaFila* pFila;
+	int16 nByte, nFila;
+	int8 nOffset, nTramo, nCopia;
+	int1 lCambia;
+	//-------------------------------------------------------------
+
+	for (nByte = 0; nByte < nBytes; nByte += nTramo)
+	{
+		nOffset = (nDireccion + nByte) % ONEWIRE_MEMORIA_FILA;
+		nFila = nDireccion + nByte - nOffset;
+		nTramo = ONEWIRE_MEMORIA_FILA - nOffset;
+		if (nTramo > nBytes - nByte)
+		{
+			nTramo = nBytes - nByte;
+		}
+		lCambia = 0;
+		pFila = _OneWire_MemoriaBusca (pMemoria, nFila);
+		if (pFila == NULL)
+		{
+			pFila = _OneWire_MemoriaHueco (pMemoria);
+			if (pFila->lModificada)
+			{
+				if (!OneWire_MemoriaEscribeFila (pMemoria->aRom, pFila->nDireccion, pFila->aDatos))
+				{
+					return 0;
+				}
+				pFila->lModificada = 0;
+			}
+			pFila->nDireccion = ONEWIRE_MEMORIA_LIBRE;
+			if (nTramo < ONEWIRE_MEMORIA_FILA)
+			{
+				OneWire_MemoriaLeeBloque (pMemoria->aRom, nFila, pFila->aDatos, ONEWIRE_MEMORIA_FILA);
+			}else{
+				lCambia = 1;												//Se sustituye la fila completa sin saber lo que tiene el dispositivo
+			}
+			pFila->nDireccion = nFila;
+		}
+		for (nCopia = 0; nCopia < nTramo; nCopia++)
+		{
+			if (pFila->aDatos[nOffset + nCopia] != aDatos[nByte + nCopia])
+			{
+				pFila->aDatos[nOffset + nCopia] = aDatos[nByte + nCopia];
+				lCambia = 1;
+			}
+		}
+		if (lCambia)
+		{
+			pFila->lModificada = 1;
+		}
+		pFila->nUso = ++pMemoria->nUso;
+	}
+	return 1;
+}
+/**
+******************************************************
+* @brief Escribe en el dispositivo las filas modificadas de la cache
+*
+* @param pMemoria Estructura del dispositivo
+* @return 1 si se han escrito todas, 0 si alguna ha fallado ( sigue pendiente en la cache )
+*
+* @see OneWire_MemoriaEscribe(), OneWire_MemoriaEscribeFila()
+*/
+int1 OneWire_MemoriaGuarda (OneWire_Memoria* pMemoria)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nFila;
+	int1 lCorrecto;
+	//-------------------------------------------------------------
+
+	lCorrecto = 1;
+	for (nFila = 0; nFila < ONEWIRE_MEMORIA_CACHE; nFila++)
+	{
+		if (pMemoria->aFilas[nFila].lModificada)
+		{
+			if (OneWire_MemoriaEscribeFila (pMemoria->aRom, pMemoria->aFilas[nFila].nDireccion, pMemoria->aFilas[nFila].aDatos))
+			{
+				pMemoria->aFilas[nFila].lModificada = 0;
+			}else{
+				lCorrecto = 0;
+			}
+		}
+	}
+	return lCorrecto;
+}
+/**
+******************************************************
+* @brief Vacia la cache sin escribir nada
+*
+* Para cuando otro maestro puede haber cambiado la memoria. Las escrituras pendientes se pierden
+*
+* @see OneWire_MemoriaGuarda()
+*/
+void OneWire_MemoriaDescarta (OneWire_Memoria* pMemoria)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nFila;
+	//-------------------------------------------------------------
+
+	for (nFila = 0; nFila < ONEWIRE_MEMORIA_CACHE; nFila++)
+	{
+		pMemoria->aFilas[nFila].nDireccion = ONEWIRE_MEMORIA_LIBRE;
+		pMemoria->aFilas[nFila].lModificada = 0;
+		pMemoria->aFilas[nFila].nUso = 0;
+	}
+}
+/**
+******************************************************
+* @brief Lee un rango de la memoria con un solo Read Memory, sin cache
+*
+* El dispositivo envia los bytes seguidos desde nDireccion. El DS2431 no envia CRC en esta lectura
+*
+* @param aRom Id del dispositivo
+* @param nDireccion Direccion del primer byte
+* @param aDatos Array donde se dejan los bytes
+* @param nBytes Numero de bytes
+*
+* @see OneWire_MemoriaLee()
+*/
+void OneWire_MemoriaLeeBloque (int8* aRom, int16 nDireccion, int8* aDatos, int16 nBytes)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 aComando[3];
+	int16 nByte, nTramo;
+	//-------------------------------------------------------------
+
+	aComando[0] = ONEWIRE_MEMORIA_READ;
+	aComando[1] = make8 (nDireccion, 0);
+	aComando[2] = make8 (nDireccion, 1);
+	OneWire_MatchROM (aRom);
+	OneWire_WriteBlock (aComando, 3, ONEWIRE_CRC_NINGUNO, 0);
+	for (nByte = 0; nByte < nBytes; nByte += nTramo)
+	{
+		nTramo = nBytes - nByte;
+		if (nTramo > ONEWIRE_MEMORIA_TRAMO)
+		{
+			nTramo = ONEWIRE_MEMORIA_TRAMO;
+		}
+		OneWire_ReadBlock (&aDatos[nByte], nTramo, ONEWIRE_CRC_NINGUNO, 0);
+	}
+}
+/**
+******************************************************
+* @brief Escribe una fila completa a traves del scratchpad
+*
+* Write Scratchpad comprobando el CRC16 que devuelve el dispositivo, Read Scratchpad comprobando direccion,
+* offset final, datos y CRC16, y Copy Scratchpad con la autorizacion leida. Tras la copia se espera
+* ONEWIRE_MEMORIA_PROGRAMACION ms y se comprueba que el dispositivo envia 0xAA
+*
+* @param aRom Id del dispositivo
+* @param nDireccion Direccion de la fila ( multiplo de ONEWIRE_MEMORIA_FILA )
+* @param aDatos ONEWIRE_MEMORIA_FILA bytes a escribir
+* @return 1 si la fila se ha escrito, 0 si ha fallado algun CRC, la comprobacion o la copia
+*
+* @see OneWire_MemoriaGuarda()
+*/
+int1 OneWire_MemoriaEscribeFila (int8* aRom, int16 nDireccion, int8* aDatos)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 aComando[4];
+	int8 aLeido[ONEWIRE_MEMORIA_FILA + 5];
+	int8 nByte;
+	int16 nCRC;
+	//-------------------------------------------------------------
+
+	aComando[0] = ONEWIRE_MEMORIA_WRITE_SCRATCHPAD;
+	aComando[1] = make8 (nDireccion, 0);
+	aComando[2] = make8 (nDireccion, 1);
+	nCRC = 0;
+	OneWire_MatchROM (aRom);
+	OneWire_WriteBlock (aComando, 3, ONEWIRE_CRC_16, &nCRC);
+	OneWire_WriteBlock (aDatos, ONEWIRE_MEMORIA_FILA, ONEWIRE_CRC_16, &nCRC);
+	if (!OneWire_ReadBlock (aLeido, 2, ONEWIRE_CRC_16, &nCRC))
+	{
+		return 0;
+	}
+
+	aComando[0] = ONEWIRE_MEMORIA_READ_SCRATCHPAD;							//TA1, TA2, E/S, datos y CRC16
+	nCRC = 0;
+	OneWire_MatchROM (aRom);
+	OneWire_WriteBlock (aComando, 1, ONEWIRE_CRC_16, &nCRC);
+	if (!OneWire_ReadBlock (aLeido, ONEWIRE_MEMORIA_FILA + 5, ONEWIRE_CRC_16, &nCRC))
+	{
+		return 0;
+	}
+	if (aLeido[0] != aComando[1] || aLeido[1] != aComando[2] || aLeido[2] != ONEWIRE_MEMORIA_FILA - 1)
+	{
+		return 0;														//Otra direccion, fila incompleta ( PF ) o ya copiada ( AA )
+	}
+	for (nByte = 0; nByte < ONEWIRE_MEMORIA_FILA; nByte++)
+	{
+		if (aLeido[3 + nByte] != aDatos[nByte])
+		{
+			return 0;
+		}
+	}
+
+	aComando[0] = ONEWIRE_MEMORIA_COPY_SCRATCHPAD;							//Autorizacion: TA1, TA2 y E/S leidos
+	aComando[1] = aLeido[0];
+	aComando[2] = aLeido[1];
+	aComando[3] = aLeido[2];
+	OneWire_MatchROM (aRom);
+	OneWire_WriteBlock (aComando, 4, ONEWIRE_CRC_NINGUNO, 0);
+	_OneWire_DelayMs (ONEWIRE_MEMORIA_PROGRAMACION);
+	return OneWire_ReceiveByte () == ONEWIRE_MEMORIA_COPIA_OK;
+}
+/**
+******************************************************
+* @brief Busca una fila en la cache
+*
+* Funcion interna.
+*
+* @return Puntero a la fila o NULL si no esta
+*/
+OneWire_MemoriaFila* _OneWire_MemoriaBusca (OneWire_Memoria* pMemoria, int16 nDireccion)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nFila;
+	//-------------------------------------------------------------
+
+	for (nFila = 0; nFila < ONEWIRE_MEMORIA_CACHE; nFila++)
+	{
+		if (pMemoria->aFilas[nFila].nDireccion == nDireccion)
+		{
+			return &pMemoria->aFilas[nFila];
+		}
+	}
+	return NULL;
+}
+/**
+******************************************************
+* @brief Elige la fila de la cache a sustituir
+*
+* Funcion interna. Una libre si la hay; si no, la menos usada de las no modificadas; y si todas estan
+* modificadas, la menos usada ( el llamador debe escribirla antes )
+*/
+OneWire_MemoriaFila* _OneWire_MemoriaHueco (OneWire_Memoria* pMemoria)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	OneWire_MemoriaFila* pElegida;
+	int8 nFila;
+	//-------------------------------------------------------------
+
+	pElegida = &pMemoria->aFilas[0];
+	for (nFila = 0; nFila < ONEWIRE_MEMORIA_CACHE; nFila++)
+	{
+		OneWire_MemoriaFila* pFila = &pMemoria->aFilas[nFila];
+		if (pFila->nDireccion == ONEWIRE_MEMORIA_LIBRE)
+		{
+			return pFila;
+		}
+		if (pFila->lModificada != pElegida->lModificada)
+		{
+			if (!pFila->lModificada)
+			{
+				pElegida = pFila;
+			}
+		}else if (pFila->nUso < pElegida->nUso){
+			pElegida = pFila;
+		}
+	}
+	return pElegida;
+}
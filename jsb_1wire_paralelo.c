@@ -0,0 +1,386 @@
+/**
+******************************************************
+* @file jsb_1wire_paralelo.c
+* @brief Hasta 8 buses 1Wire en los pines de un mismo puerto funcionando a la vez
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+/**
+******************************************************
+* @brief Prepara los pines del puerto
+*
+* Deja los buses en alta impedancia y el latch de sus pines a 0, para que el pulso bajo sea solo un cambio del TRIS
+*/
+void OneWirePar_Inicia (void)
+{
+	_OneWirePar_Inicia ();
+}
+/**
+******************************************************
+* @brief Envia el pulso de reset a varios buses a la vez
+*
+* @param cBuses Mascara con los buses a resetear
+* @return Mascara con los buses en los que algun dispositivo ha respondido
+*
+* Ejemplo:
+*
+*	int8 cPresentes;
+*
+*	cPresentes = OneWirePar_Reset (0x0F);
+*
+* Resultado:
+*
+*	cPresentes = 0x0B si hay dispositivos en los buses 0, 1 y 3
+*
+* @see OneWire_Reset()
+*/
+int8 OneWirePar_Reset (int8 cBuses)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 cPresentes;
+	//-------------------------------------------------------------
+
+	_OneWirePar_Bajo (cBuses);
+	_OneWirePar_DelayUs (_ONEWIRE_T_RESET_BAJO);
+	_OneWire_BloqueaSi (_ONEWIRE_T_RESET_MUESTREO)						//Mismas ventanas que _OneWire_PulsoReset()
+	_OneWirePar_Libera (cBuses);
+	_OneWirePar_DelayUs (_ONEWIRE_T_RESET_MUESTREO);
+	cPresentes = ~_OneWirePar_Lee () & cBuses;								//El pulso de presencia pone a 0 el bus
+	_OneWire_Desbloquea ();
+	_OneWirePar_DelayUs (_ONEWIRE_T_RESET_FIN);
+	return cPresentes;
+}
+/**
+******************************************************
+* @brief Escribe un bit en cada bus
+*
+* @param cBuses Mascara con los buses en los que se escribe
+* @param cBits Bit a escribir en cada bus, en la misma posicion que el bus
+*
+* @see OneWire_Write()
+*/
+void OneWirePar_Write (int8 cBuses, int8 cBits)
+{
+	_OneWire_Bloquea ();													//Mismas ventanas que _OneWire_SlotEscribe()
+	_OneWirePar_Bajo (cBuses);
+	_OneWirePar_DelayUs (_ONEWIRE_T_ESCRITURA_BAJO);
+	_OneWirePar_Libera (cBuses & cBits);									//Los buses con un 1 vuelven a 1 antes del muestreo
+	_OneWire_DesbloqueaSi (_ONEWIRE_T_ESCRITURA_BAJO + _ONEWIRE_T_ESCRITURA_BIT)
+	_OneWirePar_DelayUs (_ONEWIRE_T_ESCRITURA_BIT);
+	_OneWirePar_Libera (cBuses);
+	_OneWire_Desbloquea ();
+	_OneWirePar_DelayUs (_ONEWIRE_T_ESCRITURA_RECUPERA);
+}
+/**
+******************************************************
+* @brief Lee un bit de cada bus
+*
+* @param cBuses Mascara con los buses a leer
+* @return Bit leido de cada bus, en la misma posicion que el bus
+*
+* @see OneWire_LeeBit()
+*/
+int8 OneWirePar_LeeBit (int8 cBuses)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 cBits;
+	//-------------------------------------------------------------
+
+	_OneWire_Bloquea ();
+	_OneWirePar_Bajo (cBuses);
+	_OneWirePar_DelayUs (_ONEWIRE_T_LECTURA_BAJO);
+	_OneWirePar_Libera (cBuses);
+	_OneWirePar_DelayUs (_ONEWIRE_T_LECTURA_MUESTREO);
+	cBits = _OneWirePar_Lee () & cBuses;
+	_OneWire_Desbloquea ();
+	_OneWirePar_DelayUs (_ONEWIRE_T_LECTURA_RECUPERA);
+	return cBits;
+}
+/**
+******************************************************
+* @brief Envia el mismo byte a varios buses
+*
+* @param cBuses Mascara con los buses
+* @param cDato Byte a transmitir
+*
+* Ejemplo:
+*
+*	cPresentes = OneWirePar_Reset (0xFF);
+*	OneWirePar_SendByte (cPresentes, 0xCC);
+*	OneWirePar_SendByte (cPresentes, 0x44);
+*
+* Resultado:
+*
+*	Todos los sensores de los 8 buses empiezan la conversion
+*
+* @see OneWirePar_SendBytes(), OneWire_SendByte()
+*/
+void OneWirePar_SendByte (int8 cBuses, byte cDato)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nBit;
+	//-------------------------------------------------------------
+
+	for (nBit = 0; nBit < 8; nBit++)
+	{
+		OneWirePar_Write (cBuses, bit_test (cDato, nBit) ? cBuses : 0);
+	}
+}
+/**
+******************************************************
+* @brief Envia un byte distinto a cada bus
+*
+* @param cBuses Mascara con los buses
+* @param aDatos Array de 8 bytes, aDatos[n] es el byte para el bus n
+*
+* @see OneWirePar_SendByte()
+*/
+void OneWirePar_SendBytes (int8 cBuses, int8* aDatos)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nBit, nBus, cBits;
+	//-------------------------------------------------------------
+
+	for (nBit = 0; nBit < 8; nBit++)
+	{
+		cBits = 0;
+		for (nBus = 0; nBus < 8; nBus++)
+		{
+			if (bit_test (aDatos[nBus], nBit))
+			{
+				bit_set (cBits, nBus);
+			}
+		}
+		OneWirePar_Write (cBuses, cBits);
+	}
+}
+/**
+******************************************************
+* @brief Recibe un byte de cada bus
+*
+* @param cBuses Mascara con los buses
+* @param aDatos Array de 8 bytes donde se deja el byte recibido de cada bus
+*
+* @see OneWire_ReceiveByte()
+*/
+void OneWirePar_ReceiveByte (int8 cBuses, int8* aDatos)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nBit, nBus, cBits;
+	//-------------------------------------------------------------
+
+	for (nBus = 0; nBus < 8; nBus++)
+	{
+		aDatos[nBus] = 0;
+	}
+	for (nBit = 0; nBit < 8; nBit++)
+	{
+		cBits = OneWirePar_LeeBit (cBuses);
+		for (nBus = 0; nBus < 8; nBus++)
+		{
+			if (bit_test (cBits, nBus))
+			{
+				bit_set (aDatos[nBus], nBit);
+			}
+		}
+	}
+}
+/**
+******************************************************
+* @brief Inicia la busqueda de dispositivos en varios buses a la vez
+*
+* Cada llamada obtiene el siguiente dispositivo de cada bus en una sola pasada para todos ellos, asi que
+* recorrer los 8 buses cuesta lo mismo que recorrer el que tiene mas dispositivos
+*
+* @param pBusqueda Estructura con el estado de la busqueda
+* @param cBuses Mascara con los buses en los que buscar
+* @param aRoms Array de 8*8 bytes, el Id encontrado en el bus n se deja a partir de aRoms[n*8]
+* @return Mascara con los buses en los que se ha encontrado un dispositivo
+*
+* Ejemplo:
+*
+*	OneWirePar_Busqueda stBusqueda;
+*	int8 aRoms[64];
+*	int8 cEncontrados;
+*
+*	for (cEncontrados = OneWirePar_SearchFirst (&stBusqueda, 0xFF, aRoms); cEncontrados; cEncontrados = OneWirePar_SearchNext (&stBusqueda, aRoms))
+*	{
+*		//Hay un Id nuevo en aRoms[n*8] por cada bit n de cEncontrados
+*	}
+*
+* Resultado:
+*
+*	Se obtienen los Id's de los 8 buses
+*
+* @see OneWirePar_SearchNext(), OneWire_SearchFirst()
+*/
+int8 OneWirePar_SearchFirst (OneWirePar_Busqueda* pBusqueda, int8 cBuses, int8* aRoms)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nBus;
+	//-------------------------------------------------------------
+
+	for (nBus = 0; nBus < 8; nBus++)
+	{
+		pBusqueda->aBus[nBus].nUltimaDiscrepancia = 0;
+		pBusqueda->aBus[nBus].lUltimoDispositivo = 0;
+	}
+	pBusqueda->cActivos = cBuses;
+	return OneWirePar_SearchNext (pBusqueda, aRoms);
+}
+/**
+******************************************************
+* @brief Obtiene el siguiente dispositivo de cada bus
+*
+* @param pBusqueda Estructura con el estado de la busqueda
+* @param aRoms Array de 8*8 bytes donde se dejan los Id's encontrados, con el CRC ya comprobado
+* @return Mascara con los buses en los que se ha encontrado un dispositivo, 0 si la busqueda ha terminado en todos
+*
+* @see OneWirePar_SearchFirst()
+*/
+int8 OneWirePar_SearchNext (OneWirePar_Busqueda* pBusqueda, int8* aRoms)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 cEncontrados, nBus, nByte;
+	//-------------------------------------------------------------
+
+	for (nBus = 0; nBus < 8; nBus++)
+	{
+		if (pBusqueda->aBus[nBus].lUltimoDispositivo)
+		{
+			bit_clear (pBusqueda->cActivos, nBus);
+		}
+	}
+	if (pBusqueda->cActivos == 0)
+	{
+		return 0;
+	}
+	cEncontrados = _OneWirePar_SearchPasada (pBusqueda);
+	for (nBus = 0; nBus < 8; nBus++)
+	{
+		if (!bit_test (pBusqueda->cActivos, nBus))
+		{
+			continue;
+		}
+		if (!bit_test (cEncontrados, nBus) || OneWire_CRCBloque (0, pBusqueda->aBus[nBus].aRom, 8) != 0)
+		{
+			bit_clear (cEncontrados, nBus);									//Sin dispositivos o Id erroneo, la busqueda termina en ese bus
+			bit_clear (pBusqueda->cActivos, nBus);
+			pBusqueda->aBus[nBus].lUltimoDispositivo = 1;
+			continue;
+		}
+		for (nByte = 0; nByte < 8; nByte++)
+		{
+			aRoms[nBus*8 + nByte] = pBusqueda->aBus[nBus].aRom[nByte];
+		}
+	}
+	return cEncontrados;
+}
+/**
+******************************************************
+* @brief Recorre una rama del arbol de Id's en cada bus activo
+*
+* Funcion interna. Es el mismo algoritmo que _OneWire_SearchPasada(), pero el bit y el complemento se leen a la vez
+* en todos los buses y la direccion de cada bus se escribe en un solo slot
+*
+* @return Mascara con los buses en los que se han leido los 64 bits
+*/
+int8 _OneWirePar_SearchPasada (OneWirePar_Busqueda* pBusqueda)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 aUltimoCero[8];
+	int8 cBuses, cBit, cComplemento, cDireccion;
+	int8 nPosBit, nByte, nMascara, nBus;
+	int1 lDireccion;
+	OneWire_Busqueda* pBus;
+	//-------------------------------------------------------------
+
+	cBuses = OneWirePar_Reset (pBusqueda->cActivos);
+	if (cBuses == 0)
+	{
+		return 0;
+	}
+	OneWirePar_SendByte (cBuses, 0xF0);
+	for (nBus = 0; nBus < 8; nBus++)
+	{
+		aUltimoCero[nBus] = 0;
+	}
+	nByte = 0;
+	nMascara = 1;
+	for (nPosBit = 1; nPosBit <= 64 && cBuses; nPosBit++)
+	{
+		cBit = OneWirePar_LeeBit (cBuses);
+		cComplemento = OneWirePar_LeeBit (cBuses);
+		cBuses &= ~(cBit & cComplemento);									//En esos buses nadie ha respondido
+		cDireccion = 0;
+		for (nBus = 0; nBus < 8; nBus++)
+		{
+			if (!bit_test (cBuses, nBus))
+			{
+				continue;
+			}
+			pBus = &pBusqueda->aBus[nBus];
+			if (bit_test (cBit, nBus) || bit_test (cComplemento, nBus))	//Todos los dispositivos tienen el mismo bit
+			{
+				lDireccion = bit_test (cBit, nBus);
+			}else{
+				if (nPosBit < pBus->nUltimaDiscrepancia)
+				{
+					lDireccion = (pBus->aRom[nByte] & nMascara) != 0;
+				}else{
+					lDireccion = (nPosBit == pBus->nUltimaDiscrepancia);
+				}
+				if (!lDireccion)
+				{
+					aUltimoCero[nBus] = nPosBit;
+				}
+			}
+			if (lDireccion)
+			{
+				pBus->aRom[nByte] |= nMascara;
+				bit_set (cDireccion, nBus);
+			}else{
+				pBus->aRom[nByte] &= ~nMascara;
+			}
+		}
+		OneWirePar_Write (cBuses, cDireccion);
+		nMascara <<= 1;
+		if (nMascara == 0)
+		{
+			nByte++;
+			nMascara = 1;
+		}
+	}
+	for (nBus = 0; nBus < 8; nBus++)
+	{
+		if (bit_test (cBuses, nBus))
+		{
+			pBusqueda->aBus[nBus].nUltimaDiscrepancia = aUltimoCero[nBus];
+			if (aUltimoCero[nBus] == 0)
+			{
+				pBusqueda->aBus[nBus].lUltimoDispositivo = 1;
+			}
+		}
+	}
+	return cBuses;
+}
@@ -0,0 +1,1384 @@
+/**
+******************************************************
+* @file jsb_1wire_sim.c
+* @brief Simulador en PC de un bus 1Wire con reloj virtual en microsegundos
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+OneWireSim_Bus OneWireSim;
+OneWireSim_Puerto OneWireSimPuerto;
+OneWireSim_Interrupciones OneWireSimInt;
+int8 OneWireSimEeprom[ONEWIRE_SIM_EEPROM];
+#ifdef ONEWIRE_UART
+OneWireSim_Serie OneWireSimSerie;
+#endif
+#ifdef ONEWIRE_DS2482
+OneWireSim_Puente OneWireSimPuente = {ONEWIRE_DS2482_RST, 0, 0, ONEWIRE_DS2482_REG_ESTADO, 0, 0, 0, 0, 0, 0};
+#endif
+
+/**
+******************************************************
+* @brief Inicializa el bus virtual sin esclavos y con los tiempos de velocidad estandar
+*
+* Ejemplo:
+*
+*	int8 aRom[8];
+*
+*	OneWireSim_Inicia();
+*	OneWireSim_RomConCRC (0x28, 0x123456, aRom);
+*	OneWireSim_AnadeEsclavo (aRom);
+*
+* Resultado:
+*
+*	Bus con un DS18B20 conectado y el reloj virtual a 0
+*
+* @see OneWireSim_Termina(), OneWireSim_AnadeEsclavo()
+*/
+void OneWireSim_Inicia (void)
+{
+	memset (&OneWireSim, 0, sizeof (OneWireSim));
+	memset (&OneWireSimInt, 0, sizeof (OneWireSimInt));
+	OneWireSim.stTiempos.nResetMin = 480;
+	OneWireSim.stTiempos.nPresenciaEspera = 30;
+	OneWireSim.stTiempos.nPresenciaAncho = 120;
+	OneWireSim.stTiempos.nMuestreo = 30;
+	OneWireSim.stTiempos.nMantenimiento = 30;
+	OneWireSim.stTiemposOD.nResetMin = 48;
+	OneWireSim.stTiemposOD.nPresenciaEspera = 3;
+	OneWireSim.stTiemposOD.nPresenciaAncho = 12;
+	OneWireSim.stTiemposOD.nMuestreo = 3;
+	OneWireSim.stTiemposOD.nMantenimiento = 4;
+}
+/**
+******************************************************
+* @brief Libera los esclavos del bus virtual
+*
+* @see OneWireSim_Inicia()
+*/
+void OneWireSim_Termina (void)
+{
+	int32 nEsclavo;
+
+	for (nEsclavo = 0; nEsclavo < OneWireSim.nEsclavos; nEsclavo++)
+	{
+		free (OneWireSim.aEsclavos[nEsclavo].pDatos);
+	}
+	free (OneWireSim.aEsclavos);
+	OneWireSim.aEsclavos = NULL;
+	OneWireSim.nEsclavos = 0;
+}
+/**
+******************************************************
+* @brief Conecta un nuevo esclavo al bus virtual
+*
+* El esclavo no participa en el bus hasta el siguiente reset
+*
+* @param aRom Array con los 8 bytes del Id del esclavo
+* @return Puntero al esclavo creado. Deja de ser valido si se anaden mas esclavos
+*
+* @see OneWireSim_Desconecta(), OneWireSim_RomConCRC()
+*/
+OneWireSim_Esclavo* OneWireSim_AnadeEsclavo (int8* aRom)
+{
+	OneWireSim_Esclavo* pEsclavo;
+
+	OneWireSim.aEsclavos = realloc (OneWireSim.aEsclavos, (OneWireSim.nEsclavos+1) * sizeof (OneWireSim_Esclavo));
+	pEsclavo = &OneWireSim.aEsclavos[OneWireSim.nEsclavos++];
+	memset (pEsclavo, 0, sizeof (OneWireSim_Esclavo));
+	memcpy (pEsclavo->aRom, aRom, 8);
+	pEsclavo->lConectado = 1;
+	pEsclavo->nEstado = ONEWIRE_SIM_ESPERA_RESET;
+	return pEsclavo;
+}
+/**
+******************************************************
+* @brief Desconecta un esclavo del bus virtual
+*
+* @param nEsclavo Indice del esclavo en el orden en el que se anadio
+*/
+void OneWireSim_Desconecta (int32 nEsclavo)
+{
+	OneWireSim.aEsclavos[nEsclavo].lConectado = 0;
+	OneWireSim.aEsclavos[nEsclavo].nBajoHasta = 0;
+	OneWireSim.aEsclavos[nEsclavo].nMuestreo = 0;
+}
+/**
+******************************************************
+* @brief Carga bytes para que el esclavo los envie en los siguientes slots de lectura
+*
+* Normalmente se llama desde la funcion pfFuncion del esclavo para responder a un comando
+*
+* @param pEsclavo Esclavo que envia
+* @param aDatos Bytes a enviar
+* @param nBytes Numero de bytes
+*/
+void OneWireSim_Envia (OneWireSim_Esclavo* pEsclavo, int8* aDatos, int8 nBytes)
+{
+	int8 nByte;
+
+	if (pEsclavo->nTxPos >= pEsclavo->nTxBits)							//Si ya se envio lo anterior empezamos el buffer desde el principio
+	{
+		pEsclavo->nTxPos = 0;
+		pEsclavo->nTxBits = 0;
+	}
+	for (nByte = 0; nByte < nBytes && pEsclavo->nTxBits < ONEWIRE_SIM_MAX_TX*8; nByte++)
+	{
+		pEsclavo->aTx[pEsclavo->nTxBits/8] = aDatos[nByte];
+		pEsclavo->nTxBits += 8;
+	}
+}
+/**
+******************************************************
+* @brief Construye un Id valido a partir del codigo de familia y el numero de serie
+*
+* @param cFamilia Codigo de familia ( 0x28 DS18B20, 0x10 DS1820,... )
+* @param nSerie Numero de serie de 48 bits
+* @param aRom Array de 8 bytes donde se deja el Id con su CRC
+*/
+void OneWireSim_RomConCRC (int8 cFamilia, int64 nSerie, int8* aRom)
+{
+	int8 nByte, nBit, nCRC;
+
+	aRom[0] = cFamilia;
+	for (nByte = 1; nByte < 7; nByte++)
+	{
+		aRom[nByte] = (int8) (nSerie >> ((nByte-1)*8));
+	}
+	nCRC = 0;
+	for (nByte = 0; nByte < 7; nByte++)
+	{
+		nCRC ^= aRom[nByte];
+		for (nBit = 0; nBit < 8; nBit++)
+		{
+			nCRC = (nCRC & 0x01) ? (nCRC >> 1) ^ 0x8C : nCRC >> 1;
+		}
+	}
+	aRom[7] = nCRC;
+}
+/**
+******************************************************
+* @brief Atiende los comandos de funcion de un DS18B20 virtual
+*
+* Funcion interna. Convert T ( 0x44 ) mantiene el bus a 0 en los slots de lectura mientras dura la conversion,
+* Read Scratchpad ( 0xBE ) envia los 9 bytes del scratchpad con su CRC y Write Scratchpad ( 0x4E ) recibe TH,
+* TL y configuracion
+*/
+void _OneWireSim_FuncionDS18B20 (OneWireSim_Esclavo* pEsclavo, int8 cDato)
+{
+	OneWireSim_DS18B20* pSensor = (OneWireSim_DS18B20*) pEsclavo->pDatos;
+	int8 aScratchpad[9];
+	int8 nByte, nBit, nCRC;
+
+	if (pEsclavo->nOcupadoHasta != 0 && pEsclavo->nOcupadoHasta <= OneWireSim.nTiempo)
+	{
+		pSensor->nRegistro = pSensor->nTemperatura;						//La conversion anterior ya ha terminado
+		pEsclavo->nOcupadoHasta = 0;
+	}
+	if (pSensor->nEscritura != 0 && pSensor->nResets == OneWireSim.nResets)
+	{
+		pSensor->aConfig[3 - pSensor->nEscritura] = cDato;
+		if (--pSensor->nEscritura == 0)
+		{
+			pSensor->nEscrituras++;
+		}
+		return;
+	}
+	pSensor->nEscritura = 0;
+	switch (cDato)
+	{
+		case 0x44:
+			pEsclavo->nOcupadoHasta = OneWireSim.nTiempo + pSensor->nConversion;
+			pSensor->nConversiones++;
+			break;
+		case 0xBE:
+			aScratchpad[0] = make8 (pSensor->nRegistro, 0);
+			aScratchpad[1] = make8 (pSensor->nRegistro, 1);
+			aScratchpad[2] = pSensor->aConfig[0];
+			aScratchpad[3] = pSensor->aConfig[1];
+			aScratchpad[4] = pSensor->aConfig[2];
+			aScratchpad[5] = 0xFF;
+			aScratchpad[6] = 0x0C;
+			aScratchpad[7] = 0x10;
+			nCRC = 0;
+			for (nByte = 0; nByte < 8; nByte++)
+			{
+				nCRC ^= aScratchpad[nByte];
+				for (nBit = 0; nBit < 8; nBit++)
+				{
+					nCRC = (nCRC & 0x01) ? (nCRC >> 1) ^ 0x8C : nCRC >> 1;
+				}
+			}
+			aScratchpad[8] = nCRC;
+			OneWireSim_Envia (pEsclavo, aScratchpad, 9);
+			pSensor->nLecturas++;
+			break;
+		case 0x4E:
+			pSensor->nEscritura = 3;
+			pSensor->nResets = OneWireSim.nResets;
+			break;
+	}
+}
+/**
+******************************************************
+* @brief Conecta un DS18B20 virtual alimentado externamente
+*
+* Responde a Convert T, Read Scratchpad y Write Scratchpad. Hasta la primera conversion el scratchpad contiene
+* 85 grados, como el sensor real tras el encendido
+*
+* @param aRom Array con los 8 bytes del Id ( familia 0x28 )
+* @param nTemperatura Temperatura que mide en 1/16 de grado ( complemento a 2 )
+* @return Puntero al esclavo creado. Deja de ser valido si se anaden mas esclavos
+*
+* Ejemplo:
+*
+*	OneWireSim_RomConCRC (0x28, 0x123456, aRom);
+*	OneWireSim_AnadeDS18B20 (aRom, 25*16);
+*
+* Resultado:
+*
+*	Sensor que devuelve 25 grados despues de cada conversion
+*
+* @see OneWireSim_AnadeEsclavo()
+*/
+OneWireSim_Esclavo* OneWireSim_AnadeDS18B20 (int8* aRom, int16 nTemperatura)
+{
+	OneWireSim_Esclavo* pEsclavo;
+	OneWireSim_DS18B20* pSensor;
+
+	pSensor = calloc (1, sizeof (OneWireSim_DS18B20));
+	pSensor->nTemperatura = nTemperatura;
+	pSensor->nRegistro = 85*16;
+	pSensor->nConversion = ONEWIRE_SIM_CONVERSION;
+	pSensor->aConfig[0] = 0x4B;												//TH, TL y configuracion de fabrica ( 12 bits )
+	pSensor->aConfig[1] = 0x46;
+	pSensor->aConfig[2] = 0x7F;
+	pEsclavo = OneWireSim_AnadeEsclavo (aRom);
+	pEsclavo->pfFuncion = _OneWireSim_FuncionDS18B20;
+	pEsclavo->pDatos = pSensor;
+	return pEsclavo;
+}
+/**
+******************************************************
+* @brief CRC16 bit a bit para el modelo de DS2431
+*
+* Funcion interna. Independiente de las tablas de la libreria para poder comprobarlas
+*/
+int16 _OneWireSim_CRC16 (int16 nCRC, int8 cDato)
+{
+	int8 nBit;
+
+	nCRC ^= cDato;
+	for (nBit = 0; nBit < 8; nBit++)
+	{
+		nCRC = (nCRC & 0x0001) ? (nCRC >> 1) ^ 0xA001 : nCRC >> 1;
+	}
+	return nCRC;
+}
+/**
+******************************************************
+* @brief Atiende los comandos de funcion de un DS2431 virtual
+*
+* Funcion interna. Write Scratchpad ( 0x0F ), Read Scratchpad ( 0xAA ), Copy Scratchpad ( 0x55 ) y Read Memory
+* ( 0xF0 ). Las filas del scratchpad son de 8 bytes y al completarlas se envia el CRC16 invertido. Un byte
+* recibido mientras se programa la memoria cuenta como error, el maestro debe esperar sin usar el bus
+*/
+void _OneWireSim_FuncionDS2431 (OneWireSim_Esclavo* pEsclavo, int8 cDato)
+{
+	OneWireSim_DS2431* pMemoria = (OneWireSim_DS2431*) pEsclavo->pDatos;
+	int8 aRespuesta[16];
+	int8 nByte, nOffset, nFinal;
+	int16 nCRC, nDireccion;
+
+	if (pMemoria->nResets != OneWireSim.nResets)						//Primer byte tras un reset, es un comando
+	{
+		pMemoria->nResets = OneWireSim.nResets;
+		pMemoria->nFase = 0;
+	}
+	if (OneWireSim.nTiempo < pMemoria->nProgramaHasta)
+	{
+		pMemoria->nErroresCopia++;
+		return;
+	}
+	if (pMemoria->nFase == 0)
+	{
+		pMemoria->cComando = cDato;
+		pMemoria->nFase = 1;
+		if (cDato == 0xAA)													//Read Scratchpad no lleva direccion
+		{
+			nOffset = pMemoria->nTA & 0x07;
+			nFinal = pMemoria->cES & 0x07;
+			aRespuesta[0] = make8 (pMemoria->nTA, 0);
+			aRespuesta[1] = make8 (pMemoria->nTA, 1);
+			aRespuesta[2] = pMemoria->cES;
+			nByte = 3;
+			while (nOffset <= nFinal)
+			{
+				aRespuesta[nByte++] = pMemoria->aScratchpad[nOffset++];
+			}
+			nCRC = _OneWireSim_CRC16 (0, 0xAA);
+			for (nOffset = 0; nOffset < nByte; nOffset++)
+			{
+				nCRC = _OneWireSim_CRC16 (nCRC, aRespuesta[nOffset]);
+			}
+			aRespuesta[nByte++] = ~make8 (nCRC, 0);
+			aRespuesta[nByte++] = ~make8 (nCRC, 1);
+			OneWireSim_Envia (pEsclavo, aRespuesta, nByte);
+			pMemoria->nFase = 0xFF;											//El resto son slots de lectura
+		}
+		return;
+	}
+	if (pMemoria->nFase == 0xFF)
+	{
+		return;
+	}
+	if (pMemoria->nFase <= 3)
+	{
+		pMemoria->aRecibidos[pMemoria->nFase-1] = cDato;
+	}
+	switch (pMemoria->cComando)
+	{
+		case 0x0F:															//Write Scratchpad
+			if (pMemoria->nFase == 2)
+			{
+				pMemoria->nTA = make16 (pMemoria->aRecibidos[1], pMemoria->aRecibidos[0]);
+				pMemoria->cES = pMemoria->nTA & 0x07;
+			}else if (pMemoria->nFase > 2){
+				nOffset = (pMemoria->nTA & 0x07) + pMemoria->nFase - 3;
+				if (nOffset > 7)
+				{
+					pMemoria->nFase = 0xFF;
+					return;
+				}
+				pMemoria->aScratchpad[nOffset] = cDato;
+				pMemoria->cES = nOffset;
+				if (nOffset == 7)											//Fila completa, se envia el CRC16
+				{
+					nCRC = _OneWireSim_CRC16 (0, 0x0F);
+					nCRC = _OneWireSim_CRC16 (nCRC, pMemoria->aRecibidos[0]);
+					nCRC = _OneWireSim_CRC16 (nCRC, pMemoria->aRecibidos[1]);
+					for (nOffset = pMemoria->nTA & 0x07; nOffset < 8; nOffset++)
+					{
+						nCRC = _OneWireSim_CRC16 (nCRC, pMemoria->aScratchpad[nOffset]);
+					}
+					aRespuesta[0] = ~make8 (nCRC, 0);
+					aRespuesta[1] = ~make8 (nCRC, 1);
+					OneWireSim_Envia (pEsclavo, aRespuesta, 2);
+					pMemoria->nFase = 0xFF;
+					return;
+				}
+			}
+			break;
+		case 0x55:															//Copy Scratchpad
+			if (pMemoria->nFase == 3)
+			{
+				if (make16 (pMemoria->aRecibidos[1], pMemoria->aRecibidos[0]) == pMemoria->nTA && pMemoria->aRecibidos[2] == pMemoria->cES
+					&& pMemoria->nTA < ONEWIRE_SIM_DS2431_MEMORIA)
+				{
+					nDireccion = pMemoria->nTA & ~0x07;
+					memcpy (&pMemoria->aMemoria[nDireccion], pMemoria->aScratchpad, 8);
+					pMemoria->cES |= 0x80;									//AA, copia realizada
+					pMemoria->nCopias++;
+					pMemoria->nProgramaHasta = OneWireSim.nTiempo + ONEWIRE_SIM_DS2431_PROGRAMA;
+					memset (aRespuesta, 0xAA, 4);							//Unos y ceros alternados al terminar la programacion
+					OneWireSim_Envia (pEsclavo, aRespuesta, 4);
+					pEsclavo->nTxDesde = pMemoria->nProgramaHasta;
+				}else{
+					pMemoria->nErroresCopia++;
+				}
+				pMemoria->nFase = 0xFF;
+				return;
+			}
+			break;
+		case 0xF0:															//Read Memory
+			if (pMemoria->nFase == 2)
+			{
+				nDireccion = make16 (pMemoria->aRecibidos[1], pMemoria->aRecibidos[0]);
+				if (nDireccion < ONEWIRE_SIM_DS2431_MEMORIA)
+				{
+					OneWireSim_Envia (pEsclavo, &pMemoria->aMemoria[nDireccion], ONEWIRE_SIM_DS2431_MEMORIA - nDireccion);
+				}
+				pMemoria->nLecturasMemoria++;
+				pMemoria->nFase = 0xFF;
+				return;
+			}
+			break;
+		default:
+			pMemoria->nFase = 0xFF;
+			return;
+	}
+	pMemoria->nFase++;
+}
+/**
+******************************************************
+* @brief Conecta un DS2431 virtual ( EEPROM de 1 Kbit )
+*
+* La memoria empieza llena de 0xFF
+*
+* @param aRom Array con los 8 bytes del Id ( familia 0x2D )
+* @return Puntero al esclavo creado. Deja de ser valido si se anaden mas esclavos
+*
+* @see OneWireSim_AnadeEsclavo()
+*/
+OneWireSim_Esclavo* OneWireSim_AnadeDS2431 (int8* aRom)
+{
+	OneWireSim_Esclavo* pEsclavo;
+	OneWireSim_DS2431* pMemoria;
+
+	pMemoria = calloc (1, sizeof (OneWireSim_DS2431));
+	memset (pMemoria->aMemoria, 0xFF, sizeof (pMemoria->aMemoria));
+	pMemoria->nResets = -1;
+	pEsclavo = OneWireSim_AnadeEsclavo (aRom);
+	pEsclavo->pfFuncion = _OneWireSim_FuncionDS2431;
+	pEsclavo->pDatos = pMemoria;
+	return pEsclavo;
+}
+/**
+******************************************************
+* @brief Calcula el nivel del bus en un instante
+*
+* Funcion interna. El bus esta a 0 si el maestro o cualquier esclavo lo pone a 0 ( AND cableado ) y durante
+* nSubida us despues de que lo suelten
+*
+* @param nInstante Instante en us ( no anterior al ultimo cambio del maestro )
+* @return Nivel del bus
+*/
+int1 _OneWireSim_Nivel (int64 nInstante)
+{
+	int32 nEsclavo;
+
+	if (OneWireSim.lMaestroBajo || nInstante < OneWireSim.nMaestroLibreDesde + OneWireSim.nSubida)
+	{
+		return 0;
+	}
+	for (nEsclavo = 0; nEsclavo < OneWireSim.nEsclavos; nEsclavo++)
+	{
+		OneWireSim_Esclavo* pEsclavo = &OneWireSim.aEsclavos[nEsclavo];
+		if (pEsclavo->lConectado && pEsclavo->nBajoDesde <= nInstante && nInstante < pEsclavo->nBajoHasta + OneWireSim.nSubida
+			&& pEsclavo->nBajoDesde < pEsclavo->nBajoHasta)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+/**
+******************************************************
+* @brief Tiempos de un esclavo segun su velocidad
+*
+* Funcion interna.
+*/
+OneWireSim_Tiempos* _OneWireSim_T (OneWireSim_Esclavo* pEsclavo)
+{
+	return pEsclavo->lOverdrive ? &OneWireSim.stTiemposOD : &OneWireSim.stTiempos;
+}
+/**
+******************************************************
+* @brief Bit de la ROM de un esclavo
+*
+* Funcion interna. Los bits se numeran de 0 a 63 empezando por el de menor peso del byte 0
+*/
+int1 _OneWireSim_BitRom (OneWireSim_Esclavo* pEsclavo, int8 nPosBit)
+{
+	return bit_test (pEsclavo->aRom[nPosBit/8], nPosBit%8);
+}
+/**
+******************************************************
+* @brief Procesa un bit escrito por el maestro y recibido por el esclavo
+*
+* Funcion interna. Hace avanzar la maquina de estados del protocolo ROM del esclavo
+*/
+void _OneWireSim_Recibe (OneWireSim_Esclavo* pEsclavo, int1 lBit)
+{
+	switch (pEsclavo->nEstado)
+	{
+		case ONEWIRE_SIM_COMANDO_ROM:
+			pEsclavo->cDato = (pEsclavo->cDato >> 1) | (lBit ? 0x80 : 0);
+			if (++pEsclavo->nBit == 8)
+			{
+				pEsclavo->nBit = 0;
+				pEsclavo->nFase = 0;
+				if (pEsclavo->cDato != 0x55 && pEsclavo->cDato != 0x69 && pEsclavo->cDato != 0xA5)
+				{
+					pEsclavo->lRC = 0;										//Cualquier otro comando ROM borra la marca de Resume
+				}
+				switch (pEsclavo->cDato)
+				{
+					case 0x33:	pEsclavo->nEstado = ONEWIRE_SIM_READ_ROM;	break;
+					case 0x55:	pEsclavo->nEstado = ONEWIRE_SIM_MATCH_ROM;	break;
+					case 0xF0:	pEsclavo->nEstado = ONEWIRE_SIM_SEARCH_ROM;	break;
+					case 0xEC:	pEsclavo->nEstado = pEsclavo->lAlarma ? ONEWIRE_SIM_SEARCH_ROM : ONEWIRE_SIM_ESPERA_RESET;	break;
+					case 0xCC:	pEsclavo->nEstado = ONEWIRE_SIM_FUNCION;	break;
+					case 0x3C:												//Overdrive Skip ROM
+						pEsclavo->lPasaOverdrive = 1;
+						pEsclavo->nEstado = ONEWIRE_SIM_FUNCION;
+						break;
+					case 0x69:												//Overdrive Match ROM, el Id llega ya en overdrive
+						pEsclavo->lPasaOverdrive = 1;
+						pEsclavo->nEstado = ONEWIRE_SIM_MATCH_ROM;
+						break;
+					case 0xA5:	pEsclavo->nEstado = pEsclavo->lRC ? ONEWIRE_SIM_FUNCION : ONEWIRE_SIM_ESPERA_RESET;	break;
+					default:	pEsclavo->nEstado = ONEWIRE_SIM_ESPERA_RESET;
+				}
+			}
+			break;
+		case ONEWIRE_SIM_MATCH_ROM:
+			if (lBit != _OneWireSim_BitRom (pEsclavo, pEsclavo->nBit))
+			{
+				pEsclavo->nEstado = ONEWIRE_SIM_ESPERA_RESET;
+				pEsclavo->lOverdrive = 0;									//Si no era el direccionado con 0x69 vuelve a velocidad estandar
+				pEsclavo->lRC = 0;
+			}else if (++pEsclavo->nBit == 64){
+				pEsclavo->nEstado = ONEWIRE_SIM_FUNCION;
+				pEsclavo->nBit = 0;
+				pEsclavo->lRC = 1;
+			}
+			break;
+		case ONEWIRE_SIM_SEARCH_ROM:
+			pEsclavo->nFase = 0;
+			if (lBit != _OneWireSim_BitRom (pEsclavo, pEsclavo->nBit))		//Si el maestro elige la otra rama el esclavo abandona la busqueda
+			{
+				pEsclavo->nEstado = ONEWIRE_SIM_ESPERA_RESET;
+			}else if (++pEsclavo->nBit == 64){
+				pEsclavo->nEstado = ONEWIRE_SIM_FUNCION;
+				pEsclavo->nBit = 0;
+				pEsclavo->lRC = 1;
+			}
+			break;
+		case ONEWIRE_SIM_FUNCION:
+			pEsclavo->cDato = (pEsclavo->cDato >> 1) | (lBit ? 0x80 : 0);
+			if (++pEsclavo->nBit == 8)
+			{
+				pEsclavo->nBit = 0;
+				if (pEsclavo->pfFuncion)
+				{
+					pEsclavo->pfFuncion (pEsclavo, pEsclavo->cDato);
+				}
+			}
+			break;
+	}
+}
+/**
+******************************************************
+* @brief Procesa los instantes de muestreo de los esclavos hasta nInstante
+*
+* Funcion interna. Se llama antes de cualquier cambio del maestro, ya que el nivel del bus
+* en los instantes de muestreo depende del estado del maestro en ese momento
+*/
+void _OneWireSim_Procesa (int64 nInstante)
+{
+	int32 nEsclavo;
+
+	for (nEsclavo = 0; nEsclavo < OneWireSim.nEsclavos; nEsclavo++)
+	{
+		OneWireSim_Esclavo* pEsclavo = &OneWireSim.aEsclavos[nEsclavo];
+		if (pEsclavo->nMuestreo != 0 && pEsclavo->nMuestreo <= nInstante)
+		{
+			int1 lBit = _OneWireSim_Nivel (pEsclavo->nMuestreo);
+			pEsclavo->nMuestreo = 0;
+			_OneWireSim_Recibe (pEsclavo, lBit);
+		}
+	}
+}
+/**
+******************************************************
+* @brief Inicio de un slot visto por un esclavo
+*
+* Funcion interna. Si el esclavo tiene un bit que enviar y es 0 mantiene el bus a 0, si espera
+* un bit del maestro programa el instante de muestreo
+*/
+void _OneWireSim_Slot (OneWireSim_Esclavo* pEsclavo)
+{
+	int1 lEnvia = 0, lBit = 1;
+
+	if (pEsclavo->lPasaOverdrive)										//El cambio a overdrive se hace al terminar el slot del comando
+	{
+		pEsclavo->lOverdrive = 1;
+		pEsclavo->lPasaOverdrive = 0;
+	}
+	switch (pEsclavo->nEstado)
+	{
+		case ONEWIRE_SIM_ESPERA_RESET:
+			return;
+		case ONEWIRE_SIM_READ_ROM:
+			lEnvia = 1;
+			lBit = _OneWireSim_BitRom (pEsclavo, pEsclavo->nBit);
+			if (++pEsclavo->nBit == 64)
+			{
+				pEsclavo->nEstado = ONEWIRE_SIM_FUNCION;
+				pEsclavo->nBit = 0;
+			}
+			break;
+		case ONEWIRE_SIM_SEARCH_ROM:
+			if (pEsclavo->nFase < 2)
+			{
+				lEnvia = 1;
+				lBit = _OneWireSim_BitRom (pEsclavo, pEsclavo->nBit) ^ pEsclavo->nFase;
+				pEsclavo->nFase++;
+			}
+			break;
+		case ONEWIRE_SIM_FUNCION:
+			if (pEsclavo->nTxPos < pEsclavo->nTxBits && OneWireSim.nTiempo >= pEsclavo->nTxDesde)
+			{
+				lEnvia = 1;
+				lBit = bit_test (pEsclavo->aTx[pEsclavo->nTxPos/8], pEsclavo->nTxPos%8);
+				pEsclavo->nTxPos++;
+			}else if (OneWireSim.nTiempo < pEsclavo->nOcupadoHasta){	//Operacion en curso, responde 0 a las lecturas
+				lEnvia = 1;
+				lBit = 0;
+			}
+			break;
+	}
+	if (lEnvia)
+	{
+		if (!lBit)
+		{
+			pEsclavo->nBajoDesde = OneWireSim.nTiempo;
+			pEsclavo->nBajoHasta = OneWireSim.nTiempo + _OneWireSim_T (pEsclavo)->nMantenimiento;
+		}
+	}else{
+		pEsclavo->nMuestreo = OneWireSim.nTiempo + _OneWireSim_T (pEsclavo)->nMuestreo;
+	}
+}
+/**
+******************************************************
+* @brief Reset visto por un esclavo
+*
+* Funcion interna. El esclavo vuelve a esperar un comando ROM y programa su pulso de presencia
+*/
+void _OneWireSim_Reset (OneWireSim_Esclavo* pEsclavo)
+{
+	pEsclavo->nEstado = ONEWIRE_SIM_COMANDO_ROM;
+	pEsclavo->lPasaOverdrive = 0;
+	pEsclavo->nBit = 0;
+	pEsclavo->nFase = 0;
+	pEsclavo->cDato = 0;
+	pEsclavo->nTxBits = 0;
+	pEsclavo->nTxPos = 0;
+	pEsclavo->nMuestreo = 0;
+	pEsclavo->nBajoDesde = OneWireSim.nTiempo + _OneWireSim_T (pEsclavo)->nPresenciaEspera;
+	pEsclavo->nBajoHasta = pEsclavo->nBajoDesde + _OneWireSim_T (pEsclavo)->nPresenciaAncho;
+}
+/**
+******************************************************
+* @brief El maestro pone el bus a 0
+*
+* Equivale a output_low (Pin1W). Si el bus estaba a 1 es el flanco de inicio de un slot
+*
+* @see OneWireSim_PinFloat(), OneWireSim_PinHigh(), OneWireSim_PinRead()
+*/
+void OneWireSim_PinLow (void)
+{
+	int32 nEsclavo;
+
+	_OneWireSim_Procesa (OneWireSim.nTiempo);
+	if (OneWireSim.lMaestroBajo)
+	{
+		return;
+	}
+	if (!_OneWireSim_Nivel (OneWireSim.nTiempo))						//Un esclavo todavia mantiene el bus a 0, el slot anterior ha sido demasiado corto
+	{
+		OneWireSim.nViolaciones++;
+	}
+	OneWireSim.lMaestroBajo = 1;
+	OneWireSim.nMaestroBajoDesde = OneWireSim.nTiempo;
+	OneWireSim.nSlots++;
+	for (nEsclavo = 0; nEsclavo < OneWireSim.nEsclavos; nEsclavo++)
+	{
+		if (OneWireSim.aEsclavos[nEsclavo].lConectado)
+		{
+			_OneWireSim_Slot (&OneWireSim.aEsclavos[nEsclavo]);
+		}
+	}
+}
+/**
+******************************************************
+* @brief El maestro deja el bus en alta impedancia
+*
+* Equivale a output_float (Pin1W). Si el pulso bajo ha durado al menos nResetMin los esclavos lo toman como reset.
+* Un reset de duracion estandar devuelve a velocidad estandar a los esclavos en overdrive
+*
+* @see OneWireSim_PinLow(), OneWireSim_PinHigh(), OneWireSim_PinRead()
+*/
+void OneWireSim_PinFloat (void)
+{
+	int32 nEsclavo;
+	int64 nDuracion;
+	int1 lReset = 0;
+
+	_OneWireSim_Procesa (OneWireSim.nTiempo);
+	if (!OneWireSim.lMaestroBajo)
+	{
+		return;
+	}
+	OneWireSim.lMaestroBajo = 0;
+	OneWireSim.nMaestroLibreDesde = OneWireSim.nTiempo;
+	nDuracion = OneWireSim.nTiempo - OneWireSim.nMaestroBajoDesde;
+	for (nEsclavo = 0; nEsclavo < OneWireSim.nEsclavos; nEsclavo++)
+	{
+		OneWireSim_Esclavo* pEsclavo = &OneWireSim.aEsclavos[nEsclavo];
+		if (!pEsclavo->lConectado)
+		{
+			continue;
+		}
+		if (nDuracion >= OneWireSim.stTiempos.nResetMin)
+		{
+			pEsclavo->lOverdrive = 0;
+		}
+		if (nDuracion >= _OneWireSim_T (pEsclavo)->nResetMin)
+		{
+			_OneWireSim_Reset (pEsclavo);
+			lReset = 1;
+		}
+	}
+	if (lReset || nDuracion >= OneWireSim.stTiempos.nResetMin)
+	{
+		OneWireSim.nResets++;
+		OneWireSim.nSlots--;												//El flanco de bajada no era un slot
+	}
+}
+/**
+******************************************************
+* @brief El maestro pone el bus a 1
+*
+* Equivale a output_high (Pin1W). En el bus virtual un 0 de un esclavo prevalece sobre el 1 del maestro
+*
+* @see OneWireSim_PinLow(), OneWireSim_PinFloat(), OneWireSim_PinRead()
+*/
+void OneWireSim_PinHigh (void)
+{
+	OneWireSim_PinFloat ();
+}
+/**
+******************************************************
+* @brief El maestro lee el bus
+*
+* Equivale a input (Pin1W)
+*
+* @return Nivel del bus en el instante actual
+*/
+int1 OneWireSim_PinRead (void)
+{
+	_OneWireSim_Procesa (OneWireSim.nTiempo);
+	if (OneWireSim.nLecturaFallida != 0 && --OneWireSim.nLecturaFallida == 0)
+	{
+		return 1;															//Pico de ruido en el instante de muestreo
+	}
+	return _OneWireSim_Nivel (OneWireSim.nTiempo);
+}
+/**
+******************************************************
+* @brief Avanza el reloj virtual
+*
+* Equivale a delay_us (nUs). Los esclavos leen el bus en los instantes de muestreo que caen dentro del intervalo
+*
+* @param nUs Microsegundos a esperar
+*/
+void OneWireSim_DelayUs (int32 nUs)
+{
+	if (!OneWireSimInt.lBloqueadas)
+	{
+		nUs += OneWireSimInt.nRutina;										//La rutina de interrupcion retrasa el final de la espera
+	}
+	OneWireSim.nTiempo += nUs;
+	_OneWireSim_Procesa (OneWireSim.nTiempo);
+}
+/**
+******************************************************
+* @brief Enmascara las interrupciones
+*
+* Equivale a borrar GIE. Si ya estaban enmascaradas no cambia el inicio del bloqueo
+*
+* @see OneWireSim_Desbloquea()
+*/
+void OneWireSim_Bloquea (void)
+{
+	if (!OneWireSimInt.lBloqueadas)
+	{
+		OneWireSimInt.lBloqueadas = 1;
+		OneWireSimInt.nDesde = OneWireSim.nTiempo;
+		OneWireSimInt.nBloqueos++;
+	}
+}
+/**
+******************************************************
+* @brief Habilita las interrupciones y anota la duracion del bloqueo
+*
+* @see OneWireSim_Bloquea()
+*/
+void OneWireSim_Desbloquea (void)
+{
+	if (OneWireSimInt.lBloqueadas)
+	{
+		OneWireSimInt.lBloqueadas = 0;
+		if (OneWireSim.nTiempo - OneWireSimInt.nDesde > OneWireSimInt.nBloqueoMax)
+		{
+			OneWireSimInt.nBloqueoMax = OneWireSim.nTiempo - OneWireSimInt.nDesde;
+		}
+	}
+}
+/**
+******************************************************
+* @brief Arma el temporizador virtual
+*
+* Equivale a programar el comparador de un timer del PIC. Cuando el reloj virtual alcanza el vencimiento
+* en OneWireSim_Espera() se ejecuta pfTimer como si fuera la rutina de interrupcion
+*
+* @param nUs Microsegundos hasta el vencimiento
+* @param pfTimer Rutina de interrupcion
+*
+* @see OneWireSim_TimerPara(), OneWireSim_Espera()
+*/
+void OneWireSim_TimerArma (int32 nUs, void (*pfTimer)(void))
+{
+	OneWireSim.nTimer = OneWireSim.nTiempo + nUs;
+	OneWireSim.pfTimer = pfTimer;
+}
+/**
+******************************************************
+* @brief Para el temporizador virtual
+*
+* @see OneWireSim_TimerArma()
+*/
+void OneWireSim_TimerPara (void)
+{
+	OneWireSim.nTimer = 0;
+}
+/**
+******************************************************
+* @brief Avanza el reloj virtual hasta el vencimiento del temporizador y ejecuta su rutina
+*
+* Representa el tiempo que el programa principal dedica a otras tareas mientras espera la interrupcion
+*
+* @return 1 si se ha ejecutado la rutina de interrupcion, 0 si el temporizador estaba parado
+*/
+int1 OneWireSim_Espera (void)
+{
+	if (OneWireSim.nTimer == 0)
+	{
+		return 0;
+	}
+	if (OneWireSim.nTimer > OneWireSim.nTiempo)
+	{
+		OneWireSim_DelayUs ((int32) (OneWireSim.nTimer - OneWireSim.nTiempo));
+	}
+	OneWireSim.nTimer = 0;
+	OneWireSim.pfTimer ();
+	return 1;
+}
+/**
+******************************************************
+* @brief Inicializa un puerto virtual con nBuses buses vacios
+*
+* Cada bus es un bus virtual completo. Para anadirle esclavos se selecciona con OneWireSim_PuertoSelecciona()
+* y se usan las funciones de siempre
+*
+* Ejemplo:
+*
+*	OneWireSim_PuertoInicia (8);
+*	OneWireSim_PuertoSelecciona (3);
+*	OneWireSim_AnadeEsclavo (aRom);
+*
+* Resultado:
+*
+*	Puerto de 8 buses con un esclavo en el bus del bit 3
+*
+* @see OneWireSim_PuertoSelecciona()
+*/
+void OneWireSim_PuertoInicia (int8 nBuses)
+{
+	int8 nBus;
+
+	OneWireSim_Inicia ();
+	for (nBus = 0; nBus < ONEWIRE_SIM_MAX_BUSES; nBus++)
+	{
+		OneWireSimPuerto.aBuses[nBus] = OneWireSim;
+	}
+	OneWireSimPuerto.nBuses = nBuses;
+	OneWireSimPuerto.nActivo = 0;
+}
+/**
+******************************************************
+* @brief Carga uno de los buses del puerto en OneWireSim
+*
+* @param nBus Bit del puerto
+*/
+void OneWireSim_PuertoSelecciona (int8 nBus)
+{
+	if (nBus != OneWireSimPuerto.nActivo)
+	{
+		OneWireSimPuerto.aBuses[OneWireSimPuerto.nActivo] = OneWireSim;
+		OneWireSim = OneWireSimPuerto.aBuses[nBus];
+		OneWireSimPuerto.nActivo = nBus;
+	}
+}
+/**
+******************************************************
+* @brief El maestro pone a 0 los buses de cMascara
+*
+* Equivale a poner como salida ( con el latch a 0 ) los bits del puerto
+*/
+void OneWireSim_PuertoBajo (int8 cMascara)
+{
+	int8 nBus;
+
+	for (nBus = 0; nBus < OneWireSimPuerto.nBuses; nBus++)
+	{
+		if (bit_test (cMascara, nBus))
+		{
+			OneWireSim_PuertoSelecciona (nBus);
+			OneWireSim_PinLow ();
+		}
+	}
+}
+/**
+******************************************************
+* @brief El maestro deja en alta impedancia los buses de cMascara
+*/
+void OneWireSim_PuertoLibera (int8 cMascara)
+{
+	int8 nBus;
+
+	for (nBus = 0; nBus < OneWireSimPuerto.nBuses; nBus++)
+	{
+		if (bit_test (cMascara, nBus))
+		{
+			OneWireSim_PuertoSelecciona (nBus);
+			OneWireSim_PinFloat ();
+		}
+	}
+}
+/**
+******************************************************
+* @brief Lee el puerto completo
+*
+* @return Nivel de cada bus en su bit, los bits sin bus se leen a 1
+*/
+int8 OneWireSim_PuertoLee (void)
+{
+	int8 nBus, cPuerto;
+
+	cPuerto = 0xFF;
+	for (nBus = 0; nBus < OneWireSimPuerto.nBuses; nBus++)
+	{
+		OneWireSim_PuertoSelecciona (nBus);
+		if (!OneWireSim_PinRead ())
+		{
+			bit_clear (cPuerto, nBus);
+		}
+	}
+	return cPuerto;
+}
+/**
+******************************************************
+* @brief Avanza el reloj virtual de todos los buses del puerto
+*/
+void OneWireSim_PuertoDelayUs (int32 nUs)
+{
+	int8 nBus;
+
+	for (nBus = 0; nBus < OneWireSimPuerto.nBuses; nBus++)
+	{
+		OneWireSim_PuertoSelecciona (nBus);
+		OneWireSim_DelayUs (nUs);
+	}
+}
+#ifdef ONEWIRE_UART
+/**
+******************************************************
+* @brief Crea el pseudo-terminal que hace de UART conectada al bus virtual
+*
+* El lado de la libreria queda en modo raw, sin eco ni conversion de caracteres, como una UART.
+* Lo llama OneWire_UartInicia(). Si no se puede crear el pseudo-terminal el programa termina
+*
+* @see OneWireSim_UartCierra()
+*/
+void OneWireSim_UartAbre (void)
+{
+	struct termios stTermios;
+
+	OneWireSimSerie.nMaestro = posix_openpt (O_RDWR | O_NOCTTY);
+	if (OneWireSimSerie.nMaestro < 0 || grantpt (OneWireSimSerie.nMaestro) != 0 || unlockpt (OneWireSimSerie.nMaestro) != 0)
+	{
+		perror ("OneWireSim_UartAbre");
+		exit (1);
+	}
+	fcntl (OneWireSimSerie.nMaestro, F_SETFL, O_NONBLOCK);
+	OneWireSimSerie.nUart = open (ptsname (OneWireSimSerie.nMaestro), O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (OneWireSimSerie.nUart < 0)
+	{
+		perror ("OneWireSim_UartAbre");
+		exit (1);
+	}
+	tcgetattr (OneWireSimSerie.nUart, &stTermios);
+	cfmakeraw (&stTermios);
+	tcsetattr (OneWireSimSerie.nUart, TCSANOW, &stTermios);
+	OneWireSimSerie.nTramas = 0;
+	OneWireSimSerie.lAbierta = 1;
+}
+/**
+******************************************************
+* @brief Cierra el pseudo-terminal
+*/
+void OneWireSim_UartCierra (void)
+{
+	close (OneWireSimSerie.nUart);
+	close (OneWireSimSerie.nMaestro);
+	OneWireSimSerie.lAbierta = 0;
+}
+/**
+******************************************************
+* @brief Termina el programa si se usa la UART virtual sin haberla abierto
+*
+* Funcion interna. Sin OneWire_UartInicia() nUart vale 0 y la libreria leeria la entrada estandar esperando un eco
+* que nunca llega
+*/
+void _OneWireSim_UartComprueba (void)
+{
+	if (!OneWireSimSerie.lAbierta)
+	{
+		fprintf (stderr, "ERROR: UART virtual sin abrir, falta llamar a OneWire_UartInicia()\n");
+		exit (1);
+	}
+}
+/**
+******************************************************
+* @brief Cambia la velocidad de la UART virtual
+*
+* Se guarda en la configuracion del pseudo-terminal, de donde la toma el lado del bus
+*/
+void OneWireSim_UartBaudios (int32 nBaudios)
+{
+	struct termios stTermios;
+
+	_OneWireSim_UartComprueba ();
+	tcgetattr (OneWireSimSerie.nUart, &stTermios);
+	cfsetspeed (&stTermios, nBaudios == 9600 ? B9600 : B115200);
+	tcsetattr (OneWireSimSerie.nUart, TCSANOW, &stTermios);
+}
+/**
+******************************************************
+* @brief Convierte un byte de la UART en niveles del bus virtual
+*
+* Funcion interna. El bit de start y los bits a 0 ponen el bus a 0, los bits a 1 lo dejan libre. Cada bit se lee
+* en su punto medio, asi que el eco tiene a 0 los bits en los que un esclavo mantiene el bus a 0
+*
+* @return Byte de eco
+*/
+int8 _OneWireSim_UartTrama (int8 cDato, int32 nBaudios)
+{
+	int8 nBit, cEco;
+	int32 nAnterior, nMitad, nFin;
+	int1 lNivel;
+
+	cEco = 0;
+	nAnterior = 0;
+	for (nBit = 0; nBit < 10; nBit++)										//Start, 8 bits de datos y stop
+	{
+		if (nBit == 0)
+		{
+			lNivel = 0;
+		}else if (nBit == 9){
+			lNivel = 1;
+		}else{
+			lNivel = bit_test (cDato, nBit-1);
+		}
+		if (lNivel)
+		{
+			OneWireSim_PinFloat ();
+		}else{
+			OneWireSim_PinLow ();
+		}
+		nMitad = (int32) ((nBit*2+1) * 500000LL / nBaudios);
+		nFin = (int32) ((nBit+1) * 1000000LL / nBaudios);
+		OneWireSim_DelayUs (nMitad - nAnterior);
+		if (nBit >= 1 && nBit <= 8 && OneWireSim_PinRead ())
+		{
+			bit_set (cEco, nBit-1);
+		}
+		OneWireSim_DelayUs (nFin - nMitad);
+		nAnterior = nFin;
+	}
+	OneWireSimSerie.nTramas++;
+	return cEco;
+}
+/**
+******************************************************
+* @brief Atiende los bytes pendientes en el lado del bus del pseudo-terminal
+*
+* Funcion interna. Hace de transceptor 1 Wire: convierte cada byte en el bus virtual y devuelve el eco
+*/
+void _OneWireSim_UartAtiende (void)
+{
+	struct termios stTermios;
+	int8 cDato;
+	int32 nBaudios;
+
+	tcgetattr (OneWireSimSerie.nMaestro, &stTermios);
+	nBaudios = cfgetospeed (&stTermios) == B9600 ? 9600 : 115200;
+	while (read (OneWireSimSerie.nMaestro, &cDato, 1) == 1)
+	{
+		cDato = _OneWireSim_UartTrama (cDato, nBaudios);
+		write (OneWireSimSerie.nMaestro, &cDato, 1);
+	}
+}
+/**
+******************************************************
+* @brief Envia un byte por la UART virtual
+*
+* Equivale a putc()
+*/
+void OneWireSim_UartEnvia (int8 cDato)
+{
+	_OneWireSim_UartComprueba ();
+	write (OneWireSimSerie.nUart, &cDato, 1);
+}
+/**
+******************************************************
+* @brief Recibe un byte de la UART virtual
+*
+* Equivale a getc(). Mientras no hay eco se atiende el lado del bus
+*/
+int8 OneWireSim_UartRecibe (void)
+{
+	int8 cDato;
+
+	_OneWireSim_UartComprueba ();
+	while (read (OneWireSimSerie.nUart, &cDato, 1) != 1)
+	{
+		_OneWireSim_UartAtiende ();
+	}
+	return cDato;
+}
+#endif
+#ifdef ONEWIRE_DS2482
+/**
+******************************************************
+* @brief Slot de bit generado por el DS2482 virtual
+*
+* Funcion interna. Tiempos del DS2482-100: en estandar 8 us a 0 ( 64 us para escribir un 0 ), muestreo a los
+* 15 us y slot de 70 us mas 5 de recuperacion; en overdrive 1, 8, 2, 10 y 2 us
+*
+* @return Nivel del bus en el muestreo
+*/
+int1 _OneWireSim_PuenteSlot (int1 lBit)
+{
+	int1 lOD, lLeido;
+	int32 nBajo, nMuestreo, nSlot;
+
+	lOD = (OneWireSimPuente.cConfig & ONEWIRE_DS2482_1WS) != 0;
+	nBajo = lBit ? (lOD ? 1 : 8) : (lOD ? 8 : 64);
+	nMuestreo = lOD ? 2 : 15;
+	nSlot = lOD ? 10 : 70;
+	OneWireSim_PinLow ();
+	if (nBajo < nMuestreo)
+	{
+		OneWireSim_DelayUs (nBajo);
+		OneWireSim_PinFloat ();
+		OneWireSim_DelayUs (nMuestreo - nBajo);
+		lLeido = OneWireSim_PinRead ();
+		OneWireSim_DelayUs (nSlot - nMuestreo);
+	}else{
+		OneWireSim_DelayUs (nMuestreo);
+		lLeido = OneWireSim_PinRead ();
+		OneWireSim_DelayUs (nBajo - nMuestreo);
+		OneWireSim_PinFloat ();
+		OneWireSim_DelayUs (nSlot - nBajo);
+	}
+	OneWireSim_DelayUs (lOD ? 2 : 5);
+	return lLeido;
+}
+/**
+******************************************************
+* @brief Ejecuta un comando del DS2482 virtual
+*
+* Funcion interna. Los comandos 1 Wire se ejecutan completos sobre el bus virtual y dejan el puntero en el
+* registro de estado
+*/
+void _OneWireSim_PuenteEjecuta (int8 cComando, int8 cParametro)
+{
+	int8 nBit, cLeido;
+	int1 lBit, lComplemento, lDireccion, lOD;
+
+	OneWireSimPuente.nComandos++;
+	lOD = (OneWireSimPuente.cConfig & ONEWIRE_DS2482_1WS) != 0;
+	switch (cComando)
+	{
+		case ONEWIRE_DS2482_RESET_PUENTE:
+			OneWireSimPuente.cEstado = ONEWIRE_DS2482_RST;
+			OneWireSimPuente.cConfig = 0;
+			OneWireSimPuente.cPuntero = ONEWIRE_DS2482_REG_ESTADO;
+			return;
+		case ONEWIRE_DS2482_PUNTERO:
+			OneWireSimPuente.cPuntero = cParametro;
+			return;
+		case ONEWIRE_DS2482_CONFIGURACION:
+			if (((~cParametro >> 4) & 0x0F) == (cParametro & 0x0F))				//Nibble alto complementado
+			{
+				OneWireSimPuente.cConfig = cParametro & 0x0F;
+				OneWireSimPuente.cEstado &= ~ONEWIRE_DS2482_RST;
+			}
+			OneWireSimPuente.cPuntero = ONEWIRE_DS2482_REG_CONFIG;
+			return;
+	}
+	OneWireSimPuente.cPuntero = ONEWIRE_DS2482_REG_ESTADO;
+	OneWireSimPuente.cEstado &= ~(ONEWIRE_DS2482_SBR | ONEWIRE_DS2482_TSB | ONEWIRE_DS2482_DIR);
+	switch (cComando)
+	{
+		case ONEWIRE_DS2482_RESET:
+			OneWireSim_PinLow ();
+			OneWireSim_DelayUs (lOD ? 70 : 560);
+			OneWireSim_PinFloat ();
+			OneWireSim_DelayUs (lOD ? 9 : 70);
+			OneWireSimPuente.cEstado &= ~ONEWIRE_DS2482_PPD;
+			if (!OneWireSim_PinRead ())
+			{
+				OneWireSimPuente.cEstado |= ONEWIRE_DS2482_PPD;
+			}
+			OneWireSim_DelayUs (lOD ? 61 : 490);
+			break;
+		case ONEWIRE_DS2482_BIT:
+			if (_OneWireSim_PuenteSlot (bit_test (cParametro, 7)))
+			{
+				OneWireSimPuente.cEstado |= ONEWIRE_DS2482_SBR;
+			}
+			break;
+		case ONEWIRE_DS2482_ESCRIBE_BYTE:
+			for (nBit = 0; nBit < 8; nBit++)
+			{
+				_OneWireSim_PuenteSlot (bit_test (cParametro, nBit));
+			}
+			break;
+		case ONEWIRE_DS2482_LEE_BYTE:
+			cLeido = 0;
+			for (nBit = 0; nBit < 8; nBit++)
+			{
+				if (_OneWireSim_PuenteSlot (1))
+				{
+					bit_set (cLeido, nBit);
+				}
+			}
+			OneWireSimPuente.cDato = cLeido;
+			break;
+		case ONEWIRE_DS2482_TRIPLET:
+			lBit = _OneWireSim_PuenteSlot (1);
+			lComplemento = _OneWireSim_PuenteSlot (1);
+			if (lBit != lComplemento)
+			{
+				lDireccion = lBit;
+			}else{
+				lDireccion = bit_test (cParametro, 7);
+			}
+			_OneWireSim_PuenteSlot (lDireccion);								//El DS2482 escribe la direccion tambien con 1/1
+			OneWireSimPuente.cEstado |= (lBit ? ONEWIRE_DS2482_SBR : 0) | (lComplemento ? ONEWIRE_DS2482_TSB : 0) | (lDireccion ? ONEWIRE_DS2482_DIR : 0);
+			break;
+	}
+}
+/**
+******************************************************
+* @brief Condicion de start ( o start repetido ) en el bus I2C virtual
+*
+* Equivale a i2c_start()
+*/
+void OneWireSim_I2CInicio (void)
+{
+	OneWireSim_DelayUs (ONEWIRE_SIM_I2C_CONDICION);
+	OneWireSimPuente.nBytes = 0;
+	OneWireSimPuente.lDireccionado = 0;
+}
+/**
+******************************************************
+* @brief Escribe un byte en el bus I2C virtual
+*
+* Equivale a i2c_write(). El primer byte tras el start es la direccion, el siguiente el comando y, si lo lleva,
+* el tercero su parametro
+*
+* @return 0 si el puente ha respondido con ACK ( igual que i2c_write() )
+*/
+int1 OneWireSim_I2CEscribe (int8 cDato)
+{
+	OneWireSim_DelayUs (ONEWIRE_SIM_I2C_BYTE);
+	OneWireSimPuente.nBytesI2C++;
+	if (OneWireSimPuente.nBytes == 0)
+	{
+		OneWireSimPuente.nBytes = 1;
+		OneWireSimPuente.lDireccionado = (cDato & 0xFE) == ONEWIRE_DS2482_DIRECCION;
+		OneWireSimPuente.lLectura = cDato & 0x01;
+		return !OneWireSimPuente.lDireccionado;
+	}
+	if (!OneWireSimPuente.lDireccionado || OneWireSimPuente.lLectura)
+	{
+		return 1;
+	}
+	if (OneWireSimPuente.nBytes == 1)
+	{
+		OneWireSimPuente.cComando = cDato;
+		OneWireSimPuente.nBytes = 2;
+		switch (cDato)
+		{
+			case ONEWIRE_DS2482_RESET_PUENTE:
+			case ONEWIRE_DS2482_RESET:
+			case ONEWIRE_DS2482_LEE_BYTE:
+				_OneWireSim_PuenteEjecuta (cDato, 0);							//Comandos sin parametro
+				break;
+		}
+		return 0;
+	}
+	if (OneWireSimPuente.nBytes == 2)
+	{
+		OneWireSimPuente.nBytes = 3;
+		_OneWireSim_PuenteEjecuta (OneWireSimPuente.cComando, cDato);
+		return 0;
+	}
+	return 1;
+}
+/**
+******************************************************
+* @brief Lee un byte del bus I2C virtual
+*
+* Equivale a i2c_read(). Devuelve el registro apuntado, el puntero no avanza. Tras un NACK ( lAck a 0 ) el DS2482
+* libera el bus y las lecturas devuelven 0xFF hasta el siguiente start
+*/
+int8 OneWireSim_I2CLee (int1 lAck)
+{
+	int8 cLeido;
+
+	OneWireSim_DelayUs (ONEWIRE_SIM_I2C_BYTE);
+	OneWireSimPuente.nBytesI2C++;
+	if (!OneWireSimPuente.lDireccionado || !OneWireSimPuente.lLectura)
+	{
+		return 0xFF;
+	}
+	switch (OneWireSimPuente.cPuntero)
+	{
+		case ONEWIRE_DS2482_REG_DATO:
+			cLeido = OneWireSimPuente.cDato;
+			break;
+		case ONEWIRE_DS2482_REG_CONFIG:
+			cLeido = OneWireSimPuente.cConfig;
+			break;
+		default:
+			cLeido = OneWireSimPuente.cEstado;
+			break;
+	}
+	if (!lAck)
+	{
+		OneWireSimPuente.lDireccionado = 0;
+	}
+	return cLeido;
+}
+/**
+******************************************************
+* @brief Condicion de stop en el bus I2C virtual
+*
+* Equivale a i2c_stop()
+*/
+void OneWireSim_I2CParada (void)
+{
+	OneWireSim_DelayUs (ONEWIRE_SIM_I2C_CONDICION);
+	OneWireSimPuente.lDireccionado = 0;
+}
+#endif
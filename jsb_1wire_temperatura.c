@@ -0,0 +1,175 @@
+/**
+******************************************************
+* @file jsb_1wire_temperatura.c
+* @brief Lectura de todos los sensores de temperatura del bus 1Wire con una sola conversion
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+/**
+******************************************************
+* @brief Inicia la conversion en todos los sensores del bus
+*
+* Envia Skip ROM y Convert T. La conversion dura hasta 750 ms a 12 bits
+*
+* @return 1 si hay dispositivos en el bus, 0 en caso contrario
+*
+* @see OneWire_TempEsperaFin(), OneWire_TempMuestrea()
+*/
+int1 OneWire_TempConvierte (void)
+{
+	if (OneWire_Reset ())
+	{
+		return 0;
+	}
+	OneWire_SendByte (0xCC);
+	OneWire_SendByte (ONEWIRE_TEMP_CONVERT);
+	return 1;
+}
+/**
+******************************************************
+* @brief Espera a que todos los sensores terminen la conversion
+*
+* Debe llamarse justo despues de OneWire_TempConvierte(), sin otro reset entre medias. Cada milisegundo se
+* hace un slot de lectura; mientras algun sensor esta convirtiendo mantiene el bus a 0, asi que el primer
+* 1 indica que han terminado todos
+*
+* @return 1 si la conversion ha terminado, 0 si se ha superado ONEWIRE_TEMP_ESPERA_MAX
+*
+* @see OneWire_TempConvierte()
+*/
+int1 OneWire_TempEsperaFin (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int16 nEspera;
+	//-------------------------------------------------------------
+
+	for (nEspera = 0; nEspera < ONEWIRE_TEMP_ESPERA_MAX; nEspera++)
+	{
+		if (OneWire_LeeBit ())
+		{
+			return 1;
+		}
+		_OneWire_DelayMs (1);
+	}
+	return 0;
+}
+/**
+******************************************************
+* @brief Lee la temperatura de un sensor
+*
+* Direcciona el sensor con OneWire_MatchROM(), lee los 9 bytes del scratchpad y comprueba el CRC y los bytes
+* reservados ( byte 5 a 0xFF y byte 7 a 0x10 en todos los sensores ). El CRC de 9 bytes a 0 tambien es correcto,
+* asi que sin los bytes reservados un bus en cortocircuito daria 0 grados
+*
+* @param aRom Id del sensor
+* @param pTemperatura Temperatura leida en 1/16 de grado ( complemento a 2 ), ONEWIRE_TEMP_ERROR si falla
+* @return 1 si la lectura es correcta, 0 si no responde, el CRC no coincide o los bytes reservados no son los esperados
+*
+* Ejemplo:
+*
+*	int16 nTemperatura;
+*
+*	if (OneWire_TempLee (aRom, &nTemperatura))
+*	{
+*		printf ("%ld\r\n", (signed int16)nTemperatura / 16);
+*	}
+*
+* Resultado:
+*
+*	Grados del sensor aRom segun la ultima conversion
+*
+* @see OneWire_TempMuestrea()
+*/
+int1 OneWire_TempLee (int8* aRom, int16* pTemperatura)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 aScratchpad[9];
+	int16 nCRC;
+	//-------------------------------------------------------------
+
+	*pTemperatura = ONEWIRE_TEMP_ERROR;
+	OneWire_MatchROM (aRom);
+	OneWire_SendByte (ONEWIRE_TEMP_READ_SCRATCHPAD);
+	nCRC = 0;
+	if (!OneWire_ReadBlock (aScratchpad, 9, ONEWIRE_CRC_8, &nCRC))
+	{
+		return 0;
+	}
+	if (aScratchpad[5] != 0xFF || aScratchpad[7] != 0x10)				//Nadie ha respondido ( todo a 1 ) o el bus esta a 0
+	{
+		return 0;
+	}
+	*pTemperatura = make16 (aScratchpad[1], aScratchpad[0]);
+	if (aRom[0] == 0x10)													//El DS1820 da medios grados
+	{
+		*pTemperatura <<= 3;
+	}
+	return 1;
+}
+/**
+******************************************************
+* @brief Convierte y lee todos los sensores de temperatura del inventario
+*
+* Una sola conversion para todos los sensores, espera con slots de lectura y lectura consecutiva de cada
+* scratchpad. Leer N sensores cuesta una conversion mas N lecturas, en lugar de N conversiones.
+* Los dispositivos que no son sensores de temperatura y las bajas quedan con ONEWIRE_TEMP_ERROR
+*
+* @param pInventario Inventario actualizado con OneWire_InventarioActualiza()
+* @param aTemperaturas Array con una posicion por cada entrada del inventario
+* @return Numero de lecturas correctas
+*
+* Ejemplo:
+*
+*	OneWire_Inventario stInventario;
+*	int16 aTemperaturas[ONEWIRE_INVENTARIO_MAX];
+*	int8 nLecturas;
+*
+*	OneWire_InventarioInicia (&stInventario);
+*	OneWire_InventarioActualiza (&stInventario);
+*	nLecturas = OneWire_TempMuestrea (&stInventario, aTemperaturas);
+*
+* Resultado:
+*
+*	aTemperaturas[n] = temperatura del sensor stInventario.aRom[n]
+*
+* @see OneWire_TempConvierte(), OneWire_TempEsperaFin(), OneWire_TempLee()
+*/
+int8 OneWire_TempMuestrea (OneWire_Inventario* pInventario, int16* aTemperaturas)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nDispositivo, nLecturas, cFamilia;
+	//-------------------------------------------------------------
+
+	for (nDispositivo = 0; nDispositivo < pInventario->nDispositivos; nDispositivo++)
+	{
+		aTemperaturas[nDispositivo] = ONEWIRE_TEMP_ERROR;
+	}
+	if (!OneWire_TempConvierte () || !OneWire_TempEsperaFin ())
+	{
+		return 0;
+	}
+	nLecturas = 0;
+	for (nDispositivo = 0; nDispositivo < pInventario->nDispositivos; nDispositivo++)
+	{
+		cFamilia = pInventario->aRom[nDispositivo][0];
+		if ((pInventario->aEstado[nDispositivo] & ONEWIRE_INVENTARIO_BAJA) || (cFamilia != 0x28 && cFamilia != 0x22 && cFamilia != 0x10))
+		{
+			continue;
+		}
+		if (OneWire_TempLee (pInventario->aRom[nDispositivo], &aTemperaturas[nDispositivo]))
+		{
+			nLecturas++;
+		}
+	}
+	return nLecturas;
+}
@@ -0,0 +1,186 @@
+/**
+******************************************************
+* @file jsb_1wire_uart.c
+* @brief Bus 1Wire generado con la UART del PIC
+* @author Oscar Salas Mestres & Julian Salas Bartolome
+* @version 1.1
+* @date Agosto 2012
+*
+*
+*******************************************************/
+
+int32 OneWire_UartVelocidad = 0;											///< Velocidad actual de la UART
+
+/**
+******************************************************
+* @brief Prepara la UART para los slots de bit
+*
+* Debe llamarse una vez antes de usar el bus
+*/
+void OneWire_UartInicia (void)
+{
+	_OneWireUart_Inicia ();
+	OneWire_UartVelocidad = 0;
+	_OneWire_UartBaudios (ONEWIRE_UART_BAUDIOS_SLOT);
+}
+/**
+******************************************************
+* @brief Cambia la velocidad de la UART solo si es distinta de la actual
+*
+* Funcion interna.
+*/
+void _OneWire_UartBaudios (int32 nBaudios)
+{
+	if (OneWire_UartVelocidad != nBaudios)
+	{
+		_OneWireUart_Baudios (nBaudios);
+		OneWire_UartVelocidad = nBaudios;
+	}
+}
+/**
+******************************************************
+* @brief Pulso de reset generado con un byte a 9600 baudios
+*
+* @return 0 si algun dispositivo ha respondido, 1 en caso contrario ( igual que OneWire_Reset() )
+*
+* @see OneWire_Reset()
+*/
+int1 OneWire_UartReset (void)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 cEco;
+	//-------------------------------------------------------------
+
+	_OneWire_UartBaudios (ONEWIRE_UART_BAUDIOS_RESET);
+	_OneWireUart_Envia (ONEWIRE_UART_RESET);
+	cEco = _OneWireUart_Recibe ();
+	_OneWire_UartBaudios (ONEWIRE_UART_BAUDIOS_SLOT);
+	return cEco == ONEWIRE_UART_RESET;										//Sin pulso de presencia el eco es el mismo byte
+}
+/**
+******************************************************
+* @brief Envia una serie de slots y recoge su eco
+*
+* El siguiente byte se envia antes de leer el eco del anterior, la UART encadena los slots sin huecos.
+* En aSlots queda el eco de cada slot
+*
+* @param aSlots Un byte por slot, 0xFF para escribir un 1 o leer, 0x00 para escribir un 0
+* @param nSlots Numero de slots
+*/
+void OneWire_UartTransfiere (int8* aSlots, int8 nSlots)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 nSlot;
+	//-------------------------------------------------------------
+
+	if (nSlots == 0)
+	{
+		return;
+	}
+	_OneWireUart_Envia (aSlots[0]);
+	for (nSlot = 0; nSlot < nSlots; nSlot++)
+	{
+		if (nSlot+1 < nSlots)
+		{
+			_OneWireUart_Envia (aSlots[nSlot+1]);
+		}
+		aSlots[nSlot] = _OneWireUart_Recibe ();
+	}
+}
+/**
+******************************************************
+* @brief Envia hasta 8 bits empezando por el de menor peso y devuelve los bits leidos
+*
+* Para leer se envian unos. Es la base de OneWire_Write(), OneWire_LeeBit(), OneWire_SendByte() y
+* OneWire_ReceiveByte() cuando se define ONEWIRE_UART
+*
+* @param cDato Bits a enviar
+* @param nBits Numero de bits ( 1 a 8 )
+* @return Bits leidos del bus, en las mismas posiciones
+*
+* Ejemplo:
+*
+*	cDato = OneWire_UartBits (0xFF, 8);
+*
+* Resultado:
+*
+*	cDato = byte enviado por el esclavo
+*/
+int8 OneWire_UartBits (int8 cDato, int8 nBits)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 aSlots[8];
+	int8 nBit, cLeido;
+	//-------------------------------------------------------------
+
+	for (nBit = 0; nBit < nBits; nBit++)
+	{
+		aSlots[nBit] = bit_test (cDato, nBit) ? 0xFF : 0x00;
+	}
+	OneWire_UartTransfiere (aSlots, nBits);
+	cLeido = 0;
+	for (nBit = 0; nBit < nBits; nBit++)
+	{
+		if (aSlots[nBit] == 0xFF)
+		{
+			bit_set (cLeido, nBit);
+		}
+	}
+	return cLeido;
+}
+/**
+******************************************************
+* @brief Envia o recibe un bloque de bytes con transferencias de ONEWIRE_UART_BUFFER slots
+*
+* @param aDatos Bytes a enviar, o array donde se dejan los recibidos
+* @param nBytes Numero de bytes
+* @param lLectura 1 para recibir, 0 para enviar
+*
+* @see OneWire_WriteBlock(), OneWire_ReadBlock()
+*/
+void OneWire_UartBloque (int8* aDatos, int8 nBytes, int1 lLectura)
+{
+	//-------------------------------------------------------------
+	//Definicion de variables
+	//-------------------------------------------------------------
+	int8 aSlots[ONEWIRE_UART_BUFFER];
+	int8 nByte, nBytesTramo, nTramo, nBit;
+	//-------------------------------------------------------------
+
+	for (nByte = 0; nByte < nBytes; nByte += nBytesTramo)
+	{
+		nBytesTramo = nBytes - nByte;
+		if (nBytesTramo > ONEWIRE_UART_BUFFER/8)
+		{
+			nBytesTramo = ONEWIRE_UART_BUFFER/8;
+		}
+		for (nTramo = 0; nTramo < nBytesTramo; nTramo++)
+		{
+			for (nBit = 0; nBit < 8; nBit++)
+			{
+				aSlots[nTramo*8 + nBit] = (lLectura || bit_test (aDatos[nByte+nTramo], nBit)) ? 0xFF : 0x00;
+			}
+		}
+		OneWire_UartTransfiere (aSlots, nBytesTramo*8);
+		if (lLectura)
+		{
+			for (nTramo = 0; nTramo < nBytesTramo; nTramo++)
+			{
+				aDatos[nByte+nTramo] = 0;
+				for (nBit = 0; nBit < 8; nBit++)
+				{
+					if (aSlots[nTramo*8 + nBit] == 0xFF)
+					{
+						bit_set (aDatos[nByte+nTramo], nBit);
+					}
+				}
+			}
+		}
+	}
+}